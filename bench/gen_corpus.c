@@ -0,0 +1,570 @@
+#include <errno.h>
+#include <getopt.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/*
+ * Synthetic Ruby corpus generator for the benchmarks.
+ *
+ * Writes syntactically valid Ruby that looks like application code: nested
+ * modules and classes, methods with blocks, conditionals, multiline hashes
+ * and method chains, heredocs and rescue clauses. With a non-zero offense
+ * density, lines are also misindented, indented with tabs, given trailing
+ * whitespace or extra spaces, made too long, and whole files use CRLF line
+ * endings, so that Layout rules have work to do.
+ *
+ * The output depends only on the options: the same seed gives the same
+ * bytes on every platform.
+ */
+
+#define GEN_MAX_DEPTH 3
+
+/**
+ * @brief Generator state for one file.
+ */
+typedef struct gen_s
+{
+    uint64_t state;  /* PRNG state */
+    double density;  /* probability scale of injected offenses (0: clean code) */
+    FILE *out;       /* destination */
+    bool crlf;       /* the file uses CRLF line endings */
+    size_t lines;    /* lines written */
+    size_t target;   /* lines wanted */
+    unsigned serial; /* suffix keeping generated names unique */
+} gen_t;
+
+static const char *const gen_nouns[] = {
+    "user",    "order", "item",  "account", "payment", "invoice", "session", "token",  "record", "report",
+    "cache",   "queue", "event", "config",  "client",  "product", "address", "filter", "import", "export",
+    "request", "job",   "batch", "policy",  "message", "setting", "search",  "result", "entry",  "upload",
+};
+static const char *const gen_verbs[] = {
+    "find", "load", "build", "process", "validate", "normalize", "fetch", "render", "compute", "sync", "notify", "parse", "apply", "merge", "prepare",
+};
+static const char *const gen_classes[] = {
+    "Service", "Builder", "Repository", "Presenter", "Serializer", "Validator", "Importer", "Handler", "Policy", "Worker", "Form", "Query",
+};
+static const char *const gen_modules[] = {"Admin", "Api", "Billing", "Core", "Reports", "Accounts", "Integrations", "Storage", "Search", "Notifications"};
+
+#define GEN_COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+/* splitmix64 */
+static uint64_t gen_next(gen_t *g)
+{
+    uint64_t z = (g->state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+static unsigned gen_below(gen_t *g, unsigned n)
+{
+    return (unsigned)(gen_next(g) % n);
+}
+
+static bool gen_chance(gen_t *g, double p)
+{
+    return (double)(gen_next(g) >> 11) * (1.0 / 9007199254740992.0) < p;
+}
+
+/* Offense injection: probability scaled by the density */
+static bool gen_offense(gen_t *g, double weight)
+{
+    return g->density > 0 && gen_chance(g, g->density * weight);
+}
+
+static const char *gen_noun(gen_t *g)
+{
+    return gen_nouns[gen_below(g, GEN_COUNT(gen_nouns))];
+}
+
+static const char *gen_verb(gen_t *g)
+{
+    return gen_verbs[gen_below(g, GEN_COUNT(gen_verbs))];
+}
+
+/* Binary operator, `x + y` or (as an offense) `x+y` */
+static const char *gen_op(gen_t *g, const char *op, char *buf, size_t size)
+{
+    snprintf(buf, size, gen_offense(g, 0.3) ? "%s" : " %s ", op);
+    return buf;
+}
+
+static void gen_newline(gen_t *g)
+{
+    fputs(g->crlf ? "\r\n" : "\n", g->out);
+    g->lines++;
+}
+
+/**
+ * @brief Write one line of code at an indentation level.
+ * @note Injects indentation, tab and trailing whitespace offenses.
+ */
+static void gen_line(gen_t *g, int indent, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+static void gen_line(gen_t *g, int indent, const char *fmt, ...)
+{
+    int width = indent * 2;
+    if (width > 0 && gen_offense(g, 0.4))
+    {
+        width += gen_chance(g, 0.5) ? 1 : -1;
+    }
+    if (indent > 0 && gen_offense(g, 0.1))
+    {
+        for (int i = 0; i < indent; ++i)
+        {
+            fputc('\t', g->out);
+        }
+    }
+    else
+    {
+        fprintf(g->out, "%*s", width, "");
+    }
+    va_list ap;
+    va_start(ap, fmt);
+    vfprintf(g->out, fmt, ap);
+    va_end(ap);
+    if (gen_offense(g, 0.3))
+    {
+        fputs(gen_chance(g, 0.7) ? " " : " \t ", g->out);
+    }
+    gen_newline(g);
+}
+
+static void gen_blank(gen_t *g)
+{
+    if (gen_offense(g, 0.1))
+    {
+        fputs("  ", g->out);
+    }
+    gen_newline(g);
+}
+
+/* Right-hand side of an assignment */
+static void gen_expression(gen_t *g, char *buf, size_t size)
+{
+    char op[8];
+    switch (gen_below(g, 7))
+    {
+    case 0:
+        snprintf(buf, size, "%u", gen_below(g, 1000));
+        break;
+    case 1:
+        snprintf(buf, size, "\"%s #{%s.id}\"", gen_noun(g), gen_noun(g));
+        break;
+    case 2:
+        snprintf(buf, size, "%s_%s(%s, %s)", gen_verb(g), gen_noun(g), gen_noun(g), gen_offense(g, 0.3) ? "limit:10" : "limit: 10");
+        break;
+    case 3:
+        snprintf(buf, size, "%s.%s%s%u", gen_noun(g), "count", gen_op(g, "*", op, sizeof(op)), gen_below(g, 10) + 1);
+        break;
+    case 4:
+        snprintf(buf, size, gen_offense(g, 0.3) ? "[%s,%s, :%s]" : "[%s, %s, :%s]", gen_noun(g), gen_noun(g), gen_noun(g));
+        break;
+    case 5:
+        snprintf(buf, size, "%s&.%s || default_%s", gen_noun(g), gen_noun(g), gen_noun(g));
+        break;
+    default:
+        snprintf(buf, size, "%s.%s { |x| x.%s }", gen_noun(g), gen_chance(g, 0.5) ? "map" : "select", gen_noun(g));
+        break;
+    }
+}
+
+static void gen_statements(gen_t *g, int indent, int depth, unsigned count);
+
+static void gen_assignment(gen_t *g, int indent)
+{
+    char rhs[160];
+    char op[8];
+    gen_expression(g, rhs, sizeof(rhs));
+    gen_line(g, indent, "%s%s%s", gen_noun(g), gen_op(g, "=", op, sizeof(op)), rhs);
+}
+
+static void gen_chain(gen_t *g, int indent)
+{
+    gen_line(g, indent, "%ss = %s.where(active: true)", gen_noun(g), gen_noun(g));
+    unsigned n = 2 + gen_below(g, 3);
+    for (unsigned i = 0; i < n; ++i)
+    {
+        static const char *const calls[] = {".order(:created_at)", ".includes(:owner)", ".limit(per_page)", ".reject(&:blank?)", ".group_by(&:kind)"};
+        gen_line(g, indent + 1 + (gen_offense(g, 0.3) ? 1 : 0), "%s", calls[gen_below(g, GEN_COUNT(calls))]);
+    }
+}
+
+static void gen_hash(gen_t *g, int indent)
+{
+    gen_line(g, indent, "%s_options = {", gen_noun(g));
+    unsigned n = 2 + gen_below(g, 4);
+    unsigned first = gen_below(g, GEN_COUNT(gen_nouns));
+    for (unsigned i = 0; i < n; ++i)
+    {
+        const char *key = gen_nouns[(first + i) % GEN_COUNT(gen_nouns)];
+        if (gen_chance(g, 0.2))
+        {
+            gen_line(g, indent + 1, "\"%s\"%s=> %s_%u,", key, gen_offense(g, 0.4) ? "   " : " ", key, i);
+        }
+        else
+        {
+            gen_line(g, indent + 1, "%s:%s%s_%u,", key, gen_offense(g, 0.4) ? "    " : " ", key, i);
+        }
+    }
+    gen_line(g, indent, "}");
+}
+
+static void gen_block(gen_t *g, int indent, int depth)
+{
+    const char *noun = gen_noun(g);
+    gen_line(g, indent, "%ss.%s do |%s|", noun, gen_chance(g, 0.7) ? "each" : "each_with_index", noun);
+    gen_statements(g, indent + 1, depth + 1, 1 + gen_below(g, 3));
+    gen_line(g, indent, "end");
+}
+
+static void gen_conditional(gen_t *g, int indent, int depth)
+{
+    char op[8];
+    gen_line(g, indent, "if %s.%s?%s", gen_noun(g), gen_chance(g, 0.5) ? "valid" : "present", gen_chance(g, 0.3) ? " && !skip" : "");
+    gen_statements(g, indent + 1, depth + 1, 1 + gen_below(g, 2));
+    if (gen_chance(g, 0.4))
+    {
+        gen_line(g, indent, "elsif retries%s%u", gen_op(g, ">", op, sizeof(op)), gen_below(g, 5));
+        gen_statements(g, indent + 1, depth + 1, 1);
+    }
+    if (gen_chance(g, 0.6))
+    {
+        gen_line(g, indent, "else");
+        gen_statements(g, indent + 1, depth + 1, 1 + gen_below(g, 2));
+    }
+    gen_line(g, indent, "end");
+}
+
+static void gen_case(gen_t *g, int indent, int depth)
+{
+    gen_line(g, indent, "case %s.status", gen_noun(g));
+    unsigned n = 2 + gen_below(g, 3);
+    for (unsigned i = 0; i < n; ++i)
+    {
+        gen_line(g, indent, "when :%s", gen_noun(g));
+        gen_statements(g, indent + 1, depth + 1, 1);
+    }
+    gen_line(g, indent, "end");
+}
+
+static void gen_heredoc(gen_t *g, int indent)
+{
+    static const char *const tags[] = {"SQL", "EOS", "TEXT", "MSG"};
+    const char *tag = tags[gen_below(g, GEN_COUNT(tags))];
+    gen_line(g, indent, "%s = <<~%s", gen_chance(g, 0.5) ? "query" : "body", tag);
+    unsigned n = 2 + gen_below(g, 4);
+    for (unsigned i = 0; i < n; ++i)
+    {
+        gen_line(g, indent + 1, "%s %s #{%s.id}", gen_chance(g, 0.5) ? "SELECT * FROM" : "Dear", gen_noun(g), gen_noun(g));
+    }
+    /* trailing whitespace would keep the terminator from ending the heredoc */
+    fprintf(g->out, "%*s%s", indent * 2, "", tag);
+    gen_newline(g);
+}
+
+static void gen_rescue(gen_t *g, int indent, int depth)
+{
+    gen_line(g, indent, "begin");
+    gen_statements(g, indent + 1, depth + 1, 1 + gen_below(g, 2));
+    gen_line(g, indent, "rescue %s => e", gen_chance(g, 0.5) ? "StandardError" : "ArgumentError, KeyError");
+    gen_line(g, indent + 1, "logger.warn(\"%s failed: #{e.message}\")", gen_verb(g));
+    if (gen_chance(g, 0.3))
+    {
+        gen_line(g, indent, "ensure");
+        gen_line(g, indent + 1, "%s.close", gen_noun(g));
+    }
+    gen_line(g, indent, "end");
+}
+
+static void gen_long_line(gen_t *g, int indent)
+{
+    char buf[512];
+    size_t len = 0;
+    unsigned first = gen_below(g, GEN_COUNT(gen_nouns));
+    len += (size_t)snprintf(buf, sizeof(buf), "%s_%s(", gen_verb(g), gen_noun(g));
+    for (unsigned i = 0; len < 130; ++i)
+    {
+        len += (size_t)snprintf(buf + len, sizeof(buf) - len, "%s%s: %s.%s", i ? ", " : "", gen_nouns[(first + i) % GEN_COUNT(gen_nouns)], gen_noun(g), gen_noun(g));
+    }
+    snprintf(buf + len, sizeof(buf) - len, ")");
+    gen_line(g, indent, "%s", buf);
+}
+
+static void gen_comment(gen_t *g, int indent)
+{
+    static const char *const texts[] = {"TODO: remove once the backfill is done", "Keep in sync with the API docs", "NOTE: called from the nightly job",
+                                        "Returns nil when nothing matches"};
+    gen_line(g, indent, gen_offense(g, 0.3) ? "#%s" : "# %s", texts[gen_below(g, GEN_COUNT(texts))]);
+}
+
+/* `count` statements of a method body or nested block */
+static void gen_statements(gen_t *g, int indent, int depth, unsigned count)
+{
+    for (unsigned i = 0; i < count; ++i)
+    {
+        unsigned kind = depth >= GEN_MAX_DEPTH ? gen_below(g, 3) : gen_below(g, 12);
+        if (gen_offense(g, 0.15))
+        {
+            gen_long_line(g, indent);
+            continue;
+        }
+        switch (kind)
+        {
+        case 0:
+        case 1:
+            gen_assignment(g, indent);
+            break;
+        case 2:
+            gen_line(g, indent, "return %s unless %s", gen_chance(g, 0.5) ? "nil" : "[]", gen_noun(g));
+            break;
+        case 3:
+            gen_chain(g, indent);
+            break;
+        case 4:
+            gen_hash(g, indent);
+            break;
+        case 5:
+            gen_block(g, indent, depth);
+            break;
+        case 6:
+            gen_conditional(g, indent, depth);
+            break;
+        case 7:
+            gen_case(g, indent, depth);
+            break;
+        case 8:
+            gen_heredoc(g, indent);
+            break;
+        case 9:
+            gen_rescue(g, indent, depth);
+            break;
+        case 10:
+            gen_comment(g, indent);
+            gen_assignment(g, indent);
+            break;
+        default:
+            gen_line(g, indent, "%s.%s(%s)", gen_noun(g), gen_verb(g), gen_offense(g, 0.3) ? " *args " : "*args");
+            break;
+        }
+    }
+}
+
+static void gen_method(gen_t *g, int indent)
+{
+    const char *verb = gen_verb(g);
+    const char *noun = gen_noun(g);
+    switch (gen_below(g, 3))
+    {
+    case 0:
+        gen_line(g, indent, "def %s_%s", verb, noun);
+        break;
+    case 1:
+        gen_line(g, indent, "def %s_%s(%s, options = {})", verb, noun, noun);
+        break;
+    default:
+        gen_line(g, indent, "def %s_%s(%s:, force: false)", verb, noun, noun);
+        break;
+    }
+    gen_statements(g, indent + 1, 1, 1 + gen_below(g, 5));
+    gen_line(g, indent, "end");
+}
+
+static void gen_class(gen_t *g, int indent, int depth)
+{
+    const char *base = gen_classes[gen_below(g, GEN_COUNT(gen_classes))];
+    const char *noun = gen_noun(g);
+    char name[64];
+    snprintf(name, sizeof(name), "%c%s%s%u", noun[0] - 'a' + 'A', noun + 1, base, g->serial++);
+    if (gen_chance(g, 0.5))
+    {
+        gen_line(g, indent, "class %s < Base%s", name, base);
+    }
+    else
+    {
+        gen_line(g, indent, "class %s", name);
+    }
+    gen_line(g, indent + 1, "include %s", gen_chance(g, 0.5) ? "Comparable" : "Enumerable");
+    gen_line(g, indent + 1, "DEFAULT_%s = %u", gen_chance(g, 0.5) ? "LIMIT" : "TIMEOUT", 10 + gen_below(g, 90));
+    gen_line(g, indent + 1, "attr_reader :%s, :%s", gen_noun(g), gen_noun(g));
+    gen_blank(g);
+    unsigned methods = 2 + gen_below(g, 6);
+    for (unsigned i = 0; i < methods && g->lines < g->target; ++i)
+    {
+        if (i > 0)
+        {
+            gen_blank(g);
+        }
+        if (i == methods / 2 + 1)
+        {
+            gen_line(g, indent + 1, "private");
+            gen_blank(g);
+        }
+        gen_method(g, indent + 1);
+    }
+    if (depth < GEN_MAX_DEPTH && gen_chance(g, 0.2) && g->lines < g->target)
+    {
+        gen_blank(g);
+        gen_class(g, indent + 1, depth + 1);
+    }
+    gen_line(g, indent, "end");
+}
+
+static void gen_module(gen_t *g, int indent, int depth)
+{
+    gen_line(g, indent, "module %s", gen_modules[gen_below(g, GEN_COUNT(gen_modules))]);
+    unsigned n = 1 + gen_below(g, 3);
+    for (unsigned i = 0; i < n && g->lines < g->target; ++i)
+    {
+        if (i > 0)
+        {
+            gen_blank(g);
+        }
+        if (depth < GEN_MAX_DEPTH && gen_chance(g, 0.3))
+        {
+            gen_module(g, indent + 1, depth + 1);
+        }
+        else
+        {
+            gen_class(g, indent + 1, depth + 1);
+        }
+    }
+    gen_line(g, indent, "end");
+}
+
+/**
+ * @brief Write one file of about `lines` lines.
+ */
+static void gen_file(FILE *out, uint64_t seed, size_t lines, double density)
+{
+    gen_t g = {.state = seed, .density = density, .out = out, .lines = 0, .target = lines, .serial = 0};
+    g.crlf = gen_offense(&g, 0.2);
+    if (gen_chance(&g, 0.8))
+    {
+        gen_line(&g, 0, "# frozen_string_literal: true");
+        gen_blank(&g);
+    }
+    bool first = true;
+    while (g.lines < g.target)
+    {
+        if (!first)
+        {
+            gen_blank(&g);
+        }
+        first = false;
+        if (gen_chance(&g, 0.6))
+        {
+            gen_module(&g, 0, 0);
+        }
+        else
+        {
+            gen_class(&g, 0, 0);
+        }
+    }
+}
+
+static void gen_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -s, --seed N        PRNG seed (default 1)\n"
+            "  -l, --lines N       lines per file (default 2000)\n"
+            "  -n, --files N       number of files (default 1)\n"
+            "  -d, --density X     offense density from 0 (clean) to 1 (default 0.1)\n"
+            "  -o, --output PATH   file (one file) or directory to write to (default stdout)\n"
+            "Files of a directory are named gen_<index>.rb; file i uses seed + i.\n",
+            prog);
+}
+
+int main(int argc, char *argv[])
+{
+    uint64_t seed = 1;
+    size_t lines = 2000;
+    size_t files = 1;
+    double density = 0.1;
+    const char *output = NULL;
+    static const struct option long_options[] = {
+        {"seed", required_argument, NULL, 's'},   {"lines", required_argument, NULL, 'l'}, {"files", required_argument, NULL, 'n'},
+        {"density", required_argument, NULL, 'd'}, {"output", required_argument, NULL, 'o'}, {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+    int c;
+    while ((c = getopt_long(argc, argv, "s:l:n:d:o:h", long_options, NULL)) != -1)
+    {
+        switch (c)
+        {
+        case 's':
+            seed = strtoull(optarg, NULL, 10);
+            break;
+        case 'l':
+            lines = strtoul(optarg, NULL, 10);
+            break;
+        case 'n':
+            files = strtoul(optarg, NULL, 10);
+            break;
+        case 'd':
+            density = strtod(optarg, NULL);
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        case 'h':
+            gen_usage(argv[0]);
+            return 0;
+        default:
+            gen_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (density < 0 || density > 1 || files == 0)
+    {
+        fprintf(stderr, "gen_corpus: density must be within [0, 1] and files at least 1\n");
+        return 2;
+    }
+
+    if (files == 1)
+    {
+        FILE *out = output ? fopen(output, "wb") : stdout;
+        if (!out)
+        {
+            perror(output);
+            return 1;
+        }
+        gen_file(out, seed, lines, density);
+        return (output ? fclose(out) : fflush(out)) == 0 ? 0 : 1;
+    }
+
+    if (!output)
+    {
+        fprintf(stderr, "gen_corpus: --output DIR is required with several files\n");
+        return 2;
+    }
+    if (mkdir(output, 0755) != 0 && errno != EEXIST)
+    {
+        perror(output);
+        return 1;
+    }
+    for (size_t i = 0; i < files; ++i)
+    {
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/gen_%zu.rb", output, i);
+        FILE *out = fopen(path, "wb");
+        if (!out)
+        {
+            perror(path);
+            return 1;
+        }
+        gen_file(out, seed + i, lines, density);
+        if (fclose(out) != 0)
+        {
+            perror(path);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,1374 @@
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "prism.h"
+#include "cli/formatter.h"
+#include "engine/runner.h"
+#include "engine/trace.h"
+#include "output/json_escape.h"
+#include "output/output_buffer.h"
+#include "output/output_writer.h"
+#include "rules/rule.h"
+#include "utils/allocator/prism_xallocator.h"
+#include "utils/clock.h"
+#include "utils/file.h"
+#include "utils/string_array.h"
+#include "perf_counters.h"
+
+/*
+ * Per-stage benchmark of the lint pipeline.
+ *
+ * Each corpus (a file or a directory of .rb files) is linted `warmup` times
+ * unmeasured, then `repeat` times with every stage timed separately. The
+ * stages are the ones the engine runs for a file, in the same order, but
+ * without the autocorrect loop or the signature scan, so that every rule
+ * group is always measured. A sample is the time a stage took over the
+ * whole corpus in one repetition; percentiles are taken over repetitions.
+ * With --counters, hardware counters are read at the same points and their
+ * per-stage deltas reported as means over repetitions.
+ *
+ * With --memory, each corpus is linted once and its memory use reported
+ * instead, optionally checked against a baseline file of
+ * `<corpus> <metric> <value>` lines (see --write-baseline).
+ *
+ * With --scaling, each corpus is linted through the runner, as the
+ * command line does, at several thread counts; the report gives throughput,
+ * parallel efficiency and per-file latency.
+ */
+
+#ifndef LEUKO_BENCH_DIR
+#define LEUKO_BENCH_DIR "bench"
+#endif
+
+/**
+ * @brief Maximum number of thread counts of a scaling run.
+ */
+#define LEUKO_BENCH_MAX_THREAD_COUNTS 16
+
+/**
+ * @brief Pipeline stages timed by the benchmark.
+ */
+typedef enum leuko_bench_stage_e
+{
+    LEUKO_BENCH_STAGE_READ,             /* file read */
+    LEUKO_BENCH_STAGE_PARSE,            /* Prism parse */
+    LEUKO_BENCH_STAGE_PROCESSED_SOURCE, /* line table */
+    LEUKO_BENCH_STAGE_RULES_BYTES,      /* byte input rules */
+    LEUKO_BENCH_STAGE_RULES_LINES,      /* line input rules */
+    LEUKO_BENCH_STAGE_RULES_TOKENS,     /* lexer and token input rules */
+    LEUKO_BENCH_STAGE_RULES_AST,        /* AST walk and AST input rules */
+    LEUKO_BENCH_STAGE_FORMAT,           /* formatter */
+    LEUKO_BENCH_STAGE_TOTAL,            /* sum of the stages above */
+    LEUKO_BENCH_STAGE_COUNT,
+} leuko_bench_stage_t;
+
+static const char *const leuko_bench_stage_names[LEUKO_BENCH_STAGE_COUNT] = {
+    "read", "parse", "processed_source", "rules_bytes", "rules_lines", "rules_tokens", "rules_ast", "format", "total",
+};
+
+/**
+ * @brief Memory figures of a corpus, checked against the baseline.
+ */
+typedef enum leuko_bench_metric_e
+{
+    LEUKO_BENCH_METRIC_PEAK_ARENA_BYTES, /* largest Prism arena use of a file */
+    LEUKO_BENCH_METRIC_FALLBACK_ALLOCS,  /* Prism allocations served by malloc */
+    LEUKO_BENCH_METRIC_FALLBACK_BYTES,   /* bytes of those */
+    LEUKO_BENCH_METRIC_RSS_PEAK_KB,      /* process peak RSS after the corpus */
+    LEUKO_BENCH_METRIC_COUNT,
+} leuko_bench_metric_t;
+
+static const char *const leuko_bench_metric_names[LEUKO_BENCH_METRIC_COUNT] = {
+    "peak_arena_bytes",
+    "fallback_allocs",
+    "fallback_bytes",
+    "rss_peak_kb",
+};
+
+/**
+ * @brief Rules by the input they need.
+ */
+typedef struct leuko_bench_rules_s
+{
+    const leuko_rule_t *groups[LEUKO_RULE_INPUT_AST + 1][LEUKO_RULE_ID_COUNT];
+    size_t counts[LEUKO_RULE_INPUT_AST + 1];
+    bool subscribed[LEUKO_RULE_ID_COUNT][256]; /* AST rule i is called for nodes of the type */
+} leuko_bench_rules_t;
+
+/**
+ * @brief A set of files measured together.
+ */
+typedef struct leuko_bench_corpus_s
+{
+    char *name;                                /* name in the report (last path component) */
+    char **files;                              /* files of the corpus */
+    size_t count;                              /* number of files */
+    size_t bytes;                              /* total size */
+    size_t lines;                              /* total number of lines */
+    size_t offenses;                           /* offenses found by one repetition */
+    uint64_t memory[LEUKO_BENCH_METRIC_COUNT]; /* memory use of the last repetition */
+} leuko_bench_corpus_t;
+
+/**
+ * @brief One value of a memory baseline.
+ */
+typedef struct leuko_bench_baseline_entry_s
+{
+    char corpus[256];
+    leuko_bench_metric_t metric;
+    uint64_t value;
+} leuko_bench_baseline_entry_t;
+
+/**
+ * @brief Memory baseline read from a file.
+ */
+typedef struct leuko_bench_baseline_s
+{
+    leuko_bench_baseline_entry_t *entries;
+    size_t count;
+} leuko_bench_baseline_t;
+
+/**
+ * @brief Benchmark settings.
+ */
+typedef struct leuko_bench_options_s
+{
+    size_t warmup;                                 /* unmeasured repetitions */
+    size_t repeat;                                 /* measured repetitions */
+    leuko_cli_formatter_t formatter;               /* formatter timed by the format stage */
+    bool json;                                     /* JSON report (otherwise a table) */
+    bool memory;                                   /* report memory use instead of times */
+    unsigned margin;                               /* tolerated growth over the baseline (%) */
+    const leuko_bench_baseline_t *baseline;        /* memory baseline (NULL: none) */
+    bool scaling;                                  /* report thread scaling instead of stage times */
+    size_t threads[LEUKO_BENCH_MAX_THREAD_COUNTS]; /* thread counts of a scaling run */
+    size_t thread_count;                           /* number of thread counts */
+    const leuko_perf_t *perf;                      /* hardware counters read per stage (NULL: none) */
+} leuko_bench_options_t;
+
+/**
+ * @brief Time and hardware counters of each stage over one pass.
+ */
+typedef struct leuko_bench_meter_s
+{
+    uint64_t ns[LEUKO_BENCH_STAGE_COUNT];                                 /* time per stage */
+    uint64_t counters[LEUKO_BENCH_STAGE_COUNT][LEUKO_PERF_COUNTER_COUNT]; /* counter deltas per stage */
+    const leuko_perf_t *perf;                                             /* counters to read (NULL: time only) */
+    uint64_t last_ns;                                                     /* clock at the previous mark */
+    uint64_t last[LEUKO_PERF_COUNTER_COUNT];                              /* counters at the previous mark */
+} leuko_bench_meter_t;
+
+/**
+ * @brief State of one runner pass over a corpus.
+ */
+typedef struct leuko_bench_pass_s
+{
+    leuko_cli_report_t report; /* formatter the results go through */
+    size_t lines;              /* lines linted (updated by the workers) */
+} leuko_bench_pass_t;
+
+/**
+ * @brief State while running the rules of one file.
+ */
+typedef struct leuko_bench_file_s
+{
+    const leuko_bench_rules_t *rules;
+    leuko_rule_context_t ctx;
+} leuko_bench_file_t;
+
+/**
+ * @brief Lexer callback: run the token input rules on a token.
+ */
+static void leuko_bench_visit_token(const leuko_token_t *token, void *data)
+{
+    leuko_bench_file_t *file = data;
+    const leuko_bench_rules_t *rules = file->rules;
+    for (size_t i = 0; i < rules->counts[LEUKO_RULE_INPUT_TOKENS]; ++i)
+    {
+        const leuko_rule_t *rule = rules->groups[LEUKO_RULE_INPUT_TOKENS][i];
+        rule->check_token(rule, &file->ctx, token);
+    }
+}
+
+/**
+ * @brief Prism visitor: run the AST input rules subscribed to a node's type.
+ */
+static bool leuko_bench_visit_node(const pm_node_t *node, void *data)
+{
+    leuko_bench_file_t *file = data;
+    const leuko_bench_rules_t *rules = file->rules;
+    pm_node_type_t type = PM_NODE_TYPE(node);
+    for (size_t i = 0; i < rules->counts[LEUKO_RULE_INPUT_AST] && type < 256; ++i)
+    {
+        if (rules->subscribed[i][type])
+        {
+            const leuko_rule_t *rule = rules->groups[LEUKO_RULE_INPUT_AST][i];
+            rule->check_node(rule, &file->ctx, node);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Start measuring from now.
+ */
+static void leuko_bench_meter_start(leuko_bench_meter_t *meter)
+{
+    if (meter->perf)
+    {
+        leuko_perf_read(meter->perf, meter->last);
+    }
+    meter->last_ns = leuko_clock_ns();
+}
+
+/**
+ * @brief Charge the time and counters since the previous mark to a stage.
+ * @note Reading the counters is a system call; it is kept out of the times
+ *       but its user-space part lands in the counters of the next stage.
+ */
+static void leuko_bench_meter_mark(leuko_bench_meter_t *meter, leuko_bench_stage_t stage)
+{
+    meter->ns[stage] += leuko_clock_ns() - meter->last_ns;
+    if (meter->perf)
+    {
+        uint64_t now[LEUKO_PERF_COUNTER_COUNT];
+        leuko_perf_read(meter->perf, now);
+        for (size_t i = 0; i < LEUKO_PERF_COUNTER_COUNT; ++i)
+        {
+            meter->counters[stage][i] += now[i] - meter->last[i];
+            meter->last[i] = now[i];
+        }
+    }
+    meter->last_ns = leuko_clock_ns();
+}
+
+/**
+ * @brief Split the implemented rules by input.
+ * @param out Rule groups
+ */
+static void leuko_bench_rules_init(leuko_bench_rules_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    size_t count = 0;
+    const leuko_rule_t *const *all = leuko_rules_all(&count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const leuko_rule_info_t *info = leuko_rule_info(all[i]->id);
+        size_t index = out->counts[info->input]++;
+        out->groups[info->input][index] = all[i];
+        if (info->input != LEUKO_RULE_INPUT_AST)
+        {
+            continue;
+        }
+        for (size_t t = 0; t < 256; ++t)
+        {
+            out->subscribed[index][t] = info->node_type_count == 0;
+        }
+        for (size_t n = 0; n < info->node_type_count; ++n)
+        {
+            if (info->node_types[n] < 256)
+            {
+                out->subscribed[index][info->node_types[n]] = true;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Lint one file, adding the time and counters of each stage to `meter`.
+ * @param rules Rule groups
+ * @param report Report the formatter writes to
+ * @param path File path
+ * @param file_index Index of the file in its corpus
+ * @param diagnostics Diagnostic buffer (reused between files)
+ * @param meter Per-stage measurements
+ * @param lines Output: number of lines of the file
+ * @param alloc Output: Prism allocations of the file
+ * @return false if the file could not be read
+ */
+static bool leuko_bench_file(const leuko_bench_rules_t *rules, leuko_cli_report_t *report, const char *path, size_t file_index, leuko_diagnostic_buffer_t *diagnostics,
+                             leuko_bench_meter_t *meter, size_t *lines, leuko_x_allocator_stats_t *alloc)
+{
+    leuko_bench_meter_start(meter);
+    uint8_t *source = NULL;
+    size_t source_len = 0;
+    if (!leuko_file_read_all(path, &source, &source_len))
+    {
+        fprintf(stderr, "%s: could not read file\n", path);
+        return false;
+    }
+    leuko_bench_meter_mark(meter, LEUKO_BENCH_STAGE_READ);
+
+    pm_parser_t parser;
+    leuko_x_allocator_begin();
+    pm_parser_init(&parser, source, source_len, NULL);
+    pm_node_t *root = pm_parse(&parser);
+    leuko_bench_meter_mark(meter, LEUKO_BENCH_STAGE_PARSE);
+
+    leuko_processed_source_t ps;
+    leuko_processed_source_init_from_parser(&ps, &parser);
+    leuko_bench_meter_mark(meter, LEUKO_BENCH_STAGE_PROCESSED_SOURCE);
+    *lines = ps.line_count;
+
+    leuko_diagnostic_buffer_clear(diagnostics);
+    leuko_bench_file_t file = {
+        .rules = rules,
+        .ctx =
+            {
+                .ps = &ps,
+                .parser = &parser,
+                .diagnostics = diagnostics,
+                .edits = NULL,
+                .fix_mode = LEUKO_FIX_MODE_NONE,
+                .line_begin = 0,
+                .line_end = ps.line_count,
+            },
+    };
+    /* same order as the engine: the lexer run fills the line flags */
+    if (rules->counts[LEUKO_RULE_INPUT_TOKENS] > 0)
+    {
+        uint8_t *flags = !ps.line_flags && ps.line_count > 0 ? malloc(ps.line_count) : NULL;
+        leuko_lex(source, source_len, ps.line_count, flags, leuko_bench_visit_token, &file);
+        if (flags)
+        {
+            ps.line_flags = flags;
+        }
+    }
+    leuko_bench_meter_mark(meter, LEUKO_BENCH_STAGE_RULES_TOKENS);
+    for (size_t i = 0; i < rules->counts[LEUKO_RULE_INPUT_BYTES]; ++i)
+    {
+        rules->groups[LEUKO_RULE_INPUT_BYTES][i]->check_source(rules->groups[LEUKO_RULE_INPUT_BYTES][i], &file.ctx);
+    }
+    leuko_bench_meter_mark(meter, LEUKO_BENCH_STAGE_RULES_BYTES);
+    for (size_t i = 0; i < rules->counts[LEUKO_RULE_INPUT_LINES]; ++i)
+    {
+        rules->groups[LEUKO_RULE_INPUT_LINES][i]->check_source(rules->groups[LEUKO_RULE_INPUT_LINES][i], &file.ctx);
+    }
+    leuko_bench_meter_mark(meter, LEUKO_BENCH_STAGE_RULES_LINES);
+    if (rules->counts[LEUKO_RULE_INPUT_AST] > 0)
+    {
+        pm_visit_node(root, leuko_bench_visit_node, &file);
+    }
+    leuko_bench_meter_mark(meter, LEUKO_BENCH_STAGE_RULES_AST);
+
+    leuko_lint_result_t result = {
+        .path = path,
+        .file_index = file_index,
+        .worker_index = 0,
+        .ps = &ps,
+        .diagnostics = diagnostics,
+        .original = source,
+        .original_len = source_len,
+        .changes = NULL,
+    };
+    leuko_cli_report_on_result(&result, report);
+    leuko_cli_report_on_file_done(file_index, 0, report);
+    leuko_bench_meter_mark(meter, LEUKO_BENCH_STAGE_FORMAT);
+
+    leuko_processed_source_free(&ps);
+    pm_node_destroy(&parser, root);
+    pm_parser_free(&parser);
+    leuko_x_allocator_stats(alloc);
+    leuko_x_allocator_end();
+    free(source);
+    return true;
+}
+
+/**
+ * @brief Lint every file of a corpus once.
+ * @param rules Rule groups
+ * @param opts Benchmark settings
+ * @param corpus Corpus (its line and offense counts and memory use are updated)
+ * @param sink Descriptor the formatter writes to
+ * @param meter Output: per-stage measurements over the corpus
+ * @return false on failure
+ */
+static bool leuko_bench_run_corpus(const leuko_bench_rules_t *rules, const leuko_bench_options_t *opts, leuko_bench_corpus_t *corpus, int sink,
+                                   leuko_bench_meter_t *meter)
+{
+    memset(meter, 0, sizeof(*meter));
+    meter->perf = opts->perf;
+    leuko_cli_report_t report;
+    leuko_bench_meter_start(meter);
+    if (!leuko_cli_report_begin(&report, opts->formatter, corpus->files, corpus->count, 1, sink))
+    {
+        fprintf(stderr, "leuko_bench: could not start the formatter\n");
+        return false;
+    }
+    leuko_bench_meter_mark(meter, LEUKO_BENCH_STAGE_FORMAT);
+
+    leuko_diagnostic_buffer_t diagnostics;
+    leuko_diagnostic_buffer_init(&diagnostics);
+    bool ok = true;
+    size_t lines = 0;
+    size_t offenses = 0;
+    memset(corpus->memory, 0, sizeof(corpus->memory));
+    for (size_t i = 0; i < corpus->count && ok; ++i)
+    {
+        size_t file_lines = 0;
+        leuko_x_allocator_stats_t alloc = {0};
+        ok = leuko_bench_file(rules, &report, corpus->files[i], i, &diagnostics, meter, &file_lines, &alloc);
+        lines += file_lines;
+        offenses += diagnostics.count;
+        if (alloc.arena_bytes > corpus->memory[LEUKO_BENCH_METRIC_PEAK_ARENA_BYTES])
+        {
+            corpus->memory[LEUKO_BENCH_METRIC_PEAK_ARENA_BYTES] = alloc.arena_bytes;
+        }
+        corpus->memory[LEUKO_BENCH_METRIC_FALLBACK_ALLOCS] += alloc.fallback_allocs;
+        corpus->memory[LEUKO_BENCH_METRIC_FALLBACK_BYTES] += alloc.fallback_bytes;
+    }
+    leuko_diagnostic_buffer_free(&diagnostics);
+
+    leuko_bench_meter_start(meter);
+    ok = leuko_cli_report_end(&report) && ok;
+    leuko_bench_meter_mark(meter, LEUKO_BENCH_STAGE_FORMAT);
+    for (size_t s = 0; s < LEUKO_BENCH_STAGE_TOTAL; ++s)
+    {
+        meter->ns[LEUKO_BENCH_STAGE_TOTAL] += meter->ns[s];
+        for (size_t i = 0; i < LEUKO_PERF_COUNTER_COUNT; ++i)
+        {
+            meter->counters[LEUKO_BENCH_STAGE_TOTAL][i] += meter->counters[s][i];
+        }
+    }
+    corpus->lines = lines;
+    corpus->offenses = offenses;
+    return ok;
+}
+
+static int leuko_bench_compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+/**
+ * @brief Nearest-rank percentile of sorted samples.
+ */
+static uint64_t leuko_bench_percentile(const uint64_t *sorted, size_t count, unsigned percent)
+{
+    size_t rank = (count * percent + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+/**
+ * @brief Append the statistics of one stage.
+ * @param out Report
+ * @param name Stage name
+ * @param samples Samples of the stage (sorted in place)
+ * @param count Number of samples
+ * @param json JSON object member, left open (otherwise a table row)
+ * @return false on allocation failure
+ */
+static bool leuko_bench_append_stage(leuko_output_buffer_t *out, const char *name, uint64_t *samples, size_t count, bool json)
+{
+    qsort(samples, count, sizeof(samples[0]), leuko_bench_compare_u64);
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        sum += samples[i];
+    }
+    uint64_t p50 = leuko_bench_percentile(samples, count, 50);
+    uint64_t p90 = leuko_bench_percentile(samples, count, 90);
+    uint64_t p99 = leuko_bench_percentile(samples, count, 99);
+    if (json)
+    {
+        return leuko_output_buffer_printf(out,
+                                          "\"%s\":{\"min_ns\":%llu,\"p50_ns\":%llu,\"p90_ns\":%llu,\"p99_ns\":%llu,\"max_ns\":%llu,\"mean_ns\":%llu", name,
+                                          (unsigned long long)samples[0], (unsigned long long)p50, (unsigned long long)p90, (unsigned long long)p99,
+                                          (unsigned long long)samples[count - 1], (unsigned long long)(sum / count));
+    }
+    return leuko_output_buffer_printf(out, "  %-18s %10.3f %10.3f %10.3f %10.3f %10.3f\n", name, samples[0] / 1e6, p50 / 1e6, p90 / 1e6, p99 / 1e6,
+                                      samples[count - 1] / 1e6);
+}
+
+/**
+ * @brief Append the hardware counters of one stage.
+ * @param out Report
+ * @param perf Counters (those not available are left out)
+ * @param name Stage name
+ * @param sums Counter deltas of the stage summed over repetitions
+ * @param count Number of repetitions
+ * @param json JSON `counters` member of the stage (otherwise a table row)
+ * @return false on allocation failure
+ */
+static bool leuko_bench_append_counters(leuko_output_buffer_t *out, const leuko_perf_t *perf, const char *name, const uint64_t sums[LEUKO_PERF_COUNTER_COUNT],
+                                        size_t count, bool json)
+{
+    bool has_ipc = leuko_perf_available(perf, LEUKO_PERF_CYCLES) && leuko_perf_available(perf, LEUKO_PERF_INSTRUCTIONS);
+    double ipc = has_ipc && sums[LEUKO_PERF_CYCLES] > 0 ? (double)sums[LEUKO_PERF_INSTRUCTIONS] / sums[LEUKO_PERF_CYCLES] : 0;
+    bool ok = leuko_output_buffer_printf(out, json ? ",\"counters\":{" : "  %-18s", name);
+    bool first = true;
+    for (size_t i = 0; i < LEUKO_PERF_COUNTER_COUNT && ok; ++i)
+    {
+        unsigned long long mean = (unsigned long long)(sums[i] / count);
+        if (!json)
+        {
+            ok = leuko_perf_available(perf, (leuko_perf_counter_t)i) ? leuko_output_buffer_printf(out, " %14llu", mean)
+                                                                    : leuko_output_buffer_printf(out, " %14s", "-");
+        }
+        else if (leuko_perf_available(perf, (leuko_perf_counter_t)i))
+        {
+            ok = leuko_output_buffer_printf(out, "%s\"%s\":%llu", first ? "" : ",", leuko_perf_counter_names[i], mean);
+            first = false;
+        }
+    }
+    if (json)
+    {
+        return ok && (!has_ipc || leuko_output_buffer_printf(out, ",\"ipc\":%.3f", ipc)) && leuko_output_buffer_putc(out, '}');
+    }
+    return ok && (has_ipc ? leuko_output_buffer_printf(out, " %6.2f\n", ipc) : leuko_output_buffer_printf(out, " %6s\n", "-"));
+}
+
+/**
+ * @brief Measure a corpus and append its results to the report.
+ * @param rules Rule groups
+ * @param opts Benchmark settings
+ * @param corpus Corpus
+ * @param sink Descriptor the formatter writes to
+ * @param out Report
+ * @return false on failure
+ */
+static bool leuko_bench_corpus(const leuko_bench_rules_t *rules, const leuko_bench_options_t *opts, leuko_bench_corpus_t *corpus, int sink,
+                               leuko_output_buffer_t *out)
+{
+    leuko_bench_meter_t meter;
+    for (size_t r = 0; r < opts->warmup; ++r)
+    {
+        if (!leuko_bench_run_corpus(rules, opts, corpus, sink, &meter))
+        {
+            return false;
+        }
+    }
+    uint64_t *samples = malloc(sizeof(uint64_t) * LEUKO_BENCH_STAGE_COUNT * opts->repeat);
+    if (!samples)
+    {
+        return false;
+    }
+    uint64_t counters[LEUKO_BENCH_STAGE_COUNT][LEUKO_PERF_COUNTER_COUNT] = {{0}};
+    bool ok = true;
+    for (size_t r = 0; r < opts->repeat && ok; ++r)
+    {
+        ok = leuko_bench_run_corpus(rules, opts, corpus, sink, &meter);
+        for (size_t s = 0; s < LEUKO_BENCH_STAGE_COUNT; ++s)
+        {
+            samples[s * opts->repeat + r] = meter.ns[s];
+            for (size_t i = 0; i < LEUKO_PERF_COUNTER_COUNT; ++i)
+            {
+                counters[s][i] += meter.counters[s][i];
+            }
+        }
+    }
+
+    if (ok && opts->json)
+    {
+        ok = leuko_output_buffer_puts(out, "{\"name\":") && leuko_json_append_string(out, corpus->name, strlen(corpus->name)) &&
+             leuko_output_buffer_printf(out, ",\"files\":%zu,\"bytes\":%zu,\"lines\":%zu,\"offenses\":%zu,\"stages\":{", corpus->count, corpus->bytes, corpus->lines,
+                                        corpus->offenses);
+    }
+    else if (ok)
+    {
+        ok = leuko_output_buffer_printf(out, "%s: %zu files, %zu lines, %zu offenses (ms over %zu runs)\n  %-18s %10s %10s %10s %10s %10s\n", corpus->name,
+                                        corpus->count, corpus->lines, corpus->offenses, opts->repeat, "stage", "min", "p50", "p90", "p99", "max");
+    }
+    for (size_t s = 0; s < LEUKO_BENCH_STAGE_COUNT && ok; ++s)
+    {
+        ok = (!opts->json || s == 0 || leuko_output_buffer_putc(out, ',')) &&
+             leuko_bench_append_stage(out, leuko_bench_stage_names[s], &samples[s * opts->repeat], opts->repeat, opts->json);
+        if (ok && opts->json)
+        {
+            ok = (!opts->perf || leuko_bench_append_counters(out, opts->perf, leuko_bench_stage_names[s], counters[s], opts->repeat, true)) &&
+                 leuko_output_buffer_putc(out, '}');
+        }
+    }
+    if (ok && opts->perf && !opts->json)
+    {
+        ok = leuko_output_buffer_printf(out, "  %-18s", "stage (mean/run)");
+        for (size_t i = 0; i < LEUKO_PERF_COUNTER_COUNT && ok; ++i)
+        {
+            ok = leuko_output_buffer_printf(out, " %14s", leuko_perf_counter_names[i]);
+        }
+        ok = ok && leuko_output_buffer_printf(out, " %6s\n", "ipc");
+        for (size_t s = 0; s < LEUKO_BENCH_STAGE_COUNT && ok; ++s)
+        {
+            ok = leuko_bench_append_counters(out, opts->perf, leuko_bench_stage_names[s], counters[s], opts->repeat, false);
+        }
+    }
+    if (ok)
+    {
+        ok = leuko_output_buffer_puts(out, opts->json ? "}}" : "\n");
+    }
+    free(samples);
+    return ok;
+}
+
+/**
+ * @brief Read a memory baseline.
+ * @param path File of `<corpus> <metric> <value>` lines (`#` starts a comment)
+ * @param out Baseline
+ * @return false if the file could not be read or has an unknown metric
+ */
+static bool leuko_bench_baseline_load(const char *path, leuko_bench_baseline_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+        perror(path);
+        return false;
+    }
+    bool ok = true;
+    char line[512];
+    size_t capacity = 0;
+    for (size_t line_no = 1; ok && fgets(line, sizeof(line), f); ++line_no)
+    {
+        leuko_bench_baseline_entry_t entry;
+        char metric[64];
+        unsigned long long value;
+        if (line[0] == '#' || line[strspn(line, " \t\r\n")] == '\0')
+        {
+            continue;
+        }
+        if (sscanf(line, "%255s %63s %llu", entry.corpus, metric, &value) != 3)
+        {
+            fprintf(stderr, "%s:%zu: expected <corpus> <metric> <value>\n", path, line_no);
+            ok = false;
+            break;
+        }
+        size_t m = 0;
+        while (m < LEUKO_BENCH_METRIC_COUNT && strcmp(metric, leuko_bench_metric_names[m]) != 0)
+        {
+            ++m;
+        }
+        if (m == LEUKO_BENCH_METRIC_COUNT)
+        {
+            fprintf(stderr, "%s:%zu: unknown metric %s\n", path, line_no, metric);
+            ok = false;
+            break;
+        }
+        entry.metric = (leuko_bench_metric_t)m;
+        entry.value = value;
+        if (out->count == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 16;
+            leuko_bench_baseline_entry_t *entries = realloc(out->entries, capacity * sizeof(*entries));
+            if (!entries)
+            {
+                ok = false;
+                break;
+            }
+            out->entries = entries;
+        }
+        out->entries[out->count++] = entry;
+    }
+    fclose(f);
+    return ok;
+}
+
+/**
+ * @brief Check the memory use of a corpus against the baseline.
+ * @param opts Benchmark settings (baseline and margin)
+ * @param corpus Measured corpus
+ * @return false if a value grew by more than the margin
+ * @note Values without a baseline entry are not checked.
+ */
+static bool leuko_bench_baseline_check(const leuko_bench_options_t *opts, const leuko_bench_corpus_t *corpus)
+{
+    bool ok = true;
+    for (size_t i = 0; opts->baseline && i < opts->baseline->count; ++i)
+    {
+        const leuko_bench_baseline_entry_t *entry = &opts->baseline->entries[i];
+        uint64_t value = corpus->memory[entry->metric];
+        if (strcmp(entry->corpus, corpus->name) == 0 && value * 100 > entry->value * (100 + (uint64_t)opts->margin))
+        {
+            fprintf(stderr, "%s: %s is %llu, more than %u%% over the baseline of %llu\n", corpus->name, leuko_bench_metric_names[entry->metric],
+                    (unsigned long long)value, opts->margin, (unsigned long long)entry->value);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Lint a corpus once and append its memory use to the report.
+ * @param rules Rule groups
+ * @param opts Benchmark settings
+ * @param corpus Corpus
+ * @param sink Descriptor the formatter writes to
+ * @param out Report
+ * @param regressed Set when a value exceeds the baseline
+ * @return false on failure
+ * @note Peak RSS is a high-water mark of the whole process: corpora are
+ *       measured in order, so list them from smallest to largest (as the
+ *       default corpora are) for each figure to reflect its own corpus.
+ */
+static bool leuko_bench_memory(const leuko_bench_rules_t *rules, const leuko_bench_options_t *opts, leuko_bench_corpus_t *corpus, int sink,
+                               leuko_output_buffer_t *out, bool *regressed)
+{
+    leuko_bench_meter_t meter;
+    if (!leuko_bench_run_corpus(rules, opts, corpus, sink, &meter))
+    {
+        return false;
+    }
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        corpus->memory[LEUKO_BENCH_METRIC_RSS_PEAK_KB] = (uint64_t)usage.ru_maxrss;
+    }
+    if (!leuko_bench_baseline_check(opts, corpus))
+    {
+        *regressed = true;
+    }
+
+    bool ok;
+    if (opts->json)
+    {
+        ok = leuko_output_buffer_puts(out, "{\"name\":") && leuko_json_append_string(out, corpus->name, strlen(corpus->name)) &&
+             leuko_output_buffer_printf(out, ",\"files\":%zu,\"bytes\":%zu,\"lines\":%zu", corpus->count, corpus->bytes, corpus->lines);
+        for (size_t m = 0; m < LEUKO_BENCH_METRIC_COUNT && ok; ++m)
+        {
+            ok = leuko_output_buffer_printf(out, ",\"%s\":%llu", leuko_bench_metric_names[m], (unsigned long long)corpus->memory[m]);
+        }
+        return ok && leuko_output_buffer_putc(out, '}');
+    }
+    ok = leuko_output_buffer_printf(out, "%-20s %10zu", corpus->name, corpus->lines);
+    for (size_t m = 0; m < LEUKO_BENCH_METRIC_COUNT && ok; ++m)
+    {
+        ok = leuko_output_buffer_printf(out, " %16llu", (unsigned long long)corpus->memory[m]);
+    }
+    return ok && leuko_output_buffer_putc(out, '\n');
+}
+
+/**
+ * @brief Append the memory use of a corpus in the baseline file format.
+ */
+static bool leuko_bench_baseline_append(leuko_output_buffer_t *out, const leuko_bench_corpus_t *corpus)
+{
+    bool ok = true;
+    for (size_t m = 0; m < LEUKO_BENCH_METRIC_COUNT && ok; ++m)
+    {
+        ok = leuko_output_buffer_printf(out, "%s %s %llu\n", corpus->name, leuko_bench_metric_names[m], (unsigned long long)corpus->memory[m]);
+    }
+    return ok;
+}
+
+/**
+ * @brief Runner callback: count the lines of a file and format its result.
+ */
+static void leuko_bench_pass_on_result(const leuko_lint_result_t *result, void *data)
+{
+    leuko_bench_pass_t *pass = data;
+    __atomic_fetch_add(&pass->lines, result->ps->line_count, __ATOMIC_RELAXED);
+    leuko_cli_report_on_result(result, &pass->report);
+}
+
+static void leuko_bench_pass_on_file_done(size_t file_index, size_t worker_index, void *data)
+{
+    leuko_bench_pass_t *pass = data;
+    leuko_cli_report_on_file_done(file_index, worker_index, &pass->report);
+}
+
+/**
+ * @brief Lint a corpus once through the runner.
+ * @param opts Benchmark settings
+ * @param corpus Corpus (its line and offense counts are updated)
+ * @param jobs Number of threads
+ * @param sink Descriptor the formatter writes to
+ * @param wall Output: time from the start of the formatter to the end of the run
+ * @param latencies Per-file lint times are appended here (may be NULL)
+ * @param latency_count Number of values in `latencies`
+ * @param latency_capacity Capacity of `latencies`
+ * @return false on failure
+ * @note File times come from the "lint" spans of a trace of the run.
+ */
+static bool leuko_bench_pass(const leuko_bench_options_t *opts, leuko_bench_corpus_t *corpus, size_t jobs, int sink, uint64_t *wall, uint64_t **latencies,
+                             size_t *latency_count, size_t *latency_capacity)
+{
+    leuko_runner_options_t run_opts = {
+        .jobs = jobs,
+        .fsync = false,
+        .dry_run = true,
+        .lines = NULL,
+        .engine = {
+            .cancel = NULL,
+            .stop_on_diagnostic = false,
+            .fail_level = LEUKO_SEVERITY_REFACTOR,
+            .fix_mode = LEUKO_FIX_MODE_NONE,
+            .enabled = NULL,
+        },
+        .on_result = leuko_bench_pass_on_result,
+        .on_file_done = leuko_bench_pass_on_file_done,
+        .data = NULL,
+    };
+    size_t workers = leuko_runner_jobs(&run_opts, corpus->count);
+    leuko_trace_t trace = {0};
+    if (latencies && !leuko_trace_init(&trace, workers))
+    {
+        return false;
+    }
+    run_opts.engine.trace = latencies ? &trace : NULL;
+    leuko_bench_pass_t pass = {.lines = 0};
+    run_opts.data = &pass;
+
+    uint64_t start = leuko_clock_ns();
+    if (!leuko_cli_report_begin(&pass.report, opts->formatter, corpus->files, corpus->count, workers, sink))
+    {
+        fprintf(stderr, "leuko_bench: could not start the formatter\n");
+        leuko_trace_free(&trace);
+        return false;
+    }
+    leuko_runner_stats_t stats;
+    bool ok = leuko_runner_run(corpus->files, corpus->count, &run_opts, &stats);
+    ok = leuko_cli_report_end(&pass.report) && ok;
+    *wall = leuko_clock_ns() - start;
+    corpus->lines = pass.lines;
+    corpus->offenses = stats.diagnostics;
+
+    for (size_t w = 0; latencies && w < trace.ring_count && ok; ++w)
+    {
+        const leuko_trace_ring_t *ring = &trace.rings[w];
+        uint64_t first = ring->recorded > LEUKO_TRACE_RING_EVENTS ? ring->recorded - LEUKO_TRACE_RING_EVENTS : 0;
+        for (uint64_t i = first; i < ring->recorded && ok; ++i)
+        {
+            const leuko_trace_event_t *event = &ring->events[i & (LEUKO_TRACE_RING_EVENTS - 1)];
+            if (strcmp(event->name, "lint") != 0)
+            {
+                continue;
+            }
+            if (*latency_count == *latency_capacity)
+            {
+                size_t capacity = *latency_capacity ? *latency_capacity * 2 : 256;
+                uint64_t *grown = realloc(*latencies, capacity * sizeof(uint64_t));
+                if (!grown)
+                {
+                    ok = false;
+                    break;
+                }
+                *latencies = grown;
+                *latency_capacity = capacity;
+            }
+            (*latencies)[(*latency_count)++] = event->end - event->start;
+        }
+    }
+    leuko_trace_free(&trace);
+    return ok;
+}
+
+/**
+ * @brief Measure a corpus at every thread count and append the results to the report.
+ * @param opts Benchmark settings
+ * @param corpus Corpus
+ * @param sink Descriptor the formatter writes to
+ * @param out Report
+ * @return false on failure
+ * @note The run time of a thread count is the median over repetitions.
+ *       Speedup and efficiency are relative to the first thread count,
+ *       scaled by its number of workers: with 1 first, speedup is T1 / Tn
+ *       and efficiency speedup / n. A corpus of fewer files than threads
+ *       runs with one worker per file.
+ */
+static bool leuko_bench_scaling(const leuko_bench_options_t *opts, leuko_bench_corpus_t *corpus, int sink, leuko_output_buffer_t *out)
+{
+    uint64_t *walls = malloc(sizeof(uint64_t) * opts->repeat);
+    if (!walls)
+    {
+        return false;
+    }
+    bool ok = true;
+    uint64_t base = 0;
+    size_t base_workers = 0;
+    for (size_t t = 0; t < opts->thread_count && ok; ++t)
+    {
+        size_t jobs = opts->threads[t];
+        leuko_runner_options_t probe = {.jobs = jobs};
+        size_t workers = leuko_runner_jobs(&probe, corpus->count);
+        uint64_t wall = 0;
+        for (size_t r = 0; r < opts->warmup && ok; ++r)
+        {
+            ok = leuko_bench_pass(opts, corpus, jobs, sink, &wall, NULL, NULL, NULL);
+        }
+        uint64_t *latencies = NULL;
+        size_t latency_count = 0;
+        size_t latency_capacity = 0;
+        for (size_t r = 0; r < opts->repeat && ok; ++r)
+        {
+            ok = leuko_bench_pass(opts, corpus, jobs, sink, &walls[r], &latencies, &latency_count, &latency_capacity);
+        }
+        if (!ok || latency_count == 0)
+        {
+            free(latencies);
+            ok = false;
+            break;
+        }
+        qsort(walls, opts->repeat, sizeof(walls[0]), leuko_bench_compare_u64);
+        qsort(latencies, latency_count, sizeof(latencies[0]), leuko_bench_compare_u64);
+        wall = leuko_bench_percentile(walls, opts->repeat, 50);
+        if (t == 0)
+        {
+            base = wall;
+            base_workers = workers;
+        }
+        double seconds = wall > 0 ? wall / 1e9 : 1e-9;
+        double speedup = wall > 0 ? (double)base * base_workers / wall : 0;
+        double efficiency = speedup / workers;
+        uint64_t p50 = leuko_bench_percentile(latencies, latency_count, 50);
+        uint64_t p99 = leuko_bench_percentile(latencies, latency_count, 99);
+        uint64_t max = latencies[latency_count - 1];
+        free(latencies);
+
+        if (opts->json)
+        {
+            if (t == 0)
+            {
+                ok = leuko_output_buffer_puts(out, "{\"name\":") && leuko_json_append_string(out, corpus->name, strlen(corpus->name)) &&
+                     leuko_output_buffer_printf(out, ",\"files\":%zu,\"bytes\":%zu,\"lines\":%zu,\"offenses\":%zu,\"threads\":[", corpus->count, corpus->bytes,
+                                                corpus->lines, corpus->offenses);
+            }
+            ok = ok && leuko_output_buffer_printf(out,
+                                                  "%s{\"threads\":%zu,\"workers\":%zu,\"wall_ns\":%llu,\"files_per_s\":%.1f,\"lines_per_s\":%.1f,"
+                                                  "\"speedup\":%.3f,\"efficiency\":%.3f,\"file_p50_ns\":%llu,\"file_p99_ns\":%llu,\"file_max_ns\":%llu}",
+                                                  t ? "," : "", jobs, workers, (unsigned long long)wall, corpus->count / seconds, corpus->lines / seconds, speedup,
+                                                  efficiency, (unsigned long long)p50, (unsigned long long)p99, (unsigned long long)max);
+            continue;
+        }
+        if (t == 0)
+        {
+            ok = leuko_output_buffer_printf(out, "%s: %zu files, %zu lines (median of %zu runs, file times in ms)\n  %7s %7s %10s %12s %13s %8s %10s %9s %9s %9s\n",
+                                            corpus->name, corpus->count, corpus->lines, opts->repeat, "threads", "workers", "wall (ms)", "files/s", "lines/s",
+                                            "speedup", "efficiency", "file p50", "file p99", "file max");
+        }
+        ok = ok && leuko_output_buffer_printf(out, "  %7zu %7zu %10.3f %12.1f %13.1f %8.2f %10.2f %9.3f %9.3f %9.3f\n", jobs, workers, wall / 1e6,
+                                              corpus->count / seconds, corpus->lines / seconds, speedup, efficiency, p50 / 1e6, p99 / 1e6, max / 1e6);
+    }
+    free(walls);
+    return ok && leuko_output_buffer_puts(out, opts->json ? "]}" : "\n");
+}
+
+/**
+ * @brief Parse a comma-separated list of thread counts (`N`: one per CPU).
+ * @note Repeated counts are measured once (`N` is often one of the others).
+ */
+static bool leuko_bench_parse_threads(const char *list, leuko_bench_options_t *opts)
+{
+    opts->thread_count = 0;
+    for (const char *p = list; *p;)
+    {
+        size_t len = strcspn(p, ",");
+        char *end = NULL;
+        unsigned long n = (len == 1 && *p == 'N') ? leuko_runner_default_jobs() : strtoul(p, &end, 10);
+        if (opts->thread_count == LEUKO_BENCH_MAX_THREAD_COUNTS || n == 0 || (end && end != p + len))
+        {
+            fprintf(stderr, "leuko_bench: invalid thread list %s\n", list);
+            return false;
+        }
+        bool seen = false;
+        for (size_t i = 0; i < opts->thread_count; ++i)
+        {
+            seen = seen || opts->threads[i] == n;
+        }
+        if (!seen)
+        {
+            opts->threads[opts->thread_count++] = n;
+        }
+        p += len + (p[len] == ',');
+    }
+    return opts->thread_count > 0;
+}
+
+/**
+ * @brief List the default corpora of a scaling run: `multi_1000`, `multi_10000` and `multi_100000`.
+ * @param dir Bench directory
+ * @param out Output: corpus paths (those that exist)
+ * @param out_count Output: number of corpora
+ * @return false on allocation failure
+ */
+static bool leuko_bench_scaling_corpora(const char *dir, char ***out, size_t *out_count)
+{
+    static const char *const names[] = {"multi_1000", "multi_10000", "multi_100000"};
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]) && ok; ++i)
+    {
+        char path[4096];
+        struct stat st;
+        snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+        if (stat(path, &st) == 0 && S_ISDIR(st.st_mode))
+        {
+            ok = leuko_str_arr_push(out, out_count, path);
+        }
+    }
+    return ok;
+}
+
+/* Shorter names first, then bytewise: `bench_2000.rb` before `bench_10000.rb` */
+static int leuko_bench_compare_names(const void *a, const void *b)
+{
+    const char *x = *(char *const *)a;
+    const char *y = *(char *const *)b;
+    size_t lx = strlen(x);
+    size_t ly = strlen(y);
+    if (lx != ly)
+    {
+        return lx < ly ? -1 : 1;
+    }
+    return strcmp(x, y);
+}
+
+/**
+ * @brief List the default corpora: `bench_*.rb` files, then `multi_*` directories.
+ * @param dir Bench directory
+ * @param out Output: corpus paths
+ * @param out_count Output: number of corpora
+ * @return false if the directory could not be read
+ */
+static bool leuko_bench_default_corpora(const char *dir, char ***out, size_t *out_count)
+{
+    DIR *d = opendir(dir);
+    if (!d)
+    {
+        perror(dir);
+        return false;
+    }
+    char **files = NULL;
+    size_t files_count = 0;
+    char **dirs = NULL;
+    size_t dirs_count = 0;
+    bool ok = true;
+    struct dirent *entry;
+    while (ok && (entry = readdir(d)) != NULL)
+    {
+        const char *name = entry->d_name;
+        size_t len = strlen(name);
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/%s", dir, name);
+        if (strncmp(name, "bench_", 6) == 0 && len > 3 && strcmp(name + len - 3, ".rb") == 0)
+        {
+            ok = leuko_str_arr_push(&files, &files_count, path);
+        }
+        else if (strncmp(name, "multi_", 6) == 0)
+        {
+            ok = leuko_str_arr_push(&dirs, &dirs_count, path);
+        }
+    }
+    closedir(d);
+    if (files_count > 1)
+    {
+        qsort(files, files_count, sizeof(files[0]), leuko_bench_compare_names);
+    }
+    if (dirs_count > 1)
+    {
+        qsort(dirs, dirs_count, sizeof(dirs[0]), leuko_bench_compare_names);
+    }
+    ok = ok && leuko_str_arr_concat(&files, &files_count, dirs, dirs_count);
+    free(dirs);
+    *out = files;
+    *out_count = files_count;
+    return ok;
+}
+
+/**
+ * @brief Load the file list of a corpus.
+ * @param path File or directory
+ * @param out Corpus
+ * @return false if it has no Ruby files
+ */
+static bool leuko_bench_corpus_load(char *path, leuko_bench_corpus_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    const char *base = strrchr(path, '/');
+    out->name = strdup(base && base[1] ? base + 1 : path);
+    char *paths[] = {path};
+    if (!out->name || !leuko_file_collect_ruby(paths, 1, &out->files, &out->count) || out->count == 0)
+    {
+        fprintf(stderr, "%s: no Ruby files\n", path);
+        return false;
+    }
+    for (size_t i = 0; i < out->count; ++i)
+    {
+        struct stat st;
+        if (stat(out->files[i], &st) == 0)
+        {
+            out->bytes += (size_t)st.st_size;
+        }
+    }
+    return true;
+}
+
+static void leuko_bench_corpus_free(leuko_bench_corpus_t *corpus)
+{
+    for (size_t i = 0; i < corpus->count; ++i)
+    {
+        free(corpus->files[i]);
+    }
+    free(corpus->files);
+    free(corpus->name);
+}
+
+static void leuko_bench_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options] [corpus...]\n"
+            "  -w, --warmup N        unmeasured runs per corpus (default 1)\n"
+            "  -n, --repeat N        measured runs per corpus (default 10)\n"
+            "  -f, --formatter NAME  formatter timed by the format stage (default progress)\n"
+            "  -o, --output FILE     write the report to FILE (default stdout)\n"
+            "  -d, --bench-dir DIR   where the default corpora are (default %s)\n"
+            "      --text            print a table instead of JSON\n"
+            "      --counters        also read hardware counters per stage (perf_event_open)\n"
+            "      --memory          lint each corpus once and report its memory use\n"
+            "      --baseline FILE   with --memory: fail when a value exceeds FILE\n"
+            "      --margin PCT      tolerated growth over the baseline (default 10)\n"
+            "      --write-baseline FILE  with --memory: record the values to FILE\n"
+            "      --scaling         lint through the runner at several thread counts\n"
+            "      --threads LIST    thread counts of --scaling (default 1,2,4,N; N: one per CPU)\n"
+            "A corpus is a Ruby file or a directory; without any, every bench_*.rb\n"
+            "file and multi_* directory of the bench directory is measured (with\n"
+            "--scaling: multi_1000, multi_10000 and multi_100000).\n",
+            prog, LEUKO_BENCH_DIR);
+}
+
+int main(int argc, char *argv[])
+{
+    leuko_bench_options_t opts = {
+        .warmup = 1,
+        .repeat = 10,
+        .formatter = LEUKO_CLI_FORMATTER_PROGRESS,
+        .json = true,
+        .memory = false,
+        .margin = 10,
+        .baseline = NULL,
+        .scaling = false,
+        .thread_count = 0,
+        .perf = NULL,
+    };
+    leuko_bench_baseline_t baseline = {0};
+    const char *baseline_path = NULL;
+    const char *write_baseline = NULL;
+    bool counters = false;
+    leuko_perf_t perf;
+    const char *formatter_name = LEUKO_CLI_FORMATTER_NAME_PROGRESS;
+    const char *output = NULL;
+    const char *bench_dir = LEUKO_BENCH_DIR;
+    static const struct option long_options[] = {
+        {"warmup", required_argument, NULL, 'w'},    {"repeat", required_argument, NULL, 'n'}, {"formatter", required_argument, NULL, 'f'},
+        {"output", required_argument, NULL, 'o'},    {"bench-dir", required_argument, NULL, 'd'}, {"text", no_argument, NULL, 't'},
+        {"memory", no_argument, NULL, 'm'},          {"baseline", required_argument, NULL, 'b'}, {"margin", required_argument, NULL, 'M'},
+        {"write-baseline", required_argument, NULL, 'W'}, {"scaling", no_argument, NULL, 's'}, {"threads", required_argument, NULL, 'T'},
+        {"counters", no_argument, NULL, 'c'},
+        {"help", no_argument, NULL, 'h'},            {NULL, 0, NULL, 0},
+    };
+    int c;
+    while ((c = getopt_long(argc, argv, "w:n:f:o:d:h", long_options, NULL)) != -1)
+    {
+        switch (c)
+        {
+        case 'w':
+            opts.warmup = strtoul(optarg, NULL, 10);
+            break;
+        case 'n':
+            opts.repeat = strtoul(optarg, NULL, 10);
+            break;
+        case 'f':
+            if (!leuko_cli_formatter_from_string(optarg, &opts.formatter))
+            {
+                fprintf(stderr, "leuko_bench: unknown formatter %s\n", optarg);
+                return 2;
+            }
+            formatter_name = optarg;
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        case 'd':
+            bench_dir = optarg;
+            break;
+        case 't':
+            opts.json = false;
+            break;
+        case 'm':
+            opts.memory = true;
+            break;
+        case 'b':
+            baseline_path = optarg;
+            break;
+        case 'M':
+            opts.margin = (unsigned)strtoul(optarg, NULL, 10);
+            break;
+        case 'W':
+            write_baseline = optarg;
+            break;
+        case 's':
+            opts.scaling = true;
+            break;
+        case 'c':
+            counters = true;
+            break;
+        case 'T':
+            if (!leuko_bench_parse_threads(optarg, &opts))
+            {
+                return 2;
+            }
+            break;
+        case 'h':
+            leuko_bench_usage(argv[0]);
+            return 0;
+        default:
+            leuko_bench_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (opts.repeat == 0)
+    {
+        fprintf(stderr, "leuko_bench: --repeat must be at least 1\n");
+        return 2;
+    }
+    if (opts.memory && opts.scaling)
+    {
+        fprintf(stderr, "leuko_bench: --memory and --scaling are exclusive\n");
+        return 2;
+    }
+    if (opts.scaling && opts.thread_count == 0)
+    {
+        leuko_bench_parse_threads("1,2,4,N", &opts);
+    }
+    if ((baseline_path || write_baseline) && !opts.memory)
+    {
+        fprintf(stderr, "leuko_bench: --baseline and --write-baseline need --memory\n");
+        return 2;
+    }
+    if (baseline_path)
+    {
+        if (!leuko_bench_baseline_load(baseline_path, &baseline))
+        {
+            free(baseline.entries);
+            return 2;
+        }
+        opts.baseline = &baseline;
+    }
+    /* Counters follow the calling thread: only the stage mode lints there */
+    if (counters && (opts.memory || opts.scaling))
+    {
+        fprintf(stderr, "leuko_bench: --counters only applies to stage times\n");
+        free(baseline.entries);
+        return 2;
+    }
+    if (counters && leuko_perf_open(&perf))
+    {
+        opts.perf = &perf;
+    }
+    else if (counters)
+    {
+        fprintf(stderr, "leuko_bench: hardware counters are not available (%s); measuring time only\n", strerror(errno));
+    }
+
+    char **paths = NULL;
+    size_t paths_count = 0;
+    bool ok = true;
+    for (int i = optind; i < argc && ok; ++i)
+    {
+        ok = leuko_str_arr_push(&paths, &paths_count, argv[i]);
+    }
+    if (optind == argc)
+    {
+        ok = opts.scaling ? leuko_bench_scaling_corpora(bench_dir, &paths, &paths_count) : leuko_bench_default_corpora(bench_dir, &paths, &paths_count);
+    }
+    int sink = open("/dev/null", O_WRONLY);
+    int fd = output ? open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644) : STDOUT_FILENO;
+    if (sink < 0 || fd < 0)
+    {
+        perror(sink < 0 ? "/dev/null" : output);
+        ok = false;
+    }
+
+    leuko_bench_rules_t *rules = malloc(sizeof(*rules));
+    ok = ok && rules;
+    if (ok)
+    {
+        leuko_bench_rules_init(rules);
+    }
+    leuko_output_buffer_t out;
+    leuko_output_buffer_init(&out);
+    leuko_output_buffer_t recorded;
+    leuko_output_buffer_init(&recorded);
+    bool regressed = false;
+    if (ok && opts.json && opts.scaling)
+    {
+        ok = leuko_output_buffer_printf(&out, "{\"mode\":\"scaling\",\"warmup\":%zu,\"repetitions\":%zu,\"formatter\":\"%s\",\"cpus\":%zu,\"corpora\":[",
+                                        opts.warmup, opts.repeat, formatter_name, leuko_runner_default_jobs());
+    }
+    else if (ok && opts.json && opts.memory)
+    {
+        ok = leuko_output_buffer_printf(&out, "{\"mode\":\"memory\",\"formatter\":\"%s\",\"margin_pct\":%u,\"corpora\":[", formatter_name, opts.margin);
+    }
+    else if (ok && opts.json)
+    {
+        ok = leuko_output_buffer_printf(&out, "{\"warmup\":%zu,\"repetitions\":%zu,\"formatter\":\"%s\",\"counters\":%s,\"corpora\":[", opts.warmup,
+                                        opts.repeat, formatter_name, opts.perf ? "true" : "false");
+    }
+    else if (ok && opts.memory)
+    {
+        ok = leuko_output_buffer_printf(&out, "%-20s %10s", "corpus", "lines");
+        for (size_t m = 0; m < LEUKO_BENCH_METRIC_COUNT && ok; ++m)
+        {
+            ok = leuko_output_buffer_printf(&out, " %16s", leuko_bench_metric_names[m]);
+        }
+        ok = ok && leuko_output_buffer_putc(&out, '\n');
+    }
+    for (size_t i = 0; i < paths_count && ok; ++i)
+    {
+        leuko_bench_corpus_t corpus;
+        ok = leuko_bench_corpus_load(paths[i], &corpus) && (!opts.json || i == 0 || leuko_output_buffer_putc(&out, ','));
+        if (ok && opts.memory)
+        {
+            ok = leuko_bench_memory(rules, &opts, &corpus, sink, &out, &regressed) && (!write_baseline || leuko_bench_baseline_append(&recorded, &corpus));
+        }
+        else if (ok && opts.scaling)
+        {
+            ok = leuko_bench_scaling(&opts, &corpus, sink, &out);
+        }
+        else if (ok)
+        {
+            ok = leuko_bench_corpus(rules, &opts, &corpus, sink, &out);
+        }
+        leuko_bench_corpus_free(&corpus);
+    }
+    if (ok && opts.json)
+    {
+        ok = leuko_output_buffer_puts(&out, "]}\n");
+    }
+    ok = ok && leuko_output_write_all(fd, out.data, out.len);
+    if (ok && write_baseline && !leuko_file_write_atomic(write_baseline, (const uint8_t *)recorded.data, recorded.len, 0644))
+    {
+        fprintf(stderr, "%s: could not write baseline\n", write_baseline);
+        ok = false;
+    }
+
+    leuko_output_buffer_free(&out);
+    leuko_output_buffer_free(&recorded);
+    free(baseline.entries);
+    if (opts.perf)
+    {
+        leuko_perf_close(&perf);
+    }
+    free(rules);
+    for (size_t i = 0; i < paths_count; ++i)
+    {
+        free(paths[i]);
+    }
+    free(paths);
+    if (sink >= 0)
+    {
+        close(sink);
+    }
+    if (output && fd >= 0)
+    {
+        close(fd);
+    }
+    return ok && !regressed ? 0 : 1;
+}
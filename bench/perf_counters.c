@@ -0,0 +1,144 @@
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include "perf_counters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+/*
+ * Hardware counters through perf_event_open(2), user space only.
+ *
+ * The counters are opened as one group so that a single read returns all of
+ * them for the same interval. When the kernel multiplexes the group, values
+ * are scaled by the fraction of time it was scheduled. Counters the CPU or
+ * the kernel does not provide (virtual machines, containers, a restrictive
+ * perf_event_paranoid) are left out; when none is left, leuko_perf_open()
+ * fails and the caller goes on without counters.
+ */
+
+const char *const leuko_perf_counter_names[LEUKO_PERF_COUNTER_COUNT] = {
+    "cycles",
+    "instructions",
+    "cache_misses",
+    "branch_misses",
+};
+
+#ifdef __linux__
+static const uint64_t leuko_perf_configs[LEUKO_PERF_COUNTER_COUNT] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+#endif
+
+/**
+ * @brief Open the counters of the calling thread and start them.
+ * @param perf Counters
+ * @return false if no counter could be opened (all reads then return zeros)
+ */
+bool leuko_perf_open(leuko_perf_t *perf)
+{
+    perf->leader = -1;
+    perf->opened = 0;
+    for (int i = 0; i < LEUKO_PERF_COUNTER_COUNT; ++i)
+    {
+        perf->fds[i] = -1;
+        perf->slots[i] = -1;
+    }
+#ifdef __linux__
+    for (int i = 0; i < LEUKO_PERF_COUNTER_COUNT; ++i)
+    {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = leuko_perf_configs[i];
+        attr.disabled = perf->leader < 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, perf->leader, PERF_FLAG_FD_CLOEXEC);
+        if (fd < 0)
+        {
+            continue;
+        }
+        if (perf->leader < 0)
+        {
+            perf->leader = fd;
+        }
+        perf->fds[i] = fd;
+        perf->slots[i] = perf->opened++;
+    }
+    if (perf->leader < 0)
+    {
+        return false;
+    }
+    ioctl(perf->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(perf->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+#else
+    errno = ENOSYS;
+    return false;
+#endif
+}
+
+/**
+ * @brief Check whether a counter was opened.
+ */
+bool leuko_perf_available(const leuko_perf_t *perf, leuko_perf_counter_t counter)
+{
+    return perf->slots[counter] >= 0;
+}
+
+/**
+ * @brief Read the counters (running totals since leuko_perf_open).
+ * @param perf Counters
+ * @param out Values (zero for counters that are not available)
+ */
+void leuko_perf_read(const leuko_perf_t *perf, uint64_t out[LEUKO_PERF_COUNTER_COUNT])
+{
+    memset(out, 0, sizeof(uint64_t) * LEUKO_PERF_COUNTER_COUNT);
+    if (perf->leader < 0)
+    {
+        return;
+    }
+    /* nr, time_enabled, time_running, then one value per counter */
+    uint64_t data[3 + LEUKO_PERF_COUNTER_COUNT];
+    ssize_t n = read(perf->leader, data, sizeof(data));
+    if (n < (ssize_t)(3 * sizeof(uint64_t)) || data[0] != (uint64_t)perf->opened || data[2] == 0)
+    {
+        return;
+    }
+    double scale = data[2] < data[1] ? (double)data[1] / data[2] : 1.0;
+    for (int i = 0; i < LEUKO_PERF_COUNTER_COUNT; ++i)
+    {
+        if (perf->slots[i] >= 0)
+        {
+            out[i] = scale == 1.0 ? data[3 + perf->slots[i]] : (uint64_t)(data[3 + perf->slots[i]] * scale);
+        }
+    }
+}
+
+/**
+ * @brief Close the counters.
+ * @param perf Counters
+ */
+void leuko_perf_close(leuko_perf_t *perf)
+{
+    for (int i = 0; i < LEUKO_PERF_COUNTER_COUNT; ++i)
+    {
+        if (perf->fds[i] >= 0)
+        {
+            close(perf->fds[i]);
+        }
+        perf->fds[i] = -1;
+        perf->slots[i] = -1;
+    }
+    perf->leader = -1;
+    perf->opened = 0;
+}
@@ -0,0 +1,37 @@
+#ifndef LEUKO_BENCH_PERF_COUNTERS_H
+#define LEUKO_BENCH_PERF_COUNTERS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Hardware counters read by the benchmark.
+ */
+typedef enum leuko_perf_counter_e
+{
+    LEUKO_PERF_CYCLES,        /* CPU cycles */
+    LEUKO_PERF_INSTRUCTIONS,  /* retired instructions */
+    LEUKO_PERF_CACHE_MISSES,  /* last level cache misses */
+    LEUKO_PERF_BRANCH_MISSES, /* mispredicted branches */
+    LEUKO_PERF_COUNTER_COUNT,
+} leuko_perf_counter_t;
+
+extern const char *const leuko_perf_counter_names[LEUKO_PERF_COUNTER_COUNT];
+
+/**
+ * @brief Counters of the calling thread, opened as one group.
+ */
+typedef struct leuko_perf_s
+{
+    int leader;                          /* group leader descriptor (-1: closed) */
+    int fds[LEUKO_PERF_COUNTER_COUNT];   /* descriptor per counter (-1: not available) */
+    int slots[LEUKO_PERF_COUNTER_COUNT]; /* position of the counter in a group read (-1: not available) */
+    int opened;                          /* number of counters in the group */
+} leuko_perf_t;
+
+bool leuko_perf_open(leuko_perf_t *perf);
+bool leuko_perf_available(const leuko_perf_t *perf, leuko_perf_counter_t counter);
+void leuko_perf_read(const leuko_perf_t *perf, uint64_t out[LEUKO_PERF_COUNTER_COUNT]);
+void leuko_perf_close(leuko_perf_t *perf);
+
+#endif /* LEUKO_BENCH_PERF_COUNTERS_H */
@@ -0,0 +1,604 @@
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "cJSON.h"
+#include "cli/formatter.h"
+#include "engine/runner.h"
+#include "output/json_escape.h"
+#include "output/output_buffer.h"
+#include "output/output_writer.h"
+#include "rules/rule.h"
+#include "utils/clock.h"
+#include "utils/file.h"
+#include "utils/string_array.h"
+
+/*
+ * Parity and speed against a recorded RuboCop run.
+ *
+ * The baseline is RuboCop's JSON report of a set of files (paths relative
+ * to the baseline file), with a `timing` member added by
+ * scripts/record_rubocop_baseline.rb. The files are linted with every rule,
+ * through the runner and the json formatter as the command line does, and
+ * for each implemented cop the offenses (file, line, column) of both tools
+ * are compared as sets. Cops RuboCop reported that are not implemented are
+ * only counted. The speedup is RuboCop's recorded wall time over the median
+ * time of leukocyte's runs.
+ */
+
+/**
+ * @brief Maximum number of differences listed per cop.
+ */
+#define LEUKO_PARITY_DEFAULT_EXAMPLES 5
+
+/**
+ * @brief Position of an offense.
+ */
+typedef struct leuko_parity_offense_s
+{
+    uint32_t file;   /* index of the file in the baseline */
+    int32_t line;    /* first line (1-based) */
+    uint32_t column; /* first column (1-based, in characters) */
+} leuko_parity_offense_t;
+
+/**
+ * @brief Offenses of one cop.
+ */
+typedef struct leuko_parity_list_s
+{
+    leuko_parity_offense_t *items;
+    size_t count;
+    size_t capacity;
+} leuko_parity_list_t;
+
+/**
+ * @brief Offense found by leukocyte in one file.
+ */
+typedef struct leuko_parity_found_s
+{
+    leuko_rule_id_t rule;
+    int32_t line;
+    uint32_t column;
+} leuko_parity_found_t;
+
+/**
+ * @brief Offenses found in one file (only written by the worker linting it).
+ */
+typedef struct leuko_parity_file_s
+{
+    leuko_parity_found_t *items;
+    size_t count;
+    size_t capacity;
+} leuko_parity_file_t;
+
+/**
+ * @brief Baseline and results of a comparison.
+ */
+typedef struct leuko_parity_s
+{
+    char **files;                                      /* files of the baseline, resolved */
+    char **names;                                      /* files as written in the baseline */
+    size_t count;                                      /* number of files */
+    bool implemented[LEUKO_RULE_ID_COUNT];             /* rules leukocyte implements */
+    leuko_parity_list_t expected[LEUKO_RULE_ID_COUNT]; /* RuboCop offenses of implemented cops */
+    leuko_parity_list_t actual[LEUKO_RULE_ID_COUNT];   /* leukocyte offenses */
+    char **skipped_cops;                               /* cops of the baseline that are not implemented */
+    size_t skipped_cop_count;                          /* number of those */
+    size_t skipped_offenses;                           /* offenses of those */
+    char rubocop_version[64];                          /* from the baseline metadata ("" if absent) */
+    double rubocop_ms;                                 /* recorded RuboCop wall time (0 if absent) */
+} leuko_parity_t;
+
+/**
+ * @brief State of one run over the baseline files.
+ */
+typedef struct leuko_parity_pass_s
+{
+    leuko_cli_report_t report;  /* json formatter the results go through */
+    leuko_parity_file_t *found; /* per-file offenses (NULL: not collected) */
+    bool failed;                /* an allocation failed while collecting */
+} leuko_parity_pass_t;
+
+static bool leuko_parity_list_push(leuko_parity_list_t *list, uint32_t file, int32_t line, uint32_t column)
+{
+    if (list->count == list->capacity)
+    {
+        size_t capacity = list->capacity ? list->capacity * 2 : 16;
+        leuko_parity_offense_t *items = realloc(list->items, capacity * sizeof(*items));
+        if (!items)
+        {
+            return false;
+        }
+        list->items = items;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = (leuko_parity_offense_t){.file = file, .line = line, .column = column};
+    return true;
+}
+
+static int leuko_parity_compare(const void *a, const void *b)
+{
+    const leuko_parity_offense_t *x = a;
+    const leuko_parity_offense_t *y = b;
+    if (x->file != y->file)
+    {
+        return x->file < y->file ? -1 : 1;
+    }
+    if (x->line != y->line)
+    {
+        return x->line < y->line ? -1 : 1;
+    }
+    return x->column < y->column ? -1 : x->column > y->column;
+}
+
+/**
+ * @brief Find an implemented rule by cop name (`Category/Name`).
+ * @return Rule id, or LEUKO_RULE_ID_COUNT if it is not implemented
+ */
+static leuko_rule_id_t leuko_parity_rule_id(const leuko_parity_t *parity, const char *cop)
+{
+    const char *slash = strchr(cop, '/');
+    if (!slash)
+    {
+        return LEUKO_RULE_ID_COUNT;
+    }
+    size_t category_len = (size_t)(slash - cop);
+    for (leuko_rule_id_t id = 0; id < LEUKO_RULE_ID_COUNT; ++id)
+    {
+        const leuko_rule_info_t *info = leuko_rule_info(id);
+        if (parity->implemented[id] && strlen(info->category) == category_len && strncmp(cop, info->category, category_len) == 0 &&
+            strcmp(slash + 1, info->name) == 0)
+        {
+            return id;
+        }
+    }
+    return LEUKO_RULE_ID_COUNT;
+}
+
+/**
+ * @brief Count an offense of a cop leukocyte does not implement.
+ */
+static bool leuko_parity_skip(leuko_parity_t *parity, const char *cop)
+{
+    parity->skipped_offenses++;
+    for (size_t i = 0; i < parity->skipped_cop_count; ++i)
+    {
+        if (strcmp(parity->skipped_cops[i], cop) == 0)
+        {
+            return true;
+        }
+    }
+    return leuko_str_arr_push(&parity->skipped_cops, &parity->skipped_cop_count, cop);
+}
+
+/**
+ * @brief Read the baseline.
+ * @param path RuboCop JSON report with a `timing` member
+ * @param parity Output: files, expected offenses and RuboCop timing
+ * @return false if the file could not be read or is not a RuboCop report
+ */
+static bool leuko_parity_load(const char *path, leuko_parity_t *parity)
+{
+    uint8_t *text = NULL;
+    size_t text_len = 0;
+    if (!leuko_file_read_all(path, &text, &text_len))
+    {
+        fprintf(stderr, "%s: could not read baseline\n", path);
+        return false;
+    }
+    cJSON *root = cJSON_ParseWithLength((const char *)text, text_len);
+    free(text);
+    const cJSON *files = root ? cJSON_GetObjectItemCaseSensitive(root, "files") : NULL;
+    if (!cJSON_IsArray(files))
+    {
+        fprintf(stderr, "%s: not a RuboCop JSON report\n", path);
+        cJSON_Delete(root);
+        return false;
+    }
+    const cJSON *version = cJSON_GetObjectItemCaseSensitive(cJSON_GetObjectItemCaseSensitive(root, "metadata"), "rubocop_version");
+    if (cJSON_IsString(version))
+    {
+        snprintf(parity->rubocop_version, sizeof(parity->rubocop_version), "%s", version->valuestring);
+    }
+    const cJSON *elapsed = cJSON_GetObjectItemCaseSensitive(cJSON_GetObjectItemCaseSensitive(root, "timing"), "elapsed_ms");
+    parity->rubocop_ms = cJSON_IsNumber(elapsed) ? elapsed->valuedouble : 0;
+
+    const char *slash = strrchr(path, '/');
+    int dir_len = slash ? (int)(slash - path) : 1;
+    const char *dir = slash ? path : ".";
+    bool ok = true;
+    const cJSON *file;
+    cJSON_ArrayForEach(file, files)
+    {
+        const cJSON *name = cJSON_GetObjectItemCaseSensitive(file, "path");
+        if (!ok || !cJSON_IsString(name))
+        {
+            continue;
+        }
+        char resolved[4096];
+        if (name->valuestring[0] == '/')
+        {
+            snprintf(resolved, sizeof(resolved), "%s", name->valuestring);
+        }
+        else
+        {
+            snprintf(resolved, sizeof(resolved), "%.*s/%s", dir_len, dir, name->valuestring);
+        }
+        uint32_t index = (uint32_t)parity->count;
+        size_t names_count = parity->count;
+        ok = leuko_str_arr_push(&parity->names, &names_count, name->valuestring) && leuko_str_arr_push(&parity->files, &parity->count, resolved);
+        const cJSON *offense;
+        cJSON_ArrayForEach(offense, cJSON_GetObjectItemCaseSensitive(file, "offenses"))
+        {
+            const cJSON *cop = cJSON_GetObjectItemCaseSensitive(offense, "cop_name");
+            const cJSON *location = cJSON_GetObjectItemCaseSensitive(offense, "location");
+            const cJSON *line = cJSON_GetObjectItemCaseSensitive(location, "start_line");
+            const cJSON *column = cJSON_GetObjectItemCaseSensitive(location, "start_column");
+            if (!ok || !cJSON_IsString(cop) || !cJSON_IsNumber(line) || !cJSON_IsNumber(column))
+            {
+                continue;
+            }
+            leuko_rule_id_t id = leuko_parity_rule_id(parity, cop->valuestring);
+            ok = id < LEUKO_RULE_ID_COUNT ? leuko_parity_list_push(&parity->expected[id], index, line->valueint, (uint32_t)column->valueint)
+                                          : leuko_parity_skip(parity, cop->valuestring);
+        }
+    }
+    cJSON_Delete(root);
+    return ok;
+}
+
+/**
+ * @brief Runner callback: keep the offenses of a file and format its result.
+ */
+static void leuko_parity_on_result(const leuko_lint_result_t *result, void *data)
+{
+    leuko_parity_pass_t *pass = data;
+    for (size_t i = 0; pass->found && i < result->diagnostics->count; ++i)
+    {
+        leuko_parity_file_t *file = &pass->found[result->file_index];
+        if (file->count == file->capacity)
+        {
+            size_t capacity = file->capacity ? file->capacity * 2 : 16;
+            leuko_parity_found_t *items = realloc(file->items, capacity * sizeof(*items));
+            if (!items)
+            {
+                pass->failed = true;
+                break;
+            }
+            file->items = items;
+            file->capacity = capacity;
+        }
+        leuko_cli_offense_t o;
+        leuko_cli_offense_load(result, (uint32_t)i, &o);
+        file->items[file->count++] = (leuko_parity_found_t){.rule = o.rule->id, .line = o.line, .column = (uint32_t)o.column};
+    }
+    leuko_cli_report_on_result(result, &pass->report);
+}
+
+static void leuko_parity_on_file_done(size_t file_index, size_t worker_index, void *data)
+{
+    leuko_parity_pass_t *pass = data;
+    leuko_cli_report_on_file_done(file_index, worker_index, &pass->report);
+}
+
+/**
+ * @brief Lint the baseline files once.
+ * @param parity Baseline
+ * @param jobs Number of threads
+ * @param sink Descriptor the formatter writes to
+ * @param found Per-file offenses are collected here (NULL: timing only)
+ * @param wall Output: time from the start of the formatter to the end of the run
+ * @return false on failure
+ */
+static bool leuko_parity_run(const leuko_parity_t *parity, size_t jobs, int sink, leuko_parity_file_t *found, uint64_t *wall)
+{
+    leuko_parity_pass_t pass = {.found = found, .failed = false};
+    leuko_runner_options_t run_opts = {
+        .jobs = jobs,
+        .fsync = false,
+        .dry_run = true,
+        .lines = NULL,
+        .engine = {
+            .cancel = NULL,
+            .stop_on_diagnostic = false,
+            .fail_level = LEUKO_SEVERITY_REFACTOR,
+            .fix_mode = LEUKO_FIX_MODE_NONE,
+            .enabled = NULL,
+        },
+        .on_result = leuko_parity_on_result,
+        .on_file_done = leuko_parity_on_file_done,
+        .data = &pass,
+    };
+    uint64_t start = leuko_clock_ns();
+    if (!leuko_cli_report_begin(&pass.report, LEUKO_CLI_FORMATTER_JSON, parity->files, parity->count, leuko_runner_jobs(&run_opts, parity->count), sink))
+    {
+        fprintf(stderr, "leuko_parity: could not start the formatter\n");
+        return false;
+    }
+    leuko_runner_stats_t stats;
+    bool ok = leuko_runner_run(parity->files, parity->count, &run_opts, &stats);
+    ok = leuko_cli_report_end(&pass.report) && ok;
+    *wall = leuko_clock_ns() - start;
+    if (stats.files_linted != parity->count)
+    {
+        fprintf(stderr, "leuko_parity: %zu of %zu files could not be linted\n", parity->count - stats.files_linted, parity->count);
+        ok = false;
+    }
+    return ok && !pass.failed;
+}
+
+/**
+ * @brief Append the differences of one cop as a table row and examples.
+ * @param out Report
+ * @param parity Results
+ * @param id Rule
+ * @param examples Maximum number of differences listed
+ * @param json JSON array element (otherwise a table row)
+ * @param differences Incremented by the number of differences
+ * @return false on allocation failure
+ * @note Both lists are sorted in place.
+ */
+static bool leuko_parity_append_cop(leuko_output_buffer_t *out, leuko_parity_t *parity, leuko_rule_id_t id, size_t examples, bool json, bool first,
+                                    size_t *differences)
+{
+    leuko_parity_list_t *expected = &parity->expected[id];
+    leuko_parity_list_t *actual = &parity->actual[id];
+    if (expected->count > 1)
+    {
+        qsort(expected->items, expected->count, sizeof(leuko_parity_offense_t), leuko_parity_compare);
+    }
+    if (actual->count > 1)
+    {
+        qsort(actual->items, actual->count, sizeof(leuko_parity_offense_t), leuko_parity_compare);
+    }
+    size_t matched = 0;
+    for (size_t e = 0, a = 0; e < expected->count && a < actual->count;)
+    {
+        int cmp = leuko_parity_compare(&expected->items[e], &actual->items[a]);
+        matched += cmp == 0;
+        e += cmp <= 0;
+        a += cmp >= 0;
+    }
+    size_t missing = expected->count - matched;
+    size_t extra = actual->count - matched;
+    *differences += missing + extra;
+    const leuko_rule_info_t *info = leuko_rule_info(id);
+    bool ok;
+    if (json)
+    {
+        ok = leuko_output_buffer_printf(out, "%s{\"cop\":\"%s/%s\",\"rubocop\":%zu,\"leukocyte\":%zu,\"matched\":%zu,\"missing\":%zu,\"extra\":%zu,\"differences\":[",
+                                        first ? "" : ",", info->category, info->name, expected->count, actual->count, matched, missing, extra);
+    }
+    else
+    {
+        char cop[128];
+        snprintf(cop, sizeof(cop), "%s/%s", info->category, info->name);
+        ok = leuko_output_buffer_printf(out, "  %-44s %8zu %9zu %8zu %8zu %8zu\n", cop, expected->count, actual->count, matched, missing, extra);
+    }
+
+    /* walk the lists again to list the first differences */
+    size_t listed = 0;
+    for (size_t e = 0, a = 0; ok && listed < examples && (e < expected->count || a < actual->count);)
+    {
+        int cmp = e == expected->count ? 1 : a == actual->count ? -1 : leuko_parity_compare(&expected->items[e], &actual->items[a]);
+        if (cmp == 0)
+        {
+            ++e;
+            ++a;
+            continue;
+        }
+        const leuko_parity_offense_t *o = cmp < 0 ? &expected->items[e++] : &actual->items[a++];
+        const char *kind = cmp < 0 ? "missing" : "extra";
+        const char *name = parity->names[o->file];
+        if (json)
+        {
+            ok = leuko_output_buffer_printf(out, "%s{\"kind\":\"%s\",\"path\":", listed ? "," : "", kind) && leuko_json_append_string(out, name, strlen(name)) &&
+                 leuko_output_buffer_printf(out, ",\"line\":%d,\"column\":%u}", o->line, o->column);
+        }
+        else
+        {
+            ok = leuko_output_buffer_printf(out, "      %-7s %s:%d:%u\n", kind, name, o->line, o->column);
+        }
+        ++listed;
+    }
+    return ok && (!json || leuko_output_buffer_puts(out, "]}"));
+}
+
+static int leuko_parity_compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void leuko_parity_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options] BASELINE.json\n"
+            "  -n, --repeat N        timed runs (default 3)\n"
+            "  -j, --jobs N          threads (default 1, as RuboCop without --parallel; 0: one per CPU)\n"
+            "  -e, --examples N      differences listed per cop (default %d)\n"
+            "  -o, --output FILE     write the report to FILE (default stdout)\n"
+            "      --json            print JSON instead of a table\n"
+            "      --report-only     exit 0 even when offenses differ\n"
+            "Record a baseline with scripts/record_rubocop_baseline.rb. Exits 1 when\n"
+            "an implemented cop reports different offenses than RuboCop.\n",
+            prog, LEUKO_PARITY_DEFAULT_EXAMPLES);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t repeat = 3;
+    size_t jobs = 1;
+    size_t examples = LEUKO_PARITY_DEFAULT_EXAMPLES;
+    const char *output = NULL;
+    bool json = false;
+    bool report_only = false;
+    static const struct option long_options[] = {
+        {"repeat", required_argument, NULL, 'n'}, {"jobs", required_argument, NULL, 'j'},    {"examples", required_argument, NULL, 'e'},
+        {"output", required_argument, NULL, 'o'}, {"json", no_argument, NULL, 'J'},          {"report-only", no_argument, NULL, 'r'},
+        {"help", no_argument, NULL, 'h'},         {NULL, 0, NULL, 0},
+    };
+    int c;
+    while ((c = getopt_long(argc, argv, "n:j:e:o:h", long_options, NULL)) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            repeat = strtoul(optarg, NULL, 10);
+            break;
+        case 'j':
+            jobs = strtoul(optarg, NULL, 10);
+            break;
+        case 'e':
+            examples = strtoul(optarg, NULL, 10);
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        case 'J':
+            json = true;
+            break;
+        case 'r':
+            report_only = true;
+            break;
+        case 'h':
+            leuko_parity_usage(argv[0]);
+            return 0;
+        default:
+            leuko_parity_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (optind + 1 != argc || repeat == 0)
+    {
+        leuko_parity_usage(argv[0]);
+        return 2;
+    }
+
+    leuko_parity_t *parity = calloc(1, sizeof(*parity));
+    if (!parity)
+    {
+        return 1;
+    }
+    size_t rule_count = 0;
+    const leuko_rule_t *const *rules = leuko_rules_all(&rule_count);
+    for (size_t i = 0; i < rule_count; ++i)
+    {
+        parity->implemented[rules[i]->id] = true;
+    }
+    bool ok = leuko_parity_load(argv[optind], parity);
+    int sink = open("/dev/null", O_WRONLY);
+    int fd = output ? open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644) : STDOUT_FILENO;
+    if (sink < 0 || fd < 0)
+    {
+        perror(sink < 0 ? "/dev/null" : output);
+        ok = false;
+    }
+
+    /* the first run collects the offenses, every run is timed */
+    leuko_parity_file_t *found = ok ? calloc(parity->count ? parity->count : 1, sizeof(*found)) : NULL;
+    uint64_t *walls = ok ? calloc(repeat, sizeof(uint64_t)) : NULL;
+    ok = ok && found && walls;
+    for (size_t r = 0; r < repeat && ok; ++r)
+    {
+        ok = leuko_parity_run(parity, jobs, sink, r == 0 ? found : NULL, &walls[r]);
+    }
+    for (size_t f = 0; ok && f < parity->count; ++f)
+    {
+        for (size_t i = 0; i < found[f].count && ok; ++i)
+        {
+            const leuko_parity_found_t *o = &found[f].items[i];
+            ok = leuko_parity_list_push(&parity->actual[o->rule], (uint32_t)f, o->line, o->column);
+        }
+    }
+
+    leuko_output_buffer_t out;
+    leuko_output_buffer_init(&out);
+    size_t differences = 0;
+    size_t compared = 0;
+    if (ok)
+    {
+        qsort(walls, repeat, sizeof(walls[0]), leuko_parity_compare_u64);
+        double leuko_ms = walls[(repeat - 1) / 2] / 1e6;
+        double speedup = parity->rubocop_ms > 0 && leuko_ms > 0 ? parity->rubocop_ms / leuko_ms : 0;
+        if (json)
+        {
+            ok = leuko_output_buffer_puts(&out, "{\"rubocop_version\":") &&
+                 leuko_json_append_string(&out, parity->rubocop_version, strlen(parity->rubocop_version)) &&
+                 leuko_output_buffer_printf(&out, ",\"files\":%zu,\"cops\":[", parity->count);
+        }
+        else
+        {
+            ok = leuko_output_buffer_printf(&out, "Parity with RuboCop %s on %zu files\n  %-44s %8s %9s %8s %8s %8s\n",
+                                            parity->rubocop_version[0] ? parity->rubocop_version : "(unknown version)", parity->count, "cop", "rubocop",
+                                            "leukocyte", "matched", "missing", "extra");
+        }
+        for (leuko_rule_id_t id = 0; id < LEUKO_RULE_ID_COUNT && ok; ++id)
+        {
+            /* cops neither tool reported agree trivially */
+            if (parity->implemented[id] && (parity->expected[id].count > 0 || parity->actual[id].count > 0))
+            {
+                ok = leuko_parity_append_cop(&out, parity, id, examples, json, compared == 0, &differences);
+                ++compared;
+            }
+        }
+        if (ok && json)
+        {
+            ok = leuko_output_buffer_printf(&out,
+                                            "],\"differences\":%zu,\"not_implemented\":{\"cops\":%zu,\"offenses\":%zu},"
+                                            "\"rubocop_ms\":%.3f,\"leukocyte_ms\":%.3f,\"runs\":%zu,\"jobs\":%zu,\"speedup\":%.2f}\n",
+                                            differences, parity->skipped_cop_count, parity->skipped_offenses, parity->rubocop_ms, leuko_ms, repeat, jobs, speedup);
+        }
+        else if (ok)
+        {
+            ok = leuko_output_buffer_printf(&out, "%zu differences over %zu cops with offenses; not implemented: %zu offenses of %zu cops\n", differences,
+                                            compared, parity->skipped_offenses, parity->skipped_cop_count) &&
+                 leuko_output_buffer_printf(&out, "Time: rubocop %.1f ms (recorded), leukocyte %.1f ms (median of %zu runs, %zu jobs)", parity->rubocop_ms,
+                                            leuko_ms, repeat, jobs) &&
+                 (speedup > 0 ? leuko_output_buffer_printf(&out, ": %.1fx\n", speedup) : leuko_output_buffer_puts(&out, "\n"));
+        }
+        ok = ok && leuko_output_write_all(fd, out.data, out.len);
+    }
+
+    leuko_output_buffer_free(&out);
+    for (size_t f = 0; found && f < parity->count; ++f)
+    {
+        free(found[f].items);
+    }
+    free(found);
+    free(walls);
+    for (size_t i = 0; i < LEUKO_RULE_ID_COUNT; ++i)
+    {
+        free(parity->expected[i].items);
+        free(parity->actual[i].items);
+    }
+    for (size_t i = 0; i < parity->count; ++i)
+    {
+        free(parity->files[i]);
+        free(parity->names[i]);
+    }
+    for (size_t i = 0; i < parity->skipped_cop_count; ++i)
+    {
+        free(parity->skipped_cops[i]);
+    }
+    free(parity->files);
+    free(parity->names);
+    free(parity->skipped_cops);
+    free(parity);
+    if (sink >= 0)
+    {
+        close(sink);
+    }
+    if (output && fd >= 0)
+    {
+        close(fd);
+    }
+    if (!ok)
+    {
+        return 2;
+    }
+    return differences > 0 && !report_only ? 1 : 0;
+}
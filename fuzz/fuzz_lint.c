@@ -0,0 +1,190 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "engine/engine.h"
+#include "utils/clock.h"
+#include "utils/file.h"
+
+/*
+ * Fuzz target for the lint pipeline.
+ *
+ * One input goes through the engine's in-memory entry point with every rule
+ * enabled in unsafe correcting mode: rule planning, the correction rounds
+ * (incremental re-lints and carried offsets included) and the change map
+ * are the ones a real run exercises. Nothing is written back.
+ *
+ * Built with clang (LEUKO_FUZZ_LIBFUZZER) this is a libFuzzer target.
+ * Otherwise `main` lints each file named on the command line, or stdin,
+ * which is what AFL expects (`afl-fuzz -i seeds -o out -- leuko_fuzz @@`).
+ *
+ * Slow inputs: an input that takes at least LEUKO_FUZZ_SLOW_FLOOR_NS is
+ * linted again twice over. Linear processing takes about twice as long;
+ * taking more than LEUKO_FUZZ_SLOW_RATIO times that (confirmed by a second
+ * measurement) aborts, so the fuzzer keeps the input as a crash. Both can
+ * be changed through the environment variables of the same name.
+ */
+
+#ifndef LEUKO_FUZZ_SLOW_FLOOR_NS
+#define LEUKO_FUZZ_SLOW_FLOOR_NS 1000000ull
+#endif
+
+#ifndef LEUKO_FUZZ_SLOW_RATIO
+#define LEUKO_FUZZ_SLOW_RATIO 4.0
+#endif
+
+static uint64_t leuko_fuzz_slow_floor = LEUKO_FUZZ_SLOW_FLOOR_NS;
+static double leuko_fuzz_slow_ratio = LEUKO_FUZZ_SLOW_RATIO;
+
+/**
+ * @brief Lint one input and apply its corrections.
+ * @param data Input (copied, so that reads past its end are caught)
+ * @param size Input size
+ * @return Time taken (ns)
+ */
+static uint64_t leuko_fuzz_lint(const uint8_t *data, size_t size)
+{
+    uint64_t start = leuko_clock_ns();
+    uint8_t *source = malloc(size ? size : 1);
+    if (!source)
+    {
+        return 0;
+    }
+    memcpy(source, data, size);
+
+    leuko_engine_options_t opts = {
+        .cancel = NULL,
+        .stop_on_diagnostic = false,
+        .fail_level = LEUKO_SEVERITY_REFACTOR,
+        .fix_mode = LEUKO_FIX_MODE_UNSAFE,
+        .enabled = NULL,
+        .profiles = NULL,
+        .trace = NULL,
+        .full_relint = false,
+    };
+    leuko_lint_job_t job = {.path = "<fuzz input>", .file_index = 0, .worker_index = 0, .write_back = NULL, .lines = NULL};
+    leuko_diagnostic_buffer_t diagnostics;
+    leuko_diagnostic_buffer_init(&diagnostics);
+    leuko_engine_lint_buffer(&job, &opts, source, size, &diagnostics, NULL, NULL);
+    leuko_diagnostic_buffer_free(&diagnostics);
+    return leuko_clock_ns() - start;
+}
+
+/**
+ * @brief Time the input repeated twice (with a newline in between).
+ */
+static uint64_t leuko_fuzz_lint_doubled(const uint8_t *data, size_t size)
+{
+    uint8_t *doubled = malloc(size * 2 + 1);
+    if (!doubled)
+    {
+        return 0;
+    }
+    memcpy(doubled, data, size);
+    doubled[size] = '\n';
+    memcpy(doubled + size + 1, data, size);
+    uint64_t ns = leuko_fuzz_lint(doubled, size * 2 + 1);
+    free(doubled);
+    return ns;
+}
+
+/**
+ * @brief Abort when doubling a slow input more than doubles its time.
+ * @param data Input
+ * @param size Input size
+ * @param ns Time the input took
+ */
+static void leuko_fuzz_check_slow(const uint8_t *data, size_t size, uint64_t ns)
+{
+    if (ns < leuko_fuzz_slow_floor || size == 0)
+    {
+        return;
+    }
+    uint64_t doubled = leuko_fuzz_lint_doubled(data, size);
+    if (doubled <= 2.0 * leuko_fuzz_slow_ratio * ns)
+    {
+        return;
+    }
+    /* measure again before blaming the input for a scheduling hiccup */
+    ns = leuko_fuzz_lint(data, size);
+    doubled = leuko_fuzz_lint_doubled(data, size);
+    if (doubled <= 2.0 * leuko_fuzz_slow_ratio * ns)
+    {
+        return;
+    }
+    fprintf(stderr, "leuko_fuzz: superlinear input: %zu bytes took %.3f ms, twice over %.3f ms (%.1fx, limit %.1fx)\n", size, ns / 1e6, doubled / 1e6,
+            (double)doubled / ns, 2.0 * leuko_fuzz_slow_ratio);
+    abort();
+}
+
+/**
+ * @brief Read the slow-input settings once.
+ */
+int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    (void)argc;
+    (void)argv;
+    const char *floor = getenv("LEUKO_FUZZ_SLOW_FLOOR_NS");
+    const char *ratio = getenv("LEUKO_FUZZ_SLOW_RATIO");
+    if (floor && *floor)
+    {
+        leuko_fuzz_slow_floor = strtoull(floor, NULL, 10);
+    }
+    if (ratio && *ratio && strtod(ratio, NULL) > 0)
+    {
+        leuko_fuzz_slow_ratio = strtod(ratio, NULL);
+    }
+    return 0;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    uint64_t ns = leuko_fuzz_lint(data, size);
+    leuko_fuzz_check_slow(data, size, ns);
+    return 0;
+}
+
+#ifndef LEUKO_FUZZ_LIBFUZZER
+int main(int argc, char *argv[])
+{
+    LLVMFuzzerInitialize(&argc, &argv);
+    if (argc < 2)
+    {
+        uint8_t *data = NULL;
+        size_t size = 0;
+        size_t capacity = 0;
+        size_t n;
+        do
+        {
+            if (size == capacity)
+            {
+                capacity = capacity ? capacity * 2 : 65536;
+                uint8_t *grown = realloc(data, capacity);
+                if (!grown)
+                {
+                    free(data);
+                    return 1;
+                }
+                data = grown;
+            }
+            n = fread(data + size, 1, capacity - size, stdin);
+            size += n;
+        } while (n > 0);
+        LLVMFuzzerTestOneInput(data, size);
+        free(data);
+        return 0;
+    }
+    for (int i = 1; i < argc; ++i)
+    {
+        uint8_t *data = NULL;
+        size_t size = 0;
+        if (!leuko_file_read_all(argv[i], &data, &size))
+        {
+            fprintf(stderr, "%s: could not read file\n", argv[i]);
+            return 1;
+        }
+        LLVMFuzzerTestOneInput(data, size);
+        free(data);
+    }
+    return 0;
+}
+#endif
@@ -2,7 +2,12 @@
 #define INCLUDE_CLI_FORMATTER_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include "engine/engine.h"
+#include "output/output_buffer.h"
+#include "output/output_writer.h"
+#include "rules/rule.h"
 
 /* clang-format off */
 #define LEUKO_CLI_FORMATTER_NAME_PROGRESS        "progress"
@@ -22,6 +27,7 @@
 #define LEUKO_CLI_FORMATTER_NAME_MARKDOWN        "markdown"
 #define LEUKO_CLI_FORMATTER_NAME_TAP             "tap"
 #define LEUKO_CLI_FORMATTER_NAME_GITHUB_ACTIONS  "github"
+#define LEUKO_CLI_FORMATTER_NAME_DIFF            "diff"
 /* clang-format on */
 
 /* CLI output formatter enum. */
@@ -44,8 +50,100 @@ typedef enum leuko_cli_formatter_e
     LEUKO_CLI_FORMATTER_MARKDOWN,
     LEUKO_CLI_FORMATTER_TAP,
     LEUKO_CLI_FORMATTER_GITHUB_ACTIONS,
+    LEUKO_CLI_FORMATTER_DIFF,
 } leuko_cli_formatter_t;
 
+/**
+ * @brief Counts gathered while reporting.
+ * @note Each worker keeps its own copy; they are merged once all workers are done.
+ */
+typedef struct leuko_cli_report_stats_s
+{
+    size_t files_inspected;                   /* files that were linted */
+    size_t files_with_offenses;               /* files with at least one offense */
+    size_t offenses;                          /* total number of offenses */
+    size_t corrected;                         /* offenses fixed by autocorrect */
+    size_t rule_counts[LEUKO_RULE_ID_COUNT];  /* offenses per rule */
+} leuko_cli_report_stats_t;
+
+/**
+ * @brief One diagnostic with its position resolved for display.
+ * @note The message is not part of the view; render it with
+ *       `leuko_cli_offense_message` only where it is printed.
+ */
+typedef struct leuko_cli_offense_s
+{
+    uint32_t index;              /* index in the diagnostic buffer */
+    const leuko_rule_t *rule;    /* reporting rule */
+    leuko_severity_t severity;   /* severity */
+    bool corrected;              /* fixed by autocorrect */
+    int32_t line;                /* first line (1-based) */
+    size_t column;               /* first column (1-based, in characters) */
+    int32_t last_line;           /* last line (1-based) */
+    size_t last_column;          /* column of the last character (1-based) */
+    size_t length;               /* length of the range in characters */
+    const uint8_t *begin;        /* start of the range */
+    const uint8_t *end;          /* end of the range (exclusive) */
+    const uint8_t *line_start;   /* start of the first line */
+    const uint8_t *line_end;     /* end of the first line (without newline) */
+} leuko_cli_offense_t;
+
+typedef struct leuko_cli_report_s leuko_cli_report_t;
+
+/**
+ * @brief Formatter callbacks.
+ * @note `begin` and `end` run on the main thread before the workers start and
+ *       after they have finished. `file` runs on a worker thread once per file,
+ *       in any order; `out` is written in file order while the run is in
+ *       progress and `deferred` is handed back to `end` in file order.
+ *       Callbacks may be NULL.
+ */
+typedef struct leuko_cli_formatter_ops_s
+{
+    bool (*begin)(leuko_cli_report_t *report, leuko_output_buffer_t *out);
+    bool (*file)(leuko_cli_report_t *report, const leuko_lint_result_t *result, const uint32_t *order, leuko_output_buffer_t *out,
+                 leuko_output_buffer_t *deferred);
+    bool (*end)(leuko_cli_report_t *report, const leuko_output_buffer_t *deferred, leuko_output_buffer_t *out);
+} leuko_cli_formatter_ops_t;
+
+/**
+ * @brief Per-worker reporting state.
+ */
+typedef struct leuko_cli_report_worker_s
+{
+    leuko_output_buffer_t out;      /* output of the current file */
+    leuko_output_buffer_t deferred; /* end-of-run output of the current file */
+    leuko_cli_report_stats_t stats; /* counts of the files handled by this worker */
+    bool has_result;                /* the current file produced a result */
+    bool failed;                    /* a formatter callback failed */
+} leuko_cli_report_worker_t;
+
+/**
+ * @brief State of one formatted run.
+ */
+struct leuko_cli_report_s
+{
+    leuko_cli_formatter_t formatter;      /* selected formatter */
+    const leuko_cli_formatter_ops_t *ops; /* its callbacks */
+    char *const *files;                   /* files of the run, in output order */
+    size_t files_count;                   /* number of files */
+    int fd;                               /* destination file descriptor */
+    size_t workers_count;                 /* number of workers */
+    leuko_cli_report_worker_t *workers;   /* per-worker state */
+    uint32_t *file_offenses;              /* offenses per file, indexed by file index */
+    leuko_output_writer_t *writer;        /* ordered writer */
+    leuko_cli_report_stats_t totals;      /* merged counts (valid in `end`) */
+};
+
 bool leuko_cli_formatter_from_string(const char *str, leuko_cli_formatter_t *out);
 
+bool leuko_cli_report_begin(leuko_cli_report_t *report, leuko_cli_formatter_t formatter, char *const *files, size_t files_count, size_t workers_count, int fd);
+void leuko_cli_report_on_result(const leuko_lint_result_t *result, void *data);
+void leuko_cli_report_on_file_done(size_t file_index, size_t worker_index, void *data);
+bool leuko_cli_report_end(leuko_cli_report_t *report);
+
+void leuko_cli_offense_load(const leuko_lint_result_t *result, uint32_t index, leuko_cli_offense_t *out);
+size_t leuko_cli_offense_message(const leuko_lint_result_t *result, const leuko_cli_offense_t *offense, char *out, size_t out_size);
+const char *leuko_cli_offense_status(const leuko_cli_offense_t *offense);
+
 #endif /* INCLUDE_CLI_FORMATTER_H */
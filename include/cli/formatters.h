@@ -0,0 +1,42 @@
+#ifndef INCLUDE_CLI_FORMATTERS_H
+#define INCLUDE_CLI_FORMATTERS_H
+
+#include "cli/formatter.h"
+
+/* Plain text formatters (src/cli/formatters/text.c) */
+extern const leuko_cli_formatter_ops_t leuko_cli_formatter_progress_ops;
+extern const leuko_cli_formatter_ops_t leuko_cli_formatter_auto_gen_ops;
+extern const leuko_cli_formatter_ops_t leuko_cli_formatter_clang_ops;
+extern const leuko_cli_formatter_ops_t leuko_cli_formatter_fuubar_ops;
+extern const leuko_cli_formatter_ops_t leuko_cli_formatter_pacman_ops;
+extern const leuko_cli_formatter_ops_t leuko_cli_formatter_emacs_ops;
+extern const leuko_cli_formatter_ops_t leuko_cli_formatter_simple_ops;
+extern const leuko_cli_formatter_ops_t leuko_cli_formatter_quiet_ops;
+extern const leuko_cli_formatter_ops_t leuko_cli_formatter_file_list_ops;
+extern const leuko_cli_formatter_ops_t leuko_cli_formatter_tap_ops;
+extern const leuko_cli_formatter_ops_t leuko_cli_formatter_github_ops;
+extern const leuko_cli_formatter_ops_t leuko_cli_formatter_offense_count_ops;
+extern const leuko_cli_formatter_ops_t leuko_cli_formatter_worst_offenders_ops;
+
+/* Document formatters (src/cli/formatters/report.c) */
+extern const leuko_cli_formatter_ops_t leuko_cli_formatter_markdown_ops;
+extern const leuko_cli_formatter_ops_t leuko_cli_formatter_html_ops;
+extern const leuko_cli_formatter_ops_t leuko_cli_formatter_junit_ops;
+
+/* JSON formatter (src/cli/formatters/json.c) */
+extern const leuko_cli_formatter_ops_t leuko_cli_formatter_json_ops;
+
+/* Unified diff of the corrections (src/cli/formatters/diff.c) */
+extern const leuko_cli_formatter_ops_t leuko_cli_formatter_diff_ops;
+
+/**
+ * @brief Size of the stack buffer formatters render one message into.
+ */
+#define LEUKO_CLI_MESSAGE_MAX 512
+
+size_t leuko_cli_utf8_length(const uint8_t *begin, const uint8_t *end);
+bool leuko_cli_render_summary(const leuko_cli_report_t *report, leuko_output_buffer_t *out);
+bool leuko_cli_render_source_line(const leuko_cli_offense_t *offense, const char *prefix, leuko_output_buffer_t *out);
+bool leuko_cli_render_clang_offenses(const leuko_lint_result_t *result, const uint32_t *order, leuko_output_buffer_t *out);
+
+#endif /* INCLUDE_CLI_FORMATTERS_H */
@@ -4,6 +4,9 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include "cli/formatter.h"
+#include "common/fix_mode.h"
+#include "common/severity.h"
+#include "engine/profile.h"
 
 /**
  * @brief Result of parsing CLI options.
@@ -15,33 +18,31 @@ typedef enum leuko_parse_result_e
     LEUKO_CLI_OPTIONS_PARSE_ERROR,   /* invalid options or parse error */
 } leuko_parse_result_t;
 
-/**
- * @brief Fix mode enumeration.
- */
-typedef enum leuko_fix_mode_e
-{
-    LEUKO_FIX_MODE_NONE,   /* fix none */
-    LEUKO_FIX_MODE_SAFE,   /* fix safe */
-    LEUKO_FIX_MODE_UNSAFE, /* fix all */
-} leuko_fix_mode_t;
-
 /**
  * @brief Command line options structure.
  */
 typedef struct leuko_cli_options_s
 {
-    char **paths;                    /* paths to analyze */
-    size_t paths_count;              /* number of paths */
-    char *config_path;               /* path to configuration file */
-    leuko_cli_formatter_t formatter; /* formatter to use */
-    char **only;                     /* only rules to apply */
-    size_t only_count;               /* number of only rules */
-    char **except;                   /* rules to exclude */
-    size_t except_count;             /* number of except rules */
-    leuko_fix_mode_t fix_mode;       /* fix mode */
-    bool parallel;                   /* run analysis in parallel */
-    bool init;                       /* initialize .leukocyte */
-    bool sync;                       /* sync config */
+    char **paths;                               /* paths to analyze */
+    size_t paths_count;                         /* number of paths */
+    char *config_path;                          /* path to configuration file */
+    leuko_cli_formatter_t formatter;            /* formatter to use */
+    char **only;                                /* only rules to apply */
+    size_t only_count;                          /* number of only rules */
+    char **except;                              /* rules to exclude */
+    size_t except_count;                        /* number of except rules */
+    leuko_fix_mode_t fix_mode;                  /* fix mode */
+    bool fsync;                                 /* sync corrected files to disk */
+    char *changed_since;                        /* only lint files changed since this git revision */
+    bool changed_lines;                         /* only report offenses on changed lines (needs changed_since) */
+    bool parallel;                              /* run analysis in parallel */
+    leuko_severity_t fail_level;                /* minimum severity that makes the run fail */
+    bool exit_code_only;                        /* no output, stop at the first failing diagnostic */
+    bool profile_rules;                         /* print per-rule timings to stderr after the run */
+    leuko_rule_profile_format_t profile_format; /* format of the rule timings */
+    char *trace_path;                           /* write a Chrome trace of the run here (NULL: no trace) */
+    bool init;                                  /* initialize .leukocyte */
+    bool sync;                                  /* sync config */
 } leuko_cli_options_t;
 
 leuko_parse_result_t leuko_cli_options_parse(int argc, char *argv[], leuko_cli_options_t *opts);
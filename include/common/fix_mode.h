@@ -0,0 +1,14 @@
+#ifndef LEUKOCYTE_COMMON_FIX_MODE_H
+#define LEUKOCYTE_COMMON_FIX_MODE_H
+
+/**
+ * @brief Fix mode enumeration.
+ */
+typedef enum leuko_fix_mode_e
+{
+    LEUKO_FIX_MODE_NONE,   /* fix none */
+    LEUKO_FIX_MODE_SAFE,   /* fix safe */
+    LEUKO_FIX_MODE_UNSAFE, /* fix all */
+} leuko_fix_mode_t;
+
+#endif /* LEUKOCYTE_COMMON_FIX_MODE_H */
@@ -1,7 +1,9 @@
 #ifndef LEUKOCYTE_COMMON_RULE_REGISTRY_H
 #define LEUKOCYTE_COMMON_RULE_REGISTRY_H
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /* Category names */
 /* clang-format off */
@@ -22,14 +24,14 @@
 #define LEUKO_RULE_NAME_CLASS_STRUCTURE                                "ClassStructure"
 #define LEUKO_RULE_NAME_CLOSING_HEREDOC_INDENTATION                    "ClosingHeredocIndentation"
 #define LEUKO_RULE_NAME_CLOSING_PARENTHESIS_INDENTATION                "ClosingParenthesisIndentation"
-#define LEUKO_RULE_NAME_commont_INDENTATION                            "commontIndentation"
+#define LEUKO_RULE_NAME_COMMENT_INDENTATION                            "CommentIndentation"
 #define LEUKO_RULE_NAME_CONDITION_POSITION                             "ConditionPosition"
 #define LEUKO_RULE_NAME_DEF_END_ALIGNMENT                              "DefEndAlignment"
 #define LEUKO_RULE_NAME_DOT_POSITION                                   "DotPosition"
 #define LEUKO_RULE_NAME_ELSE_ALIGNMENT                                 "ElseAlignment"
-#define LEUKO_RULE_NAME_EMPTY_commont                                  "Emptycommont"
+#define LEUKO_RULE_NAME_EMPTY_COMMENT                                  "EmptyComment"
 #define LEUKO_RULE_NAME_EMPTY_LINE_AFTER_GUARD_CLAUSE                  "EmptyLineAfterGuardClause"
-#define LEUKO_RULE_NAME_EMPTY_LINE_AFTER_MAGIC_commont                 "EmptyLineAfterMagiccommont"
+#define LEUKO_RULE_NAME_EMPTY_LINE_AFTER_MAGIC_COMMENT                 "EmptyLineAfterMagicComment"
 #define LEUKO_RULE_NAME_EMPTY_LINE_AFTER_MULTILINE_CONDITION           "EmptyLineAfterMultilineCondition"
 #define LEUKO_RULE_NAME_EMPTY_LINE_BETWEEN_DEFS                        "EmptyLineBetweenDefs"
 #define LEUKO_RULE_NAME_EMPTY_LINES                                    "EmptyLines"
@@ -62,7 +64,7 @@
 #define LEUKO_RULE_NAME_INDENTATION_WIDTH                              "IndentationWidth"
 #define LEUKO_RULE_NAME_LINE_LENGTH                                    "LineLength"
 #define LEUKO_RULE_NAME_INITIAL_INDENTATION                            "InitialIndentation"
-#define LEUKO_RULE_NAME_LEADING_commont_SPACE                          "LeadingcommontSpace"
+#define LEUKO_RULE_NAME_LEADING_COMMENT_SPACE                          "LeadingCommentSpace"
 #define LEUKO_RULE_NAME_LEADING_EMPTY_LINES                            "LeadingEmptyLines"
 #define LEUKO_RULE_NAME_LINE_CONTINUATION_LEADING_SPACE                "LineContinuationLeadingSpace"
 #define LEUKO_RULE_NAME_LINE_CONTINUATION_SPACING                      "LineContinuationSpacing"
@@ -96,7 +98,7 @@
 #define LEUKO_RULE_NAME_SPACE_BEFORE_BLOCK_BRACES                      "SpaceBeforeBlockBraces"
 #define LEUKO_RULE_NAME_SPACE_BEFORE_BRACKETS                          "SpaceBeforeBrackets"
 #define LEUKO_RULE_NAME_SPACE_BEFORE_COMMA                             "SpaceBeforeComma"
-#define LEUKO_RULE_NAME_SPACE_BEFORE_commont                           "SpaceBeforecommont"
+#define LEUKO_RULE_NAME_SPACE_BEFORE_COMMENT                           "SpaceBeforeComment"
 #define LEUKO_RULE_NAME_SPACE_BEFORE_FIRST_ARG                         "SpaceBeforeFirstArg"
 #define LEUKO_RULE_NAME_SPACE_BEFORE_SEMICOLON                         "SpaceBeforeSemicolon"
 #define LEUKO_RULE_NAME_SPACE_IN_LAMBDA_LITERAL                        "SpaceInLambdaLiteral"
@@ -113,4 +115,160 @@
 #define LEUKO_RULE_NAME_TRAILING_WHITESPACE                            "TrailingWhitespace"
 /* clang-format on */
 
+/**
+ * @brief Rule identifier.
+ * @note Small integer index into the rule registry (see `enum leuko_rule_id_e`).
+ */
+typedef uint16_t leuko_rule_id_t;
+
+/* Rule ids, in the same order as the rule names above */
+enum leuko_rule_id_e
+{
+    LEUKO_RULE_ID_ACCESS_MODIFIER_INDENTATION,
+    LEUKO_RULE_ID_ARGUMENT_ALIGNMENT,
+    LEUKO_RULE_ID_ARRAY_ALIGNMENT,
+    LEUKO_RULE_ID_ASSIGNMENT_INDENTATION,
+    LEUKO_RULE_ID_BEGIN_END_ALIGNMENT,
+    LEUKO_RULE_ID_BLOCK_ALIGNMENT,
+    LEUKO_RULE_ID_BLOCK_END_NEWLINE,
+    LEUKO_RULE_ID_CASE_INDENTATION,
+    LEUKO_RULE_ID_CLASS_STRUCTURE,
+    LEUKO_RULE_ID_CLOSING_HEREDOC_INDENTATION,
+    LEUKO_RULE_ID_CLOSING_PARENTHESIS_INDENTATION,
+    LEUKO_RULE_ID_COMMENT_INDENTATION,
+    LEUKO_RULE_ID_CONDITION_POSITION,
+    LEUKO_RULE_ID_DEF_END_ALIGNMENT,
+    LEUKO_RULE_ID_DOT_POSITION,
+    LEUKO_RULE_ID_ELSE_ALIGNMENT,
+    LEUKO_RULE_ID_EMPTY_COMMENT,
+    LEUKO_RULE_ID_EMPTY_LINE_AFTER_GUARD_CLAUSE,
+    LEUKO_RULE_ID_EMPTY_LINE_AFTER_MAGIC_COMMENT,
+    LEUKO_RULE_ID_EMPTY_LINE_AFTER_MULTILINE_CONDITION,
+    LEUKO_RULE_ID_EMPTY_LINE_BETWEEN_DEFS,
+    LEUKO_RULE_ID_EMPTY_LINES,
+    LEUKO_RULE_ID_EMPTY_LINES_AFTER_MODULE_INCLUSION,
+    LEUKO_RULE_ID_EMPTY_LINES_AROUND_ACCESS_MODIFIER,
+    LEUKO_RULE_ID_EMPTY_LINES_AROUND_ARGUMENTS,
+    LEUKO_RULE_ID_EMPTY_LINES_AROUND_ATTRIBUTE_ACCESSOR,
+    LEUKO_RULE_ID_EMPTY_LINES_AROUND_BEGIN_BODY,
+    LEUKO_RULE_ID_EMPTY_LINES_AROUND_BLOCK_BODY,
+    LEUKO_RULE_ID_EMPTY_LINES_AROUND_CLASS_BODY,
+    LEUKO_RULE_ID_EMPTY_LINES_AROUND_EXCEPTION_HANDLING_KEYWORDS,
+    LEUKO_RULE_ID_EMPTY_LINES_AROUND_METHOD_BODY,
+    LEUKO_RULE_ID_EMPTY_LINES_AROUND_MODULE_BODY,
+    LEUKO_RULE_ID_END_ALIGNMENT,
+    LEUKO_RULE_ID_END_OF_LINE,
+    LEUKO_RULE_ID_EXTRA_SPACING,
+    LEUKO_RULE_ID_FIRST_ARGUMENT_INDENTATION,
+    LEUKO_RULE_ID_FIRST_ARRAY_ELEMENT_INDENTATION,
+    LEUKO_RULE_ID_FIRST_ARRAY_ELEMENT_LINE_BREAK,
+    LEUKO_RULE_ID_FIRST_HASH_ELEMENT_INDENTATION,
+    LEUKO_RULE_ID_FIRST_HASH_ELEMENT_LINE_BREAK,
+    LEUKO_RULE_ID_FIRST_METHOD_ARGUMENT_LINE_BREAK,
+    LEUKO_RULE_ID_FIRST_METHOD_PARAMETER_LINE_BREAK,
+    LEUKO_RULE_ID_FIRST_PARAMETER_INDENTATION,
+    LEUKO_RULE_ID_HASH_ALIGNMENT,
+    LEUKO_RULE_ID_HEREDOC_ARGUMENT_CLOSING_PARENTHESIS,
+    LEUKO_RULE_ID_HEREDOC_INDENTATION,
+    LEUKO_RULE_ID_INDENTATION_CONSISTENCY,
+    LEUKO_RULE_ID_INDENTATION_STYLE,
+    LEUKO_RULE_ID_INDENTATION_WIDTH,
+    LEUKO_RULE_ID_LINE_LENGTH,
+    LEUKO_RULE_ID_INITIAL_INDENTATION,
+    LEUKO_RULE_ID_LEADING_COMMENT_SPACE,
+    LEUKO_RULE_ID_LEADING_EMPTY_LINES,
+    LEUKO_RULE_ID_LINE_CONTINUATION_LEADING_SPACE,
+    LEUKO_RULE_ID_LINE_CONTINUATION_SPACING,
+    LEUKO_RULE_ID_LINE_END_STRING_CONCATENATION_INDENTATION,
+    LEUKO_RULE_ID_MULTILINE_ARRAY_BRACE_LAYOUT,
+    LEUKO_RULE_ID_MULTILINE_ARRAY_LINE_BREAKS,
+    LEUKO_RULE_ID_MULTILINE_ASSIGNMENT_LAYOUT,
+    LEUKO_RULE_ID_MULTILINE_BLOCK_LAYOUT,
+    LEUKO_RULE_ID_MULTILINE_HASH_BRACE_LAYOUT,
+    LEUKO_RULE_ID_MULTILINE_HASH_KEY_LINE_BREAKS,
+    LEUKO_RULE_ID_MULTILINE_METHOD_ARGUMENT_LINE_BREAKS,
+    LEUKO_RULE_ID_MULTILINE_METHOD_CALL_BRACE_LAYOUT,
+    LEUKO_RULE_ID_MULTILINE_METHOD_CALL_INDENTATION,
+    LEUKO_RULE_ID_MULTILINE_METHOD_DEFINITION_BRACE_LAYOUT,
+    LEUKO_RULE_ID_MULTILINE_METHOD_PARAMETER_LINE_BREAKS,
+    LEUKO_RULE_ID_MULTILINE_OPERATION_INDENTATION,
+    LEUKO_RULE_ID_PARAMETER_ALIGNMENT,
+    LEUKO_RULE_ID_REDUNDANT_LINE_BREAK,
+    LEUKO_RULE_ID_RESCUE_ENSURE_ALIGNMENT,
+    LEUKO_RULE_ID_SINGLE_LINE_BLOCK_CHAIN,
+    LEUKO_RULE_ID_SPACE_AFTER_COLON,
+    LEUKO_RULE_ID_SPACE_AFTER_COMMA,
+    LEUKO_RULE_ID_SPACE_AFTER_METHOD_NAME,
+    LEUKO_RULE_ID_SPACE_AFTER_NOT,
+    LEUKO_RULE_ID_SPACE_AFTER_SEMICOLON,
+    LEUKO_RULE_ID_SPACE_AROUND_BLOCK_PARAMETERS,
+    LEUKO_RULE_ID_SPACE_AROUND_EQUALS_IN_PARAMETER_DEFAULT,
+    LEUKO_RULE_ID_SPACE_AROUND_KEYWORD,
+    LEUKO_RULE_ID_SPACE_AROUND_METHOD_CALL_OPERATOR,
+    LEUKO_RULE_ID_SPACE_AROUND_OPERATORS,
+    LEUKO_RULE_ID_SPACE_BEFORE_BLOCK_BRACES,
+    LEUKO_RULE_ID_SPACE_BEFORE_BRACKETS,
+    LEUKO_RULE_ID_SPACE_BEFORE_COMMA,
+    LEUKO_RULE_ID_SPACE_BEFORE_COMMENT,
+    LEUKO_RULE_ID_SPACE_BEFORE_FIRST_ARG,
+    LEUKO_RULE_ID_SPACE_BEFORE_SEMICOLON,
+    LEUKO_RULE_ID_SPACE_IN_LAMBDA_LITERAL,
+    LEUKO_RULE_ID_SPACE_INSIDE_ARRAY_LITERAL_BRACKETS,
+    LEUKO_RULE_ID_SPACE_INSIDE_ARRAY_PERCENT_LITERAL,
+    LEUKO_RULE_ID_SPACE_INSIDE_BLOCK_BRACES,
+    LEUKO_RULE_ID_SPACE_INSIDE_HASH_LITERAL_BRACES,
+    LEUKO_RULE_ID_SPACE_INSIDE_PARENS,
+    LEUKO_RULE_ID_SPACE_INSIDE_PERCENT_LITERAL_DELIMITERS,
+    LEUKO_RULE_ID_SPACE_INSIDE_RANGE_LITERAL,
+    LEUKO_RULE_ID_SPACE_INSIDE_REFERENCE_BRACKETS,
+    LEUKO_RULE_ID_SPACE_INSIDE_STRING_INTERPOLATION,
+    LEUKO_RULE_ID_TRAILING_EMPTY_LINES,
+    LEUKO_RULE_ID_TRAILING_WHITESPACE,
+    LEUKO_RULE_ID_COUNT,
+};
+
+/**
+ * @brief Cheapest input a rule can make its decision from.
+ * @note Ordered by cost: a file whose enabled rules all stop short of
+ *       LEUKO_RULE_INPUT_AST is never parsed.
+ */
+typedef enum leuko_rule_input_e
+{
+    LEUKO_RULE_INPUT_BYTES,  /* the whole source buffer; offenses may depend on any byte of it */
+    LEUKO_RULE_INPUT_LINES,  /* the line table; offenses depend only on the lines they cover */
+    LEUKO_RULE_INPUT_TOKENS, /* the token stream of the built-in lexer */
+    LEUKO_RULE_INPUT_AST,    /* Prism nodes of the subscribed types */
+} leuko_rule_input_t;
+
+/**
+ * @brief What the engine needs to know about a rule to schedule it.
+ * @note Covers every registry id, implemented or not.
+ */
+typedef struct leuko_rule_info_s
+{
+    leuko_rule_id_t id;          /* registry id (the index of the entry) */
+    const char *category;        /* category name (e.g. "Layout") */
+    const char *name;            /* rule name (e.g. "TrailingWhitespace") */
+    leuko_rule_input_t input;    /* input needed */
+    const uint16_t *node_types;  /* Prism node types the rule is called for (AST input only) */
+    size_t node_type_count;      /* number of node types */
+    bool autocorrectable;        /* offenses can be corrected */
+    bool safe_autocorrect;       /* corrections are applied by `-a` (otherwise only by `-A`) */
+} leuko_rule_info_t;
+
+/**
+ * @brief Registry entries indexed by rule id.
+ */
+extern const leuko_rule_info_t leuko_rule_registry[LEUKO_RULE_ID_COUNT];
+
+/**
+ * @brief Look up the registry entry of a rule.
+ * @param id Rule registry id (below LEUKO_RULE_ID_COUNT)
+ * @return Registry entry
+ */
+static inline const leuko_rule_info_t *leuko_rule_info(leuko_rule_id_t id)
+{
+    return &leuko_rule_registry[id];
+}
+
 #endif /* LEUKOCYTE_COMMON_RULE_REGISTRY_H */
@@ -0,0 +1,72 @@
+#ifndef LEUKOCYTE_COMMON_RULE_SET_H
+#define LEUKOCYTE_COMMON_RULE_SET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "common/registry.h"
+
+/**
+ * @brief Number of 64-bit words in a rule set.
+ */
+#define LEUKO_RULE_SET_WORDS ((LEUKO_RULE_ID_COUNT + 63) / 64)
+
+/**
+ * @brief Set of rules, one bit per registry id.
+ */
+typedef struct leuko_rule_set_s
+{
+    uint64_t words[LEUKO_RULE_SET_WORDS];
+} leuko_rule_set_t;
+
+/**
+ * @brief Check whether a rule is in a set.
+ * @param set Rule set
+ * @param id Rule registry id
+ * @return true if the rule is in the set
+ */
+static inline bool leuko_rule_set_has(const leuko_rule_set_t *set, leuko_rule_id_t id)
+{
+    return (set->words[id / 64] >> (id % 64)) & 1u;
+}
+
+/**
+ * @brief Add a rule to a set.
+ * @param set Rule set
+ * @param id Rule registry id
+ */
+static inline void leuko_rule_set_add(leuko_rule_set_t *set, leuko_rule_id_t id)
+{
+    set->words[id / 64] |= (uint64_t)1 << (id % 64);
+}
+
+/**
+ * @brief Add every rule of another set.
+ * @param set Rule set
+ * @param other Rules to add
+ */
+static inline void leuko_rule_set_union(leuko_rule_set_t *set, const leuko_rule_set_t *other)
+{
+    for (size_t i = 0; i < LEUKO_RULE_SET_WORDS; ++i)
+    {
+        set->words[i] |= other->words[i];
+    }
+}
+
+/**
+ * @brief Remove every rule of another set.
+ * @param set Rule set
+ * @param other Rules to remove
+ */
+static inline void leuko_rule_set_remove(leuko_rule_set_t *set, const leuko_rule_set_t *other)
+{
+    for (size_t i = 0; i < LEUKO_RULE_SET_WORDS; ++i)
+    {
+        set->words[i] &= ~other->words[i];
+    }
+}
+
+/* Generated at build time by tools/gen_rule_names.c */
+bool leuko_rule_set_add_name(leuko_rule_set_t *set, const char *name, size_t len);
+
+#endif /* LEUKOCYTE_COMMON_RULE_SET_H */
@@ -25,4 +25,18 @@ typedef enum leuko_severity_e
     LEUKO_SEVERITY_FATAL,
 } leuko_severity_t;
 
+/**
+ * @brief Single-letter severity code used by RuboCop formatters.
+ * @param severity Severity level
+ * @return Code character (I, R, C, W, E, F)
+ */
+static inline char leuko_severity_code(leuko_severity_t severity)
+{
+    static const char codes[] = {'I', 'R', 'C', 'W', 'E', 'F'};
+    return ((unsigned)severity < sizeof(codes)) ? codes[severity] : '?';
+}
+
+bool leuko_severity_from_string(const char *str, leuko_severity_t *out);
+const char *leuko_severity_to_string(leuko_severity_t severity);
+
 #endif /* LEUKOCYTE_CONFIGS_SEVERITY_H */
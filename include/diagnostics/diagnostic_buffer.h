@@ -0,0 +1,125 @@
+#ifndef LEUKO_DIAGNOSTICS_DIAGNOSTIC_BUFFER_H
+#define LEUKO_DIAGNOSTICS_DIAGNOSTIC_BUFFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "common/registry.h"
+#include "common/severity.h"
+
+/**
+ * @brief Maximum number of message arguments per diagnostic.
+ */
+#define LEUKO_DIAGNOSTIC_ARG_MAX 2
+
+/**
+ * @brief Diagnostic flags.
+ */
+#define LEUKO_DIAGNOSTIC_FLAG_CORRECTED 0x01 /* fixed by autocorrect */
+#define LEUKO_DIAGNOSTIC_FLAG_HAS_EDIT  0x02 /* a correction was proposed (it may have been dropped as conflicting) */
+
+/**
+ * @brief Index of a message template within its rule.
+ */
+typedef uint8_t leuko_message_id_t;
+
+/**
+ * @brief Per-worker diagnostic sink with a structure-of-arrays layout.
+ * @note All columns live in a single allocation that grows geometrically, so
+ *       appending a diagnostic never allocates on its own. Line, column and
+ *       message text are not stored; they are resolved at format time from the
+ *       offsets via `leuko_processed_source_pos_info` and from the rule's
+ *       message template plus the stored arguments.
+ */
+typedef struct leuko_diagnostic_buffer_s
+{
+    leuko_rule_id_t *rule_ids;       /* registry index of the reporting rule */
+    uint8_t *severities;             /* leuko_severity_t narrowed to a byte */
+    leuko_message_id_t *message_ids; /* template index within the rule */
+    uint8_t *flags;                  /* LEUKO_DIAGNOSTIC_FLAG_* bits */
+    int32_t *args;                   /* LEUKO_DIAGNOSTIC_ARG_MAX message arguments per diagnostic */
+    uint32_t *begin_offsets;         /* byte offset of the start of the range */
+    uint32_t *end_offsets;           /* byte offset of the end of the range (exclusive) */
+    size_t count;                    /* number of diagnostics */
+    size_t capacity;                 /* number of slots allocated per column */
+    void *block;                     /* backing allocation for all columns */
+} leuko_diagnostic_buffer_t;
+
+void leuko_diagnostic_buffer_init(leuko_diagnostic_buffer_t *buf);
+bool leuko_diagnostic_buffer_reserve(leuko_diagnostic_buffer_t *buf, size_t capacity);
+bool leuko_diagnostic_buffer_grow(leuko_diagnostic_buffer_t *buf);
+void leuko_diagnostic_buffer_clear(leuko_diagnostic_buffer_t *buf);
+bool leuko_diagnostic_buffer_sorted_order(const leuko_diagnostic_buffer_t *buf, uint32_t **out_order);
+void leuko_diagnostic_buffer_free(leuko_diagnostic_buffer_t *buf);
+
+/**
+ * @brief Append a diagnostic to the buffer.
+ * @param buf Pointer to the diagnostic buffer
+ * @param rule_id Rule registry id
+ * @param severity Severity of the diagnostic
+ * @param message_id Message template index within the rule
+ * @param begin_offset Start byte offset
+ * @param end_offset End byte offset (exclusive)
+ * @param arg0 First message argument (ignored by templates without arguments)
+ * @param arg1 Second message argument
+ * @return true on success, false on allocation failure
+ */
+static inline bool leuko_diagnostic_buffer_push(leuko_diagnostic_buffer_t *buf, leuko_rule_id_t rule_id, leuko_severity_t severity, leuko_message_id_t message_id,
+                                                size_t begin_offset, size_t end_offset, int32_t arg0, int32_t arg1)
+{
+    if (buf->count == buf->capacity && !leuko_diagnostic_buffer_grow(buf))
+    {
+        return false;
+    }
+    size_t i = buf->count++;
+    buf->rule_ids[i] = rule_id;
+    buf->severities[i] = (uint8_t)severity;
+    buf->begin_offsets[i] = (uint32_t)begin_offset;
+    buf->end_offsets[i] = (uint32_t)end_offset;
+    buf->message_ids[i] = message_id;
+    buf->flags[i] = 0;
+    buf->args[i * LEUKO_DIAGNOSTIC_ARG_MAX] = arg0;
+    buf->args[i * LEUKO_DIAGNOSTIC_ARG_MAX + 1] = arg1;
+    return true;
+}
+
+/**
+ * @brief Copy one diagnostic from another buffer.
+ * @param buf Destination buffer
+ * @param src Source buffer
+ * @param index Index of the diagnostic in `src`
+ * @return true on success, false on allocation failure
+ */
+static inline bool leuko_diagnostic_buffer_push_from(leuko_diagnostic_buffer_t *buf, const leuko_diagnostic_buffer_t *src, size_t index)
+{
+    const int32_t *args = &src->args[index * LEUKO_DIAGNOSTIC_ARG_MAX];
+    if (!leuko_diagnostic_buffer_push(buf, src->rule_ids[index], (leuko_severity_t)src->severities[index], src->message_ids[index], src->begin_offsets[index],
+                                      src->end_offsets[index], args[0], args[1]))
+    {
+        return false;
+    }
+    buf->flags[buf->count - 1] = src->flags[index];
+    return true;
+}
+
+/**
+ * @brief Copy a diagnostic over another slot of the same buffer.
+ * @param buf Pointer to the diagnostic buffer
+ * @param to Index to overwrite
+ * @param from Index to copy
+ */
+static inline void leuko_diagnostic_buffer_move(leuko_diagnostic_buffer_t *buf, size_t to, size_t from)
+{
+    buf->rule_ids[to] = buf->rule_ids[from];
+    buf->severities[to] = buf->severities[from];
+    buf->message_ids[to] = buf->message_ids[from];
+    buf->flags[to] = buf->flags[from];
+    buf->begin_offsets[to] = buf->begin_offsets[from];
+    buf->end_offsets[to] = buf->end_offsets[from];
+    for (size_t a = 0; a < LEUKO_DIAGNOSTIC_ARG_MAX; ++a)
+    {
+        buf->args[to * LEUKO_DIAGNOSTIC_ARG_MAX + a] = buf->args[from * LEUKO_DIAGNOSTIC_ARG_MAX + a];
+    }
+}
+
+#endif /* LEUKO_DIAGNOSTICS_DIAGNOSTIC_BUFFER_H */
@@ -0,0 +1,9 @@
+#ifndef LEUKO_DIAGNOSTICS_MESSAGE_H
+#define LEUKO_DIAGNOSTICS_MESSAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+size_t leuko_message_render(const char *tmpl, const int32_t *args, size_t arg_count, char *out, size_t out_size);
+
+#endif /* LEUKO_DIAGNOSTICS_MESSAGE_H */
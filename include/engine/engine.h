@@ -0,0 +1,90 @@
+#ifndef LEUKO_ENGINE_ENGINE_H
+#define LEUKO_ENGINE_ENGINE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "common/fix_mode.h"
+#include "common/rule_set.h"
+#include "common/severity.h"
+#include "diagnostics/diagnostic_buffer.h"
+#include "engine/profile.h"
+#include "engine/trace.h"
+#include "engine/write_back.h"
+#include "quickfix/change_map.h"
+#include "utils/git_diff.h"
+#include "sources/processed_source.h"
+
+/**
+ * @brief One unit of work: a file and where it is being processed.
+ */
+typedef struct leuko_lint_job_s
+{
+    const char *path;               /* file path */
+    size_t file_index;              /* index of the file in the run (output order) */
+    size_t worker_index;            /* index of the worker thread linting the file */
+    leuko_write_back_t *write_back; /* where corrected files are written (NULL: keep corrections in memory) */
+    const leuko_line_set_t *lines;  /* only offenses touching these lines are reported (NULL: all) */
+} leuko_lint_job_t;
+
+/**
+ * @brief Result of linting one file.
+ * @note Only valid for the duration of the result callback: the processed
+ *       source and the source bytes are released right after it returns.
+ *       When autocorrecting, positions refer to the corrected source and
+ *       corrected offenses carry LEUKO_DIAGNOSTIC_FLAG_CORRECTED.
+ */
+typedef struct leuko_lint_result_s
+{
+    const char *path;                             /* file path */
+    size_t file_index;                            /* index of the file in the run */
+    size_t worker_index;                          /* index of the worker thread */
+    leuko_processed_source_t *ps;                 /* line table for position lookups */
+    const leuko_diagnostic_buffer_t *diagnostics; /* diagnostics of this file */
+    const uint8_t *original;                      /* source as read (the processed source when nothing was corrected) */
+    size_t original_len;                          /* number of bytes in original */
+    const leuko_change_map_t *changes;            /* corrections as ranges of original (NULL if they could not be tracked) */
+} leuko_lint_result_t;
+
+/**
+ * @brief Callback invoked once per linted file.
+ */
+typedef void (*leuko_lint_result_fn)(const leuko_lint_result_t *result, void *data);
+
+/**
+ * @brief Options controlling how a file is linted.
+ */
+typedef struct leuko_engine_options_s
+{
+    int *cancel;                     /* shared cancellation flag, set by any worker (may be NULL) */
+    bool stop_on_diagnostic;         /* set *cancel as soon as a diagnostic at or above fail_level is reported */
+    leuko_severity_t fail_level;     /* minimum severity that counts as a failure */
+    leuko_fix_mode_t fix_mode;       /* autocorrect offenses and write the files back */
+    const leuko_rule_set_t *enabled; /* rules to run (NULL: all) */
+    leuko_rule_profile_t *profiles;  /* per-rule timings, one per worker (NULL: not profiled) */
+    leuko_trace_t *trace;            /* timeline of the run, one ring per worker (NULL: not traced) */
+    bool full_relint;                /* parse and check the whole source after every correction round (no incremental pass) */
+} leuko_engine_options_t;
+
+/**
+ * @brief Maximum number of lint passes per file when autocorrecting.
+ * @note Same limit as RuboCop; reaching it means two corrections keep undoing
+ *       each other.
+ */
+#define LEUKO_ENGINE_MAX_CORRECTION_PASSES 200
+
+/**
+ * @brief Check whether shared work has been cancelled.
+ * @param opts Engine options
+ * @return true if remaining work should be skipped
+ */
+static inline bool leuko_engine_cancelled(const leuko_engine_options_t *opts)
+{
+    return opts->cancel && __atomic_load_n(opts->cancel, __ATOMIC_RELAXED);
+}
+
+bool leuko_engine_lint_file(const leuko_lint_job_t *job, const leuko_engine_options_t *opts, leuko_diagnostic_buffer_t *diagnostics, leuko_lint_result_fn on_result, void *data);
+bool leuko_engine_lint_buffer(const leuko_lint_job_t *job, const leuko_engine_options_t *opts, uint8_t *source, size_t source_len, leuko_diagnostic_buffer_t *diagnostics,
+                              leuko_lint_result_fn on_result, void *data);
+bool leuko_engine_has_failure(const leuko_diagnostic_buffer_t *diagnostics, size_t from, leuko_severity_t fail_level);
+
+#endif /* LEUKO_ENGINE_ENGINE_H */
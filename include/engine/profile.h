@@ -0,0 +1,41 @@
+#ifndef LEUKO_ENGINE_PROFILE_H
+#define LEUKO_ENGINE_PROFILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "common/registry.h"
+#include "output/output_buffer.h"
+
+/**
+ * @brief Time spent in one rule.
+ */
+typedef struct leuko_rule_profile_entry_s
+{
+    uint64_t ns;       /* wall time inside the rule's entry point */
+    uint64_t calls;    /* entry point calls (one per node or token for AST and token input rules) */
+    uint64_t offenses; /* offenses reported (every autocorrect pass counts) */
+} leuko_rule_profile_entry_t;
+
+/**
+ * @brief Per-rule timings, indexed by registry id.
+ * @note Each worker fills its own profile; they are merged once all workers are done.
+ */
+typedef struct leuko_rule_profile_s
+{
+    leuko_rule_profile_entry_t rules[LEUKO_RULE_ID_COUNT];
+} leuko_rule_profile_t;
+
+/**
+ * @brief Output format of a rule profile.
+ */
+typedef enum leuko_rule_profile_format_e
+{
+    LEUKO_RULE_PROFILE_TABLE,
+    LEUKO_RULE_PROFILE_JSON,
+} leuko_rule_profile_format_t;
+
+void leuko_rule_profile_merge(leuko_rule_profile_t *into, const leuko_rule_profile_t *from);
+bool leuko_rule_profile_render(const leuko_rule_profile_t *profile, leuko_rule_profile_format_t format, leuko_output_buffer_t *out);
+
+#endif /* LEUKO_ENGINE_PROFILE_H */
@@ -0,0 +1,43 @@
+#ifndef LEUKO_ENGINE_RUNNER_H
+#define LEUKO_ENGINE_RUNNER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "engine/engine.h"
+
+/**
+ * @brief Callback invoked after every claimed file, whether or not it could be linted.
+ */
+typedef void (*leuko_runner_file_done_fn)(size_t file_index, size_t worker_index, void *data);
+
+/**
+ * @brief Options for linting a set of files.
+ */
+typedef struct leuko_runner_options_s
+{
+    size_t jobs;                            /* number of worker threads (0: one per CPU) */
+    leuko_engine_options_t engine;          /* per-file options (cancel is managed by the runner) */
+    bool fsync;                             /* sync corrected files to disk (in batches per worker) */
+    bool dry_run;                           /* keep corrections in memory: no file is written */
+    const leuko_line_set_t *const *lines;   /* per-file lines to report, indexed like the files (NULL: all lines) */
+    leuko_lint_result_fn on_result;         /* per-file callback, called from worker threads (may be NULL) */
+    leuko_runner_file_done_fn on_file_done; /* called from worker threads after each claimed file (may be NULL) */
+    void *data;                             /* user data for the callbacks */
+} leuko_runner_options_t;
+
+/**
+ * @brief Aggregate results of a run.
+ */
+typedef struct leuko_runner_stats_s
+{
+    size_t files_linted;  /* files that were fully linted */
+    size_t diagnostics;   /* total diagnostics reported */
+    bool failed;          /* a diagnostic at or above the fail level was found */
+    bool write_failed;    /* a corrected file could not be written back */
+} leuko_runner_stats_t;
+
+size_t leuko_runner_default_jobs(void);
+size_t leuko_runner_jobs(const leuko_runner_options_t *opts, size_t files_count);
+bool leuko_runner_run(char *const *files, size_t files_count, const leuko_runner_options_t *opts, leuko_runner_stats_t *stats);
+
+#endif /* LEUKO_ENGINE_RUNNER_H */
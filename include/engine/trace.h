@@ -0,0 +1,82 @@
+#ifndef LEUKO_ENGINE_TRACE_H
+#define LEUKO_ENGINE_TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "utils/clock.h"
+
+/**
+ * @brief Number of events kept per worker (a power of two).
+ * @note Older events are overwritten once a worker has recorded more.
+ */
+#define LEUKO_TRACE_RING_EVENTS (1u << 15)
+
+/**
+ * @brief One timed span of work.
+ */
+typedef struct leuko_trace_event_s
+{
+    const char *name; /* stage name (static string) */
+    const char *file; /* file being processed (NULL: none); must outlive the trace */
+    uint64_t start;   /* clock reading at the start (ns) */
+    uint64_t end;     /* clock reading at the end (ns) */
+} leuko_trace_event_t;
+
+/**
+ * @brief Events of one worker.
+ * @note Only the owning worker writes to its ring and the rings are only
+ *       read once the workers are done, so recording takes no lock and no
+ *       atomic operation.
+ */
+typedef struct leuko_trace_ring_s
+{
+    leuko_trace_event_t *events; /* LEUKO_TRACE_RING_EVENTS slots */
+    uint64_t recorded;           /* events recorded so far (the last LEUKO_TRACE_RING_EVENTS are kept) */
+} leuko_trace_ring_t;
+
+/**
+ * @brief Timeline of a run, one ring per worker.
+ */
+typedef struct leuko_trace_s
+{
+    leuko_trace_ring_t *rings; /* indexed by worker */
+    size_t ring_count;         /* number of workers */
+    uint64_t origin;           /* clock reading at the start of the run (ns) */
+} leuko_trace_t;
+
+/**
+ * @brief Start timing a span.
+ * @param ring Ring of the current worker (NULL: not traced)
+ * @return Clock reading, or 0 when not traced
+ */
+static inline uint64_t leuko_trace_begin(const leuko_trace_ring_t *ring)
+{
+    return ring ? leuko_clock_ns() : 0;
+}
+
+/**
+ * @brief Record a span that started at `start`.
+ * @param ring Ring of the current worker (NULL: not traced)
+ * @param name Stage name (static string)
+ * @param file File being processed (may be NULL)
+ * @param start Value returned by `leuko_trace_begin`
+ */
+static inline void leuko_trace_end(leuko_trace_ring_t *ring, const char *name, const char *file, uint64_t start)
+{
+    if (!ring)
+    {
+        return;
+    }
+    leuko_trace_event_t *event = &ring->events[ring->recorded++ & (LEUKO_TRACE_RING_EVENTS - 1)];
+    event->name = name;
+    event->file = file;
+    event->start = start;
+    event->end = leuko_clock_ns();
+}
+
+bool leuko_trace_init(leuko_trace_t *trace, size_t ring_count);
+bool leuko_trace_write(const leuko_trace_t *trace, const char *path);
+void leuko_trace_free(leuko_trace_t *trace);
+
+#endif /* LEUKO_ENGINE_TRACE_H */
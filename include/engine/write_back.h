@@ -0,0 +1,45 @@
+#ifndef LEUKO_ENGINE_WRITE_BACK_H
+#define LEUKO_ENGINE_WRITE_BACK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Number of synced files renamed into place together.
+ */
+#define LEUKO_WRITE_BACK_BATCH 64
+
+/**
+ * @brief Temporary file waiting to be synced and renamed over its target.
+ */
+typedef struct leuko_write_back_pending_s
+{
+    int fd;       /* open descriptor of the temporary file */
+    char *tmp;    /* path of the temporary file */
+    char *target; /* path it replaces */
+} leuko_write_back_pending_t;
+
+/**
+ * @brief Per-worker stage writing corrected files back.
+ * @note Every worker owns one, so files are written concurrently without a
+ *       shared writer. Files are replaced atomically (temporary file plus
+ *       rename) and only when their bytes changed. With `sync`, temporary
+ *       files are collected and flushed in batches: all of them are synced,
+ *       then renamed, then their directories are synced, so the disk waits
+ *       overlap instead of adding up per file.
+ */
+typedef struct leuko_write_back_s
+{
+    bool sync;                                                /* fsync files and directories */
+    leuko_write_back_pending_t pending[LEUKO_WRITE_BACK_BATCH]; /* files written but not renamed yet */
+    size_t count;                                             /* number of pending files */
+    size_t written;                                           /* files replaced so far */
+    size_t failed;                                            /* files that could not be replaced (or their directory synced) */
+} leuko_write_back_t;
+
+void leuko_write_back_init(leuko_write_back_t *wb, bool sync);
+bool leuko_write_back_file(leuko_write_back_t *wb, const char *path, const uint8_t *original, size_t original_len, const uint8_t *data, size_t len);
+bool leuko_write_back_flush(leuko_write_back_t *wb);
+
+#endif /* LEUKO_ENGINE_WRITE_BACK_H */
@@ -1,22 +1,116 @@
 /*
  * leuko_debug.h
- * Minimal declarations expected by vendor Prism sources.
+ * Leveled, category-tagged logging, also used by vendor Prism sources
+ * (through `LDEBUG` and `leuko_debug_log`).
  */
 
 #ifndef LEUKO_DEBUG_H
 #define LEUKO_DEBUG_H
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /* Diagnostic counters (defined in diagnostic_debug_stub.c or equivalent) */
 extern size_t g_diag_created;
 extern size_t g_diag_freed;
 
-/* Debug logging hook provided by the project. */
+/* clang-format off */
+#define LEUKO_LOG_LEVEL_OFF   0
+#define LEUKO_LOG_LEVEL_ERROR 1
+#define LEUKO_LOG_LEVEL_WARN  2
+#define LEUKO_LOG_LEVEL_INFO  3
+#define LEUKO_LOG_LEVEL_DEBUG 4
+#define LEUKO_LOG_LEVEL_TRACE 5
+/* clang-format on */
+
+/**
+ * @brief Highest level compiled in.
+ * @note Calls above it expand to nothing: their arguments are not even
+ *       evaluated. Set with `-DLEUKO_LOG_LEVEL=<0-5>` (CMake option of the
+ *       same name); defaults to warnings in release builds.
+ */
+#ifndef LEUKO_LOG_LEVEL
+#ifdef NDEBUG
+#define LEUKO_LOG_LEVEL LEUKO_LOG_LEVEL_WARN
+#else
+#define LEUKO_LOG_LEVEL LEUKO_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+/**
+ * @brief Subsystem a message comes from.
+ */
+typedef enum leuko_log_category_e
+{
+    LEUKO_LOG_GENERAL, /* anything else */
+    LEUKO_LOG_PRISM,   /* vendor Prism (`LDEBUG`) */
+    LEUKO_LOG_ENGINE,  /* engine and runner */
+    LEUKO_LOG_RULES,   /* rules */
+    LEUKO_LOG_CLI,     /* command line and formatters */
+    LEUKO_LOG_IO,      /* files, git and output */
+    LEUKO_LOG_CATEGORY_COUNT,
+} leuko_log_category_t;
+
+/* Messages at or below this level, from categories in the mask, are printed */
+extern int leuko_log_level;
+extern uint32_t leuko_log_categories;
+
+/**
+ * @brief Check whether a message would be printed.
+ * @param level Message level
+ * @param category Message category
+ * @return true if the runtime settings let it through
+ */
+static inline bool leuko_log_enabled(int level, leuko_log_category_t category)
+{
+    return level <= __atomic_load_n(&leuko_log_level, __ATOMIC_RELAXED) && (__atomic_load_n(&leuko_log_categories, __ATOMIC_RELAXED) >> category & 1u);
+}
+
+void leuko_log_init(void);
+void leuko_log_write(int level, leuko_log_category_t category, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+void leuko_log_flush(void);
+
+#define LEUKO_LOG(level, category, ...)                        \
+    do                                                         \
+    {                                                          \
+        if (leuko_log_enabled((level), (category)))            \
+        {                                                      \
+            leuko_log_write((level), (category), __VA_ARGS__); \
+        }                                                      \
+    } while (0)
+
+#if LEUKO_LOG_LEVEL >= LEUKO_LOG_LEVEL_ERROR
+#define LEUKO_LOG_ERROR(category, ...) LEUKO_LOG(LEUKO_LOG_LEVEL_ERROR, category, __VA_ARGS__)
+#else
+#define LEUKO_LOG_ERROR(category, ...) ((void)0)
+#endif
+#if LEUKO_LOG_LEVEL >= LEUKO_LOG_LEVEL_WARN
+#define LEUKO_LOG_WARN(category, ...) LEUKO_LOG(LEUKO_LOG_LEVEL_WARN, category, __VA_ARGS__)
+#else
+#define LEUKO_LOG_WARN(category, ...) ((void)0)
+#endif
+#if LEUKO_LOG_LEVEL >= LEUKO_LOG_LEVEL_INFO
+#define LEUKO_LOG_INFO(category, ...) LEUKO_LOG(LEUKO_LOG_LEVEL_INFO, category, __VA_ARGS__)
+#else
+#define LEUKO_LOG_INFO(category, ...) ((void)0)
+#endif
+#if LEUKO_LOG_LEVEL >= LEUKO_LOG_LEVEL_DEBUG
+#define LEUKO_LOG_DEBUG(category, ...) LEUKO_LOG(LEUKO_LOG_LEVEL_DEBUG, category, __VA_ARGS__)
+#else
+#define LEUKO_LOG_DEBUG(category, ...) ((void)0)
+#endif
+#if LEUKO_LOG_LEVEL >= LEUKO_LOG_LEVEL_TRACE
+#define LEUKO_LOG_TRACE(category, ...) LEUKO_LOG(LEUKO_LOG_LEVEL_TRACE, category, __VA_ARGS__)
+#else
+#define LEUKO_LOG_TRACE(category, ...) ((void)0)
+#endif
+
+/* Debug logging hook provided by the project (kept for vendor Prism). */
 void leuko_debug_log(const char *fmt, ...);
 
 #ifndef LDEBUG
-#define LDEBUG(...) leuko_debug_log(__VA_ARGS__)
+#define LDEBUG(...) LEUKO_LOG_DEBUG(LEUKO_LOG_PRISM, __VA_ARGS__)
 #endif
 
 #endif /* LEUKO_DEBUG_H */
@@ -0,0 +1,11 @@
+#ifndef LEUKO_OUTPUT_JSON_ESCAPE_H
+#define LEUKO_OUTPUT_JSON_ESCAPE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "output/output_buffer.h"
+
+size_t leuko_json_escape_scan(const char *s, size_t n);
+bool leuko_json_append_string(leuko_output_buffer_t *out, const char *s, size_t n);
+
+#endif /* LEUKO_OUTPUT_JSON_ESCAPE_H */
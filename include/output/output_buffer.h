@@ -0,0 +1,63 @@
+#ifndef LEUKO_OUTPUT_OUTPUT_BUFFER_H
+#define LEUKO_OUTPUT_OUTPUT_BUFFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Growable byte buffer that formatters render into.
+ * @note Each worker owns its buffers; nothing here is thread-safe.
+ */
+typedef struct leuko_output_buffer_s
+{
+    char *data; /* rendered bytes (not NUL-terminated) */
+    size_t len; /* number of bytes used */
+    size_t cap; /* number of bytes allocated */
+} leuko_output_buffer_t;
+
+void leuko_output_buffer_init(leuko_output_buffer_t *buf);
+bool leuko_output_buffer_grow(leuko_output_buffer_t *buf, size_t extra);
+bool leuko_output_buffer_puts(leuko_output_buffer_t *buf, const char *s);
+bool leuko_output_buffer_printf(leuko_output_buffer_t *buf, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+bool leuko_output_buffer_append_uint(leuko_output_buffer_t *buf, uint64_t v);
+bool leuko_output_buffer_append_repeat(leuko_output_buffer_t *buf, char c, size_t n);
+void leuko_output_buffer_detach(leuko_output_buffer_t *buf, char **data, size_t *len);
+void leuko_output_buffer_free(leuko_output_buffer_t *buf);
+
+/**
+ * @brief Append bytes to the buffer.
+ * @param buf Output buffer
+ * @param s Bytes to append
+ * @param n Number of bytes
+ * @return true on success, false on allocation failure
+ */
+static inline bool leuko_output_buffer_append(leuko_output_buffer_t *buf, const char *s, size_t n)
+{
+    if (buf->cap - buf->len < n && !leuko_output_buffer_grow(buf, n))
+    {
+        return false;
+    }
+    memcpy(buf->data + buf->len, s, n);
+    buf->len += n;
+    return true;
+}
+
+/**
+ * @brief Append one byte to the buffer.
+ * @param buf Output buffer
+ * @param c Byte to append
+ * @return true on success, false on allocation failure
+ */
+static inline bool leuko_output_buffer_putc(leuko_output_buffer_t *buf, char c)
+{
+    if (buf->len == buf->cap && !leuko_output_buffer_grow(buf, 1))
+    {
+        return false;
+    }
+    buf->data[buf->len++] = c;
+    return true;
+}
+
+#endif /* LEUKO_OUTPUT_OUTPUT_BUFFER_H */
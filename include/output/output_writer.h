@@ -0,0 +1,21 @@
+#ifndef LEUKO_OUTPUT_OUTPUT_WRITER_H
+#define LEUKO_OUTPUT_OUTPUT_WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "output/output_buffer.h"
+
+/**
+ * @brief Ordered output writer (opaque).
+ * @note Workers submit one chunk per sequence number, in any order, without
+ *       taking a lock. A dedicated thread writes chunks strictly in sequence
+ *       order, batching every contiguous run of ready chunks into `writev`.
+ */
+typedef struct leuko_output_writer_s leuko_output_writer_t;
+
+leuko_output_writer_t *leuko_output_writer_new(int fd, size_t chunk_count);
+void leuko_output_writer_submit(leuko_output_writer_t *w, size_t seq, leuko_output_buffer_t *buf, leuko_output_buffer_t *deferred);
+bool leuko_output_writer_finish(leuko_output_writer_t *w, leuko_output_buffer_t *deferred_out);
+bool leuko_output_write_all(int fd, const char *data, size_t len);
+
+#endif /* LEUKO_OUTPUT_OUTPUT_WRITER_H */
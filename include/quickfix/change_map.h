@@ -0,0 +1,42 @@
+#ifndef LEUKO_QUICKFIX_CHANGE_MAP_H
+#define LEUKO_QUICKFIX_CHANGE_MAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "quickfix/edit_list.h"
+
+/**
+ * @brief A range of the original source and the range that replaced it.
+ */
+typedef struct leuko_change_s
+{
+    uint32_t orig_begin; /* start offset in the original source */
+    uint32_t orig_end;   /* end offset in the original source (exclusive) */
+    uint32_t begin;      /* start offset in the corrected source */
+    uint32_t end;        /* end offset in the corrected source (exclusive) */
+} leuko_change_t;
+
+/**
+ * @brief Differences between the original source and its latest correction.
+ * @note Changes are sorted and disjoint; the bytes outside them are the same
+ *       in both sources. Each autocorrect pass folds its edit list in, so the
+ *       map stays proportional to the number of edits and a diff never needs
+ *       to compare whole files.
+ */
+typedef struct leuko_change_map_s
+{
+    leuko_change_t *changes; /* changes in source order */
+    size_t count;            /* number of changes */
+    size_t capacity;         /* number of changes allocated */
+    leuko_change_t *scratch; /* buffer the next fold is built in */
+    size_t scratch_cap;      /* number of changes allocated in scratch */
+} leuko_change_map_t;
+
+void leuko_change_map_init(leuko_change_map_t *map);
+bool leuko_change_map_add(leuko_change_map_t *map, const leuko_edit_list_t *edits);
+size_t leuko_change_map_original_offset(const leuko_change_map_t *map, size_t offset);
+void leuko_change_map_clear(leuko_change_map_t *map);
+void leuko_change_map_free(leuko_change_map_t *map);
+
+#endif /* LEUKO_QUICKFIX_CHANGE_MAP_H */
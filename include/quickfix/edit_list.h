@@ -0,0 +1,49 @@
+#ifndef LEUKO_QUICKFIX_EDIT_LIST_H
+#define LEUKO_QUICKFIX_EDIT_LIST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Replacement of a byte range of the source.
+ * @note Insertions have `begin == end`; deletions have an empty replacement.
+ */
+typedef struct leuko_edit_s
+{
+    uint32_t begin;       /* start offset of the replaced range */
+    uint32_t end;         /* end offset of the replaced range (exclusive) */
+    uint32_t text_offset; /* offset of the replacement in the text pool */
+    uint32_t text_len;    /* length of the replacement */
+    uint32_t group;       /* edits of one group are applied together or not at all */
+    uint32_t seq;         /* insertion order */
+} leuko_edit_t;
+
+/**
+ * @brief Per-file list of edits collected from rules.
+ * @note Rules append edits in any order. `leuko_edit_list_resolve` sorts them
+ *       and drops conflicting groups; `leuko_edit_list_apply` then rewrites the
+ *       source in one linear copy. Groups are diagnostic indices, so an
+ *       offense is either fully corrected or left for the next iteration.
+ */
+typedef struct leuko_edit_list_s
+{
+    leuko_edit_t *edits; /* edits (sorted and conflict-free after resolve) */
+    size_t count;        /* number of edits */
+    size_t capacity;     /* number of edits allocated */
+    char *text;          /* pool of replacement texts */
+    size_t text_len;     /* bytes used in the pool */
+    size_t text_cap;     /* bytes allocated for the pool */
+    int64_t *shifts;     /* after apply: total length change up to and including each edit */
+    size_t shifts_cap;   /* number of shifts allocated */
+} leuko_edit_list_t;
+
+void leuko_edit_list_init(leuko_edit_list_t *list);
+bool leuko_edit_list_push(leuko_edit_list_t *list, uint32_t group, size_t begin, size_t end, const char *text, size_t text_len);
+size_t leuko_edit_list_resolve(leuko_edit_list_t *list);
+bool leuko_edit_list_apply(leuko_edit_list_t *list, const uint8_t *source, size_t source_len, uint8_t **out, size_t *out_len);
+size_t leuko_edit_list_map_offset(const leuko_edit_list_t *list, size_t offset);
+void leuko_edit_list_clear(leuko_edit_list_t *list);
+void leuko_edit_list_free(leuko_edit_list_t *list);
+
+#endif /* LEUKO_QUICKFIX_EDIT_LIST_H */
@@ -0,0 +1,11 @@
+#ifndef LEUKO_RULES_LAYOUT_H
+#define LEUKO_RULES_LAYOUT_H
+
+#include "rules/rule.h"
+
+/* Layout rules */
+extern const leuko_rule_t leuko_rule_layout_indentation_consistency;
+extern const leuko_rule_t leuko_rule_layout_line_length;
+extern const leuko_rule_t leuko_rule_layout_trailing_whitespace;
+
+#endif /* LEUKO_RULES_LAYOUT_H */
@@ -0,0 +1,121 @@
+#ifndef LEUKO_RULES_RULE_H
+#define LEUKO_RULES_RULE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "prism.h"
+#include "common/fix_mode.h"
+#include "common/registry.h"
+#include "common/rule_set.h"
+#include "common/severity.h"
+#include "diagnostics/diagnostic_buffer.h"
+#include "quickfix/edit_list.h"
+#include "sources/lexer.h"
+#include "sources/processed_source.h"
+#include "sources/signature.h"
+
+/**
+ * @brief State shared by all rules while checking one file.
+ */
+typedef struct leuko_rule_context_s
+{
+    leuko_processed_source_t *ps;           /* line table of the file */
+    const pm_parser_t *parser;              /* parser (NULL when the file was not parsed) */
+    leuko_diagnostic_buffer_t *diagnostics; /* sink for diagnostics */
+    leuko_edit_list_t *edits;               /* sink for corrections (NULL when not correcting) */
+    leuko_fix_mode_t fix_mode;              /* corrections allowed */
+    size_t line_begin;                      /* first line index line input rules check */
+    size_t line_end;                        /* line index past the last one line input rules check */
+    bool reported;                          /* the last report was stored (corrections attach to it) */
+} leuko_rule_context_t;
+
+/**
+ * @brief Rule definition.
+ * @note The input a rule needs and the node types it is called for come
+ *       from its registry entry (`leuko_rule_info(rule->id)`).
+ */
+typedef struct leuko_rule_s
+{
+    leuko_rule_id_t id;                                                  /* registry id */
+    const char *category;                                                /* category name (e.g. "Layout") */
+    const char *name;                                                    /* rule name (e.g. "TrailingWhitespace") */
+    leuko_severity_t severity;                                           /* default severity */
+    const char *const *messages;                                         /* interned message templates, indexed by leuko_message_id_t */
+    size_t message_count;                                                /* number of message templates */
+    bool autocorrectable;                                                /* offenses can be corrected */
+    bool safe_autocorrect;                                               /* corrections are applied by `-a` (otherwise only by `-A`) */
+    uint32_t features;                                                   /* LEUKO_FEATURE_* bits; the rule only runs on files with one of them (0: always) */
+    void (*check_source)(const struct leuko_rule_s *rule, leuko_rule_context_t *ctx);                            /* entry point of byte and line input rules */
+    void (*check_token)(const struct leuko_rule_s *rule, leuko_rule_context_t *ctx, const leuko_token_t *token); /* entry point of token input rules */
+    void (*check_node)(const struct leuko_rule_s *rule, leuko_rule_context_t *ctx, const pm_node_t *node);       /* entry point of AST input rules */
+} leuko_rule_t;
+
+/**
+ * @brief Report a diagnostic for a byte range with a templated message.
+ * @param rule Reporting rule
+ * @param ctx Rule context
+ * @param message_id Index into `rule->messages`
+ * @param start Start of the range
+ * @param end End of the range (exclusive)
+ * @param arg0 First `%d` argument of the template
+ * @param arg1 Second `%d` argument of the template
+ * @return false if the diagnostic could not be stored (no correction may follow)
+ */
+static inline bool leuko_rule_report_message(const leuko_rule_t *rule, leuko_rule_context_t *ctx, leuko_message_id_t message_id, const uint8_t *start, const uint8_t *end,
+                                             int32_t arg0, int32_t arg1)
+{
+    ctx->reported = leuko_diagnostic_buffer_push(ctx->diagnostics, rule->id, rule->severity, message_id, leuko_pos_to_offset(ctx->ps, start),
+                                                 leuko_pos_to_offset(ctx->ps, end), arg0, arg1);
+    return ctx->reported;
+}
+
+/**
+ * @brief Report a diagnostic for a byte range with the rule's first message.
+ * @param rule Reporting rule
+ * @param ctx Rule context
+ * @param start Start of the range
+ * @param end End of the range (exclusive)
+ * @return false if the diagnostic could not be stored (no correction may follow)
+ */
+static inline bool leuko_rule_report(const leuko_rule_t *rule, leuko_rule_context_t *ctx, const uint8_t *start, const uint8_t *end)
+{
+    return leuko_rule_report_message(rule, ctx, 0, start, end, 0, 0);
+}
+
+/**
+ * @brief Check whether the offense just reported by a rule should be corrected.
+ * @param rule Reporting rule
+ * @param ctx Rule context
+ * @return true if corrections of this rule are wanted
+ */
+static inline bool leuko_rule_autocorrect_enabled(const leuko_rule_t *rule, const leuko_rule_context_t *ctx)
+{
+    return ctx->edits && rule->autocorrectable && (rule->safe_autocorrect ? ctx->fix_mode != LEUKO_FIX_MODE_NONE : ctx->fix_mode == LEUKO_FIX_MODE_UNSAFE);
+}
+
+/**
+ * @brief Add an edit correcting the offense reported last.
+ * @param ctx Rule context
+ * @param start Start of the replaced range
+ * @param end End of the replaced range (exclusive)
+ * @param text Replacement text
+ * @param text_len Length of the replacement
+ * @note All edits added for one offense are applied together or not at all.
+ *       Nothing is added when that report could not be stored: the edit
+ *       would belong to no offense, or to the one before it.
+ */
+static inline void leuko_rule_correct(leuko_rule_context_t *ctx, const uint8_t *start, const uint8_t *end, const char *text, size_t text_len)
+{
+    if (!ctx->reported)
+    {
+        return;
+    }
+    leuko_edit_list_push(ctx->edits, (uint32_t)(ctx->diagnostics->count - 1), leuko_pos_to_offset(ctx->ps, start), leuko_pos_to_offset(ctx->ps, end), text, text_len);
+}
+
+const leuko_rule_t *const *leuko_rules_all(size_t *count);
+bool leuko_rules_select(char *const *only, size_t only_count, char *const *except, size_t except_count, leuko_rule_set_t *out);
+const leuko_rule_t *leuko_rule_by_id(leuko_rule_id_t id);
+size_t leuko_rule_render_message(const leuko_rule_t *rule, leuko_message_id_t message_id, const int32_t *args, char *out, size_t out_size);
+
+#endif /* LEUKO_RULES_RULE_H */
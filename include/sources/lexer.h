@@ -0,0 +1,59 @@
+#ifndef LEUKO_SOURCES_LEXER_H
+#define LEUKO_SOURCES_LEXER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Per-line facts found by the lightweight lexer.
+ */
+#define LEUKO_LINE_IN_STRING 0x01u /* the line break ending the line is inside a string, symbol, regexp or command literal */
+#define LEUKO_LINE_HEREDOC   0x02u /* the line is part of a heredoc body (terminator excluded) */
+#define LEUKO_LINE_DATA      0x04u /* the line follows `__END__` */
+
+/**
+ * @brief Token kinds seen by token input rules.
+ * @note Literal contents are not tokens: a literal is reported as its
+ *       opening and closing delimiters, with the code of interpolations in
+ *       between.
+ */
+typedef enum leuko_token_type_e
+{
+    LEUKO_TOKEN_NEWLINE,       /* line break ending a line of code */
+    LEUKO_TOKEN_COMMENT,       /* `# ...` (without the line break) or a whole `=begin`/`=end` block */
+    LEUKO_TOKEN_IDENTIFIER,    /* local, method, constant, instance or global variable name */
+    LEUKO_TOKEN_KEYWORD,       /* reserved word */
+    LEUKO_TOKEN_LABEL,         /* `name:` */
+    LEUKO_TOKEN_NUMBER,        /* numeric literal */
+    LEUKO_TOKEN_CHARACTER,     /* character literal (`?a`) */
+    LEUKO_TOKEN_SYMBOL,        /* operator symbol (`:<=>`) */
+    LEUKO_TOKEN_STRING_BEGIN,  /* opening of a string, symbol, regexp, command or percent literal */
+    LEUKO_TOKEN_STRING_END,    /* closing delimiter of a literal (regexp options included) */
+    LEUKO_TOKEN_HEREDOC_BEGIN, /* heredoc opening (`<<~EOS`) */
+    LEUKO_TOKEN_HEREDOC_END,   /* heredoc terminator (without the line break) */
+    LEUKO_TOKEN_EMBEXPR_BEGIN, /* `#{` */
+    LEUKO_TOKEN_EMBEXPR_END,   /* `}` closing an interpolation */
+    LEUKO_TOKEN_PUNCTUATION,   /* one of `,;()[]{}` */
+    LEUKO_TOKEN_OPERATOR,      /* any other run of symbols */
+} leuko_token_type_t;
+
+/**
+ * @brief A token and its bytes.
+ */
+typedef struct leuko_token_s
+{
+    leuko_token_type_t type;
+    const uint8_t *start;
+    const uint8_t *end; /* exclusive */
+} leuko_token_t;
+
+/**
+ * @brief Callback receiving tokens in source order.
+ */
+typedef void (*leuko_token_fn)(const leuko_token_t *token, void *data);
+
+bool leuko_lex(const uint8_t *source, size_t len, size_t line_count, uint8_t *flags, leuko_token_fn on_token, void *data);
+bool leuko_lex_line_flags(const uint8_t *source, size_t len, size_t line_count, uint8_t *flags);
+
+#endif /* LEUKO_SOURCES_LEXER_H */
@@ -23,6 +23,7 @@ typedef struct leuko_processed_source_s
     size_t *offset2line_vals;
     size_t offset2line_cap;
     size_t offset2line_count;
+    uint8_t *line_flags; /* LEUKO_LINE_* bits per line, lexed on first use (NULL until then) */
 } leuko_processed_source_t;
 
 /**
@@ -37,11 +38,13 @@ typedef struct leuko_processed_source_pos_info_s
 } leuko_processed_source_pos_info_t;
 
 void leuko_processed_source_init_from_parser(leuko_processed_source_t *ps, const pm_parser_t *parser);
+void leuko_processed_source_init_from_source(leuko_processed_source_t *ps, const uint8_t *source, size_t source_len, int32_t start_line_number);
 int32_t leuko_processed_source_line_of_pos(const leuko_processed_source_t *ps, const uint8_t *pos);
 size_t leuko_processed_source_col_of_pos(const leuko_processed_source_t *ps, const uint8_t *pos);
 bool leuko_processed_source_begins_its_line(const leuko_processed_source_t *ps, const uint8_t *pos);
 static inline size_t leuko_pos_to_offset(const leuko_processed_source_t *ps, const uint8_t *pos) { return (size_t)(pos - ps->source_start); }
 static inline const uint8_t *leuko_offset_to_pos(const leuko_processed_source_t *ps, size_t offset) { return ps->source_start + offset; }
+const uint8_t *leuko_processed_source_line_flags(leuko_processed_source_t *ps);
 void leuko_processed_source_pos_info(leuko_processed_source_t *ps, const uint8_t *pos, leuko_processed_source_pos_info_t *out);
 void leuko_processed_source_free(leuko_processed_source_t *ps);
 
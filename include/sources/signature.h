@@ -0,0 +1,23 @@
+#ifndef LEUKO_SOURCES_SIGNATURE_H
+#define LEUKO_SOURCES_SIGNATURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Byte-level features of a source file.
+ * @note A rule lists the features it needs; when none of them is present in
+ *       a file, the rule cannot fire there and is not run. Features are
+ *       conservative: present means "may matter", absent means "cannot".
+ */
+#define LEUKO_FEATURE_INDENTED_LINE  0x01u /* a line starting with a space or tab */
+#define LEUKO_FEATURE_TRAILING_SPACE 0x02u /* a space or tab before a line break or at the end */
+#define LEUKO_FEATURE_TAB            0x04u /* a tab anywhere */
+#define LEUKO_FEATURE_CR             0x08u /* a carriage return anywhere */
+#define LEUKO_FEATURE_HEREDOC        0x10u /* `<<` followed by an identifier, a quote, `~` or `-` */
+#define LEUKO_FEATURE_RESCUE         0x20u /* the word `rescue` */
+#define LEUKO_FEATURE_ALL            0x3Fu
+
+uint32_t leuko_signature_scan(const uint8_t *source, size_t len, uint32_t wanted);
+
+#endif /* LEUKO_SOURCES_SIGNATURE_H */
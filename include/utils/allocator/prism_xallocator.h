@@ -3,6 +3,17 @@
 
 #include <stddef.h>
 
+/**
+ * @brief Allocations of the calling thread since `leuko_x_allocator_begin`.
+ */
+typedef struct leuko_x_allocator_stats_s
+{
+    size_t arena_bytes;     /* bytes taken from the arena, headers included (arena memory is only released by end) */
+    size_t arena_allocs;    /* allocations served by the arena */
+    size_t fallback_bytes;  /* bytes requested from malloc */
+    size_t fallback_allocs; /* allocations served by malloc: above the small limit, reallocations of those, or arena failures */
+} leuko_x_allocator_stats_t;
+
 void *xmalloc(size_t size);
 void *xcalloc(size_t nmemb, size_t size);
 void *xrealloc(void *ptr, size_t size);
@@ -10,5 +21,6 @@ void xfree(void *ptr);
 
 void leuko_x_allocator_begin(void);
 void leuko_x_allocator_end(void);
+void leuko_x_allocator_stats(leuko_x_allocator_stats_t *out);
 
 #endif /* PRISM_XALLOCATOR_H */
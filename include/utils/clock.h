@@ -0,0 +1,18 @@
+#ifndef LEUKO_UTIL_CLOCK_H
+#define LEUKO_UTIL_CLOCK_H
+
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * @brief Read the monotonic clock.
+ * @return Nanoseconds since an arbitrary fixed point
+ */
+static inline uint64_t leuko_clock_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+#endif /* LEUKO_UTIL_CLOCK_H */
@@ -0,0 +1,15 @@
+#ifndef LEUKO_UTIL_FILE_H
+#define LEUKO_UTIL_FILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+bool leuko_file_read_all(const char *path, uint8_t **out, size_t *out_len);
+int leuko_file_write_temp(const char *path, const uint8_t *data, size_t len, mode_t mode, char **tmp_path);
+bool leuko_file_sync_parent(const char *path);
+bool leuko_file_write_atomic(const char *path, const uint8_t *data, size_t len, mode_t mode);
+bool leuko_file_collect_ruby(char *const *paths, size_t paths_count, char ***out, size_t *out_count);
+
+#endif /* LEUKO_UTIL_FILE_H */
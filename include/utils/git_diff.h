@@ -0,0 +1,44 @@
+#ifndef LEUKO_UTIL_GIT_DIFF_H
+#define LEUKO_UTIL_GIT_DIFF_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Sorted, disjoint ranges of 1-based line numbers.
+ */
+typedef struct leuko_line_set_s
+{
+    int32_t *firsts; /* first line of each range */
+    int32_t *lasts;  /* last line of each range (inclusive) */
+    size_t count;    /* number of ranges */
+    size_t capacity; /* number of ranges allocated */
+} leuko_line_set_t;
+
+/**
+ * @brief A file changed since a revision and the lines added or modified in it.
+ */
+typedef struct leuko_git_changed_file_s
+{
+    char *path;             /* resolved path (realpath) */
+    leuko_line_set_t lines; /* changed lines, numbered in the working tree version */
+} leuko_git_changed_file_t;
+
+/**
+ * @brief Files changed since a revision (sorted by path once loaded, in diff order when parsed).
+ */
+typedef struct leuko_git_changes_s
+{
+    leuko_git_changed_file_t *files;
+    size_t count;
+    size_t capacity;
+} leuko_git_changes_t;
+
+bool leuko_line_set_intersects(const leuko_line_set_t *set, int32_t first, int32_t last);
+bool leuko_git_changes_parse(const char *diff, size_t len, leuko_git_changes_t *out);
+bool leuko_git_changes_load(const char *rev, leuko_git_changes_t *out);
+const leuko_git_changed_file_t *leuko_git_changes_find(const leuko_git_changes_t *changes, const char *path);
+void leuko_git_changes_free(leuko_git_changes_t *changes);
+
+#endif /* LEUKO_UTIL_GIT_DIFF_H */
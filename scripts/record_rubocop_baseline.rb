@@ -0,0 +1,67 @@
+#!/usr/bin/env ruby
+# scripts/record_rubocop_baseline.rb
+# Run RuboCop over a set of files and record its JSON report, with paths
+# relative to the output file and the median wall time of the runs, as the
+# baseline `leuko_parity` compares leukocyte against.
+
+require 'json'
+require 'optparse'
+require 'open3'
+require 'pathname'
+
+# Constants: defaults
+DEFAULT_OUT = 'tests/fixtures/rubocop/baseline.json'
+
+options = {
+  out: DEFAULT_OUT,
+  runs: 3,
+  config: nil,
+  only: nil,
+  rubocop: 'rubocop'
+}
+
+OptionParser.new do |opt|
+  opt.banner = 'Usage: record_rubocop_baseline.rb [options] FILE...'
+  opt.on('--out PATH', "Output JSON file (default #{DEFAULT_OUT})") { |v| options[:out] = v }
+  opt.on('--runs N', Integer, 'Timed runs, the median is recorded (default 3)') { |v| options[:runs] = v }
+  opt.on('--config PATH', 'RuboCop config file (optional)') { |v| options[:config] = v }
+  opt.on('--only COPS', 'Comma-separated cops to run (optional)') { |v| options[:only] = v }
+  opt.on('--rubocop CMD', 'RuboCop command (default rubocop, e.g. "bundle exec rubocop")') { |v| options[:rubocop] = v }
+  opt.on('--help', 'Show help') { puts opt; exit }
+end.parse!
+
+if ARGV.empty? || options[:runs] < 1
+  warn 'No files given (see --help)'
+  exit 1
+end
+
+# The cache would make every run after the first one skip the work
+cmd = options[:rubocop].split + ['--format', 'json', '--cache', 'false']
+cmd += ['--config', options[:config]] if options[:config]
+cmd += ['--only', options[:only]] if options[:only]
+cmd += ARGV
+
+report = nil
+times = Array.new(options[:runs]) do
+  start = Process.clock_gettime(Process::CLOCK_MONOTONIC)
+  out, err, status = Open3.capture3(*cmd)
+  elapsed = Process.clock_gettime(Process::CLOCK_MONOTONIC) - start
+  # exit status 1 only means offenses were found
+  unless status.success? || status.exitstatus == 1
+    warn err
+    exit 1
+  end
+  report = JSON.parse(out)
+  elapsed * 1000.0
+end
+
+base = Pathname.new(File.dirname(File.expand_path(options[:out])))
+report['files'].each do |file|
+  file['path'] = Pathname.new(File.expand_path(file['path'])).relative_path_from(base).to_s
+end
+report['timing'] = { 'elapsed_ms' => times.sort[(times.size - 1) / 2].round(3), 'runs' => times.size }
+
+File.write(options[:out], JSON.pretty_generate(report) + "\n")
+summary = report['summary'] || {}
+puts "Wrote #{options[:out]}: #{summary['offense_count']} offenses in #{report['files'].size} files, " \
+     "#{report['timing']['elapsed_ms']} ms (median of #{times.size} runs)"
@@ -1,6 +1,9 @@
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include "cli/formatter.h"
+#include "cli/formatters.h"
+#include "rules/rule.h"
 
 /**
  * @brief Mapping of formatter strings to enum values.
@@ -28,6 +31,7 @@ static const struct
     {LEUKO_CLI_FORMATTER_NAME_MARKDOWN       , LEUKO_CLI_FORMATTER_MARKDOWN       },
     {LEUKO_CLI_FORMATTER_NAME_TAP            , LEUKO_CLI_FORMATTER_TAP            },
     {LEUKO_CLI_FORMATTER_NAME_GITHUB_ACTIONS , LEUKO_CLI_FORMATTER_GITHUB_ACTIONS },
+    {LEUKO_CLI_FORMATTER_NAME_DIFF           , LEUKO_CLI_FORMATTER_DIFF           },
     /* clang-format on */
 };
 
@@ -54,3 +58,356 @@ bool leuko_cli_formatter_from_string(const char *str, leuko_cli_formatter_t *out
     }
     return false;
 }
+
+/**
+ * @brief Formatter callbacks, indexed by leuko_cli_formatter_t.
+ * @note autogenconf prints like progress; the config file itself is written by
+ *       the `--auto-gen-config` command.
+ */
+static const leuko_cli_formatter_ops_t *const leuko_cli_formatter_ops[] = {
+    /* clang-format off */
+    [LEUKO_CLI_FORMATTER_PROGRESS]        = &leuko_cli_formatter_progress_ops,
+    [LEUKO_CLI_FORMATTER_AUTO_GEN]        = &leuko_cli_formatter_auto_gen_ops,
+    [LEUKO_CLI_FORMATTER_CLANG_STYLE]     = &leuko_cli_formatter_clang_ops,
+    [LEUKO_CLI_FORMATTER_FUUBAR_STYLE]    = &leuko_cli_formatter_fuubar_ops,
+    [LEUKO_CLI_FORMATTER_PACMAN_STYLE]    = &leuko_cli_formatter_pacman_ops,
+    [LEUKO_CLI_FORMATTER_EMACS_STYLE]     = &leuko_cli_formatter_emacs_ops,
+    [LEUKO_CLI_FORMATTER_SIMPLE]          = &leuko_cli_formatter_simple_ops,
+    [LEUKO_CLI_FORMATTER_QUIET]           = &leuko_cli_formatter_quiet_ops,
+    [LEUKO_CLI_FORMATTER_FILE_LIST]       = &leuko_cli_formatter_file_list_ops,
+    [LEUKO_CLI_FORMATTER_JSON]            = &leuko_cli_formatter_json_ops,
+    [LEUKO_CLI_FORMATTER_JUNIT_STYLE]     = &leuko_cli_formatter_junit_ops,
+    [LEUKO_CLI_FORMATTER_OFFENCE_COUNT]   = &leuko_cli_formatter_offense_count_ops,
+    [LEUKO_CLI_FORMATTER_WORST_OFFENDERS] = &leuko_cli_formatter_worst_offenders_ops,
+    [LEUKO_CLI_FORMATTER_HTML]            = &leuko_cli_formatter_html_ops,
+    [LEUKO_CLI_FORMATTER_MARKDOWN]        = &leuko_cli_formatter_markdown_ops,
+    [LEUKO_CLI_FORMATTER_TAP]             = &leuko_cli_formatter_tap_ops,
+    [LEUKO_CLI_FORMATTER_GITHUB_ACTIONS]  = &leuko_cli_formatter_github_ops,
+    [LEUKO_CLI_FORMATTER_DIFF]            = &leuko_cli_formatter_diff_ops,
+    /* clang-format on */
+};
+
+/**
+ * @brief Release everything owned by a report.
+ * @param report Report
+ */
+static void leuko_cli_report_free(leuko_cli_report_t *report)
+{
+    for (size_t i = 0; report->workers && i < report->workers_count; ++i)
+    {
+        leuko_output_buffer_free(&report->workers[i].out);
+        leuko_output_buffer_free(&report->workers[i].deferred);
+    }
+    free(report->workers);
+    free(report->file_offenses);
+    report->workers = NULL;
+    report->file_offenses = NULL;
+}
+
+/**
+ * @brief Start a formatted run: write the header and start the ordered writer.
+ * @param report Report to initialize
+ * @param formatter Selected formatter
+ * @param files Files of the run (borrowed until `leuko_cli_report_end`)
+ * @param files_count Number of files
+ * @param workers_count Number of worker threads that will report
+ * @param fd Destination file descriptor
+ * @return true on success, false on allocation or write failure
+ * @note Pass the report as user data together with `leuko_cli_report_on_result`
+ *       and `leuko_cli_report_on_file_done` to the runner.
+ */
+bool leuko_cli_report_begin(leuko_cli_report_t *report, leuko_cli_formatter_t formatter, char *const *files, size_t files_count, size_t workers_count, int fd)
+{
+    memset(report, 0, sizeof(*report));
+    if ((size_t)formatter >= sizeof(leuko_cli_formatter_ops) / sizeof(leuko_cli_formatter_ops[0]))
+    {
+        return false;
+    }
+    report->formatter = formatter;
+    report->ops = leuko_cli_formatter_ops[formatter];
+    report->files = files;
+    report->files_count = files_count;
+    report->fd = fd;
+    report->workers_count = workers_count ? workers_count : 1;
+    report->workers = calloc(report->workers_count, sizeof(leuko_cli_report_worker_t));
+    report->file_offenses = calloc(files_count ? files_count : 1, sizeof(uint32_t));
+    if (!report->workers || !report->file_offenses)
+    {
+        leuko_cli_report_free(report);
+        return false;
+    }
+
+    leuko_output_buffer_t head;
+    leuko_output_buffer_init(&head);
+    bool ok = !report->ops->begin || report->ops->begin(report, &head);
+    ok = ok && leuko_output_write_all(fd, head.data, head.len);
+    leuko_output_buffer_free(&head);
+    if (ok)
+    {
+        report->writer = leuko_output_writer_new(fd, files_count);
+        ok = report->writer != NULL;
+    }
+    if (!ok)
+    {
+        leuko_cli_report_free(report);
+    }
+    return ok;
+}
+
+/**
+ * @brief Runner result callback: count and render the offenses of one file.
+ * @param result Lint result
+ * @param data Pointer to leuko_cli_report_t
+ * @note Runs on the worker thread; only the worker's own state is touched.
+ */
+void leuko_cli_report_on_result(const leuko_lint_result_t *result, void *data)
+{
+    leuko_cli_report_t *report = data;
+    leuko_cli_report_worker_t *worker = &report->workers[result->worker_index];
+    const leuko_diagnostic_buffer_t *diags = result->diagnostics;
+    worker->has_result = true;
+
+    worker->stats.files_inspected++;
+    if (diags->count > 0)
+    {
+        worker->stats.files_with_offenses++;
+        worker->stats.offenses += diags->count;
+        for (size_t i = 0; i < diags->count; ++i)
+        {
+            worker->stats.rule_counts[diags->rule_ids[i]]++;
+            worker->stats.corrected += (diags->flags[i] & LEUKO_DIAGNOSTIC_FLAG_CORRECTED) != 0;
+        }
+    }
+    report->file_offenses[result->file_index] = (uint32_t)diags->count;
+
+    if (!report->ops->file)
+    {
+        return;
+    }
+    uint32_t *order = NULL;
+    if (!leuko_diagnostic_buffer_sorted_order(diags, &order) || !report->ops->file(report, result, order, &worker->out, &worker->deferred))
+    {
+        worker->failed = true;
+    }
+    free(order);
+}
+
+/**
+ * @brief Runner file-done callback: hand the file's output to the writer.
+ * @param file_index Index of the file
+ * @param worker_index Index of the worker
+ * @param data Pointer to leuko_cli_report_t
+ * @note Files that could not be linted are rendered without offenses, so every
+ *       formatter sees every file exactly once.
+ */
+void leuko_cli_report_on_file_done(size_t file_index, size_t worker_index, void *data)
+{
+    leuko_cli_report_t *report = data;
+    leuko_cli_report_worker_t *worker = &report->workers[worker_index];
+    if (!worker->has_result && report->ops->file)
+    {
+        static const leuko_diagnostic_buffer_t empty = {0};
+        leuko_lint_result_t result = {
+            .path = report->files[file_index],
+            .file_index = file_index,
+            .worker_index = worker_index,
+            .ps = NULL,
+            .diagnostics = &empty,
+        };
+        if (!report->ops->file(report, &result, NULL, &worker->out, &worker->deferred))
+        {
+            worker->failed = true;
+        }
+    }
+    worker->has_result = false;
+    leuko_output_writer_submit(report->writer, file_index, &worker->out, &worker->deferred);
+}
+
+/**
+ * @brief Finish a formatted run: flush file output, merge counts, write the footer.
+ * @param report Report
+ * @return true if all output was rendered and written
+ * @note Must be called after the runner has returned.
+ */
+bool leuko_cli_report_end(leuko_cli_report_t *report)
+{
+    leuko_output_buffer_t deferred;
+    leuko_output_buffer_init(&deferred);
+    bool ok = leuko_output_writer_finish(report->writer, &deferred);
+    report->writer = NULL;
+
+    leuko_cli_report_stats_t *totals = &report->totals;
+    for (size_t w = 0; w < report->workers_count; ++w)
+    {
+        const leuko_cli_report_worker_t *worker = &report->workers[w];
+        totals->files_inspected += worker->stats.files_inspected;
+        totals->files_with_offenses += worker->stats.files_with_offenses;
+        totals->offenses += worker->stats.offenses;
+        totals->corrected += worker->stats.corrected;
+        for (size_t r = 0; r < LEUKO_RULE_ID_COUNT; ++r)
+        {
+            totals->rule_counts[r] += worker->stats.rule_counts[r];
+        }
+        ok = ok && !worker->failed;
+    }
+
+    leuko_output_buffer_t tail;
+    leuko_output_buffer_init(&tail);
+    ok = (!report->ops->end || report->ops->end(report, &deferred, &tail)) && ok;
+    ok = leuko_output_write_all(report->fd, tail.data, tail.len) && ok;
+    leuko_output_buffer_free(&tail);
+    leuko_output_buffer_free(&deferred);
+    leuko_cli_report_free(report);
+    return ok;
+}
+
+/**
+ * @brief Count the UTF-8 characters in a byte range.
+ * @param begin Start of the range
+ * @param end End of the range (exclusive)
+ * @return Number of characters (continuation bytes are not counted)
+ */
+size_t leuko_cli_utf8_length(const uint8_t *begin, const uint8_t *end)
+{
+    size_t n = 0;
+    for (const uint8_t *p = begin; p < end; ++p)
+    {
+        n += (*p & 0xC0) != 0x80;
+    }
+    return n;
+}
+
+/**
+ * @brief Resolve the display position of one diagnostic.
+ * @param result Lint result holding the diagnostic
+ * @param index Index in the diagnostic buffer
+ * @param out Output view
+ */
+void leuko_cli_offense_load(const leuko_lint_result_t *result, uint32_t index, leuko_cli_offense_t *out)
+{
+    const leuko_diagnostic_buffer_t *diags = result->diagnostics;
+    leuko_processed_source_t *ps = result->ps;
+    out->index = index;
+    out->rule = leuko_rule_by_id(diags->rule_ids[index]);
+    out->severity = (leuko_severity_t)diags->severities[index];
+    out->corrected = (diags->flags[index] & LEUKO_DIAGNOSTIC_FLAG_CORRECTED) != 0;
+    out->begin = leuko_offset_to_pos(ps, diags->begin_offsets[index]);
+    out->end = leuko_offset_to_pos(ps, diags->end_offsets[index]);
+
+    leuko_processed_source_pos_info_t info;
+    leuko_processed_source_pos_info(ps, out->begin, &info);
+    out->line = info.line_number;
+    out->column = info.column + 1;
+    out->last_line = out->line;
+    out->last_column = out->column;
+    if (out->end > out->begin)
+    {
+        leuko_processed_source_pos_info(ps, out->end, &info);
+        out->last_line = info.line_number;
+        out->last_column = info.column;
+    }
+    out->length = leuko_cli_utf8_length(out->begin, out->end);
+
+    size_t idx = (size_t)(out->line - ps->start_line_number);
+    out->line_start = ps->source_start + ps->line_start_offsets[idx];
+    out->line_end = (idx + 1 < ps->line_count) ? ps->source_start + ps->line_start_offsets[idx + 1] : ps->source_end;
+    while (out->line_end > out->line_start && (out->line_end[-1] == '\n' || out->line_end[-1] == '\r'))
+    {
+        --out->line_end;
+    }
+}
+
+/**
+ * @brief Render the message of a diagnostic.
+ * @param result Lint result holding the diagnostic
+ * @param offense Loaded view of the diagnostic
+ * @param out Destination buffer
+ * @param out_size Size of the destination buffer
+ * @return Length of the rendered message
+ */
+size_t leuko_cli_offense_message(const leuko_lint_result_t *result, const leuko_cli_offense_t *offense, char *out, size_t out_size)
+{
+    const leuko_diagnostic_buffer_t *diags = result->diagnostics;
+    return leuko_rule_render_message(offense->rule, diags->message_ids[offense->index], &diags->args[offense->index * LEUKO_DIAGNOSTIC_ARG_MAX], out, out_size);
+}
+
+/**
+ * @brief Correction status shown in front of the rule name.
+ * @param offense Loaded view of the offense
+ * @return "[Corrected] ", "[Correctable] " or ""
+ */
+const char *leuko_cli_offense_status(const leuko_cli_offense_t *offense)
+{
+    if (offense->corrected)
+    {
+        return "[Corrected] ";
+    }
+    return offense->rule->autocorrectable ? "[Correctable] " : "";
+}
+
+/**
+ * @brief Render the RuboCop summary line ("N files inspected, M offenses detected[, K offenses corrected]").
+ * @param report Report (totals must be merged)
+ * @param out Output buffer
+ * @return true on success, false on allocation failure
+ */
+bool leuko_cli_render_summary(const leuko_cli_report_t *report, leuko_output_buffer_t *out)
+{
+    const leuko_cli_report_stats_t *t = &report->totals;
+    bool ok = leuko_output_buffer_printf(out, "%zu file%s inspected, ", t->files_inspected, t->files_inspected == 1 ? "" : "s");
+    if (t->offenses == 0)
+    {
+        return ok && leuko_output_buffer_puts(out, "no offenses detected\n");
+    }
+    ok = ok && leuko_output_buffer_printf(out, "%zu offense%s detected", t->offenses, t->offenses == 1 ? "" : "s");
+    if (t->corrected > 0)
+    {
+        ok = ok && leuko_output_buffer_printf(out, ", %zu offense%s corrected", t->corrected, t->corrected == 1 ? "" : "s");
+    }
+    return ok && leuko_output_buffer_putc(out, '\n');
+}
+
+/**
+ * @brief Render the source line of an offense and a caret line under its range.
+ * @param offense Loaded view of the offense
+ * @param prefix Text put in front of both lines (e.g. "# " for TAP)
+ * @param out Output buffer
+ * @return true on success, false on allocation failure
+ * @note Ranges spanning several lines are marked up to the end of the first
+ *       line, which is followed by "...".
+ */
+bool leuko_cli_render_source_line(const leuko_cli_offense_t *offense, const char *prefix, leuko_output_buffer_t *out)
+{
+    const uint8_t *caret_end = offense->end < offense->line_end ? offense->end : offense->line_end;
+    size_t carets = caret_end > offense->begin ? leuko_cli_utf8_length(offense->begin, caret_end) : 1;
+    bool ok = leuko_output_buffer_puts(out, prefix);
+    ok = ok && leuko_output_buffer_append(out, (const char *)offense->line_start, (size_t)(offense->line_end - offense->line_start));
+    ok = ok && leuko_output_buffer_puts(out, offense->last_line > offense->line ? " ...\n" : "\n");
+    ok = ok && leuko_output_buffer_puts(out, prefix);
+    ok = ok && leuko_output_buffer_append_repeat(out, ' ', offense->column - 1);
+    ok = ok && leuko_output_buffer_append_repeat(out, '^', carets);
+    return ok && leuko_output_buffer_putc(out, '\n');
+}
+
+/**
+ * @brief Render the offenses of one file in clang style (header, source line, carets).
+ * @param result Lint result
+ * @param order Output order of the diagnostics
+ * @param out Output buffer
+ * @return true on success, false on allocation failure
+ */
+bool leuko_cli_render_clang_offenses(const leuko_lint_result_t *result, const uint32_t *order, leuko_output_buffer_t *out)
+{
+    bool ok = true;
+    for (size_t i = 0; ok && i < result->diagnostics->count; ++i)
+    {
+        leuko_cli_offense_t o;
+        leuko_cli_offense_load(result, order[i], &o);
+        char message[LEUKO_CLI_MESSAGE_MAX];
+        leuko_cli_offense_message(result, &o, message, sizeof(message));
+        ok = leuko_output_buffer_printf(out, "%s:%d:%zu: %c: %s%s/%s: %s\n", result->path, o.line, o.column, leuko_severity_code(o.severity),
+                                        leuko_cli_offense_status(&o), o.rule->category, o.rule->name, message);
+        ok = ok && leuko_cli_render_source_line(&o, "", out);
+    }
+    return ok;
+}
@@ -0,0 +1,277 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include "cli/formatters.h"
+
+/**
+ * @brief Unchanged lines shown around each change.
+ */
+#define LEUKO_CLI_DIFF_CONTEXT 3
+
+/**
+ * @brief A change widened to whole lines on both sides.
+ */
+typedef struct leuko_cli_diff_block_s
+{
+    size_t orig_begin; /* byte range of the removed lines in the original */
+    size_t orig_end;
+    size_t begin;      /* byte range of the added lines in the corrected source */
+    size_t end;
+    size_t orig_line;  /* 0-based index of the first removed line */
+    size_t orig_lines; /* number of removed lines */
+    size_t lines;      /* number of added lines */
+} leuko_cli_diff_block_t;
+
+/**
+ * @brief Number of lines in a byte range that starts at a line start.
+ */
+static size_t leuko_cli_diff_count_lines(const uint8_t *s, size_t begin, size_t end)
+{
+    size_t n = 0;
+    for (const uint8_t *p = s + begin; (p = memchr(p, '\n', (size_t)(s + end - p))) != NULL; ++p)
+    {
+        ++n;
+    }
+    return n + (end > begin && s[end - 1] != '\n');
+}
+
+/**
+ * @brief Append every line of a byte range with a one-character prefix.
+ * @return true on success, false on allocation failure
+ * @note A last line without a newline gets the usual "\ No newline" marker.
+ */
+static bool leuko_cli_diff_lines(leuko_output_buffer_t *out, char prefix, const uint8_t *s, size_t begin, size_t end)
+{
+    bool ok = true;
+    while (ok && begin < end)
+    {
+        const uint8_t *nl = memchr(s + begin, '\n', end - begin);
+        size_t stop = nl ? (size_t)(nl - s) + 1 : end;
+        ok = leuko_output_buffer_append(out, &prefix, 1) && leuko_output_buffer_append(out, (const char *)s + begin, stop - begin);
+        if (ok && !nl)
+        {
+            ok = leuko_output_buffer_puts(out, "\n\\ No newline at end of file\n");
+        }
+        begin = stop;
+    }
+    return ok;
+}
+
+/**
+ * @brief Append a unified diff range header field (`start,count`).
+ * @note Spelled like diff(1): a count of one is left out and an empty range
+ *       names the line before it.
+ */
+static bool leuko_cli_diff_range(leuko_output_buffer_t *out, char sign, size_t line, size_t count)
+{
+    if (count == 1)
+    {
+        return leuko_output_buffer_printf(out, "%c%zu", sign, line + 1);
+    }
+    return leuko_output_buffer_printf(out, "%c%zu,%zu", sign, count ? line + 1 : line, count);
+}
+
+/**
+ * @brief Widen the changes of a file to whole lines and merge the ones that meet.
+ * @param result Lint result (with its change map)
+ * @param line_starts Offsets of the original's lines
+ * @param line_count Number of original lines
+ * @param blocks Output: blocks (at least as many as changes)
+ * @return Number of blocks
+ * @note Outside the changes both sources have the same bytes, so widening
+ *       a change by the same amount on both sides keeps them aligned: the
+ *       start moves back to the start of its line, the end forward until
+ *       it is at a line start (or the end) in both sources.
+ */
+static size_t leuko_cli_diff_blocks(const leuko_lint_result_t *result, const size_t *line_starts, size_t line_count, leuko_cli_diff_block_t *blocks)
+{
+    const uint8_t *orig = result->original;
+    const uint8_t *cur = result->ps->source_start;
+    size_t orig_len = result->original_len;
+    size_t cur_len = (size_t)(result->ps->source_end - result->ps->source_start);
+    size_t n = 0;
+    for (size_t i = 0; i < result->changes->count; ++i)
+    {
+        const leuko_change_t *c = &result->changes->changes[i];
+        if (c->orig_begin == c->orig_end && c->begin == c->end)
+        {
+            continue;
+        }
+        size_t back = 0;
+        while (back < c->orig_begin && orig[c->orig_begin - back - 1] != '\n')
+        {
+            ++back;
+        }
+        size_t fwd = 0;
+        bool orig_at_line = c->orig_end == orig_len || c->orig_end == 0 || orig[c->orig_end - 1] == '\n';
+        bool cur_at_line = c->end == cur_len || c->end == 0 || cur[c->end - 1] == '\n';
+        if (!orig_at_line || !cur_at_line)
+        {
+            while (c->orig_end + fwd < orig_len && orig[c->orig_end + fwd] != '\n')
+            {
+                ++fwd;
+            }
+            fwd += c->orig_end + fwd < orig_len;
+        }
+        leuko_cli_diff_block_t b = {
+            .orig_begin = c->orig_begin - back,
+            .orig_end = c->orig_end + fwd,
+            .begin = c->begin - back,
+            .end = c->end + fwd,
+        };
+        if (n > 0 && b.orig_begin <= blocks[n - 1].orig_end)
+        {
+            blocks[n - 1].orig_end = b.orig_end;
+            blocks[n - 1].end = b.end;
+        }
+        else
+        {
+            blocks[n++] = b;
+        }
+    }
+
+    size_t line = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        leuko_cli_diff_block_t *b = &blocks[i];
+        while (line + 1 < line_count && line_starts[line + 1] <= b->orig_begin)
+        {
+            ++line;
+        }
+        b->orig_line = b->orig_begin < orig_len ? line : line_count;
+        b->orig_lines = leuko_cli_diff_count_lines(orig, b->orig_begin, b->orig_end);
+        b->lines = leuko_cli_diff_count_lines(cur, b->begin, b->end);
+    }
+    return n;
+}
+
+/**
+ * @brief Path of a file as the diff headers name it: relative to the current directory.
+ * @param path Path of the file as collected
+ * @return Position inside `path`, or NULL when it is absolute and outside the current directory
+ * @note `./a.rb` (the default collection) becomes `a.rb`: git apply rejects
+ *       `a/./a.rb`.
+ */
+static const char *leuko_cli_diff_path(const char *path)
+{
+    if (path[0] == '/')
+    {
+        char cwd[PATH_MAX];
+        if (!getcwd(cwd, sizeof(cwd)))
+        {
+            return NULL;
+        }
+        size_t len = strcmp(cwd, "/") == 0 ? 0 : strlen(cwd);
+        if (strncmp(path, cwd, len) != 0 || path[len] != '/')
+        {
+            return NULL;
+        }
+        path += len;
+    }
+    for (;;)
+    {
+        while (path[0] == '/')
+        {
+            ++path;
+        }
+        if (path[0] != '.' || path[1] != '/')
+        {
+            return path;
+        }
+        path += 2;
+    }
+}
+
+/**
+ * @brief diff: a unified diff of the corrections of one file.
+ * @note Built from the change map the engine folds every autocorrect pass
+ *       into, so only the changed regions are looked at; no text diff of
+ *       the two sources is computed. Hunks closer than twice the context
+ *       are joined, like diff(1) does. Files without corrections print
+ *       nothing. Headers carry the `a/` and `b/` prefixes git apply strips,
+ *       except for files outside the current directory, named as given.
+ */
+static bool leuko_cli_diff_file(leuko_cli_report_t *report, const leuko_lint_result_t *result, const uint32_t *order, leuko_output_buffer_t *out,
+                                leuko_output_buffer_t *deferred)
+{
+    (void)report;
+    (void)order;
+    (void)deferred;
+    if (!result->ps || !result->changes || result->changes->count == 0)
+    {
+        return true;
+    }
+    const uint8_t *orig = result->original;
+    size_t orig_len = result->original_len;
+    size_t line_count = leuko_cli_diff_count_lines(orig, 0, orig_len);
+    size_t *line_starts = malloc((line_count + 1) * sizeof(size_t));
+    leuko_cli_diff_block_t *blocks = malloc(result->changes->count * sizeof(leuko_cli_diff_block_t));
+    if (!line_starts || !blocks)
+    {
+        free(line_starts);
+        free(blocks);
+        return false;
+    }
+    line_starts[0] = 0;
+    for (size_t i = 0, n = 1; i < orig_len && n < line_count; ++i)
+    {
+        if (orig[i] == '\n')
+        {
+            line_starts[n++] = i + 1;
+        }
+    }
+    line_starts[line_count] = orig_len;
+    size_t count = leuko_cli_diff_blocks(result, line_starts, line_count, blocks);
+    if (count == 0)
+    {
+        free(line_starts);
+        free(blocks);
+        return true;
+    }
+
+    const uint8_t *cur = result->ps->source_start;
+    const char *path = leuko_cli_diff_path(result->path);
+    bool ok = path ? leuko_output_buffer_printf(out, "--- a/%s\n+++ b/%s\n", path, path)
+                   : leuko_output_buffer_printf(out, "--- %s\n+++ %s\n", result->path, result->path);
+    int64_t shift = 0; /* added minus removed lines of the hunks written so far */
+    for (size_t first = 0; ok && first < count;)
+    {
+        size_t last = first;
+        int64_t hunk_shift = (int64_t)blocks[first].lines - (int64_t)blocks[first].orig_lines;
+        while (last + 1 < count && blocks[last + 1].orig_line - (blocks[last].orig_line + blocks[last].orig_lines) <= 2 * LEUKO_CLI_DIFF_CONTEXT)
+        {
+            ++last;
+            hunk_shift += (int64_t)blocks[last].lines - (int64_t)blocks[last].orig_lines;
+        }
+        size_t from = blocks[first].orig_line > LEUKO_CLI_DIFF_CONTEXT ? blocks[first].orig_line - LEUKO_CLI_DIFF_CONTEXT : 0;
+        size_t to = blocks[last].orig_line + blocks[last].orig_lines + LEUKO_CLI_DIFF_CONTEXT;
+        to = to < line_count ? to : line_count;
+        size_t orig_count = to - from;
+        size_t new_count = (size_t)((int64_t)orig_count + hunk_shift);
+
+        ok = leuko_output_buffer_puts(out, "@@ ");
+        ok = ok && leuko_cli_diff_range(out, '-', from, orig_count);
+        ok = ok && leuko_output_buffer_puts(out, " ");
+        ok = ok && leuko_cli_diff_range(out, '+', (size_t)((int64_t)from + shift), new_count);
+        ok = ok && leuko_output_buffer_puts(out, " @@\n");
+        size_t line = from;
+        for (size_t i = first; ok && i <= last; ++i)
+        {
+            const leuko_cli_diff_block_t *b = &blocks[i];
+            ok = leuko_cli_diff_lines(out, ' ', orig, line_starts[line], line_starts[b->orig_line]);
+            ok = ok && leuko_cli_diff_lines(out, '-', orig, b->orig_begin, b->orig_end);
+            ok = ok && leuko_cli_diff_lines(out, '+', cur, b->begin, b->end);
+            line = b->orig_line + b->orig_lines;
+        }
+        ok = ok && leuko_cli_diff_lines(out, ' ', orig, line_starts[line], line_starts[to]);
+        shift += hunk_shift;
+        first = last + 1;
+    }
+    free(line_starts);
+    free(blocks);
+    return ok;
+}
+
+const leuko_cli_formatter_ops_t leuko_cli_formatter_diff_ops = {NULL, leuko_cli_diff_file, NULL};
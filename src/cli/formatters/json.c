@@ -0,0 +1,63 @@
+#include <string.h>
+#include "cli/formatters.h"
+#include "output/json_escape.h"
+#include "version.h"
+
+/**
+ * @brief json: open the document and the file list.
+ */
+static bool leuko_cli_json_begin(leuko_cli_report_t *report, leuko_output_buffer_t *out)
+{
+    (void)report;
+    return leuko_output_buffer_puts(out, "{\"metadata\":{\"leukocyte_version\":\"" LEUKO_VERSION "\"},\"files\":[");
+}
+
+/**
+ * @brief json: one file object, written as soon as the file is done.
+ * @note No document is built: the object is rendered straight into the
+ *       worker's chunk, which the writer flushes in file order, so memory is
+ *       bounded by the files in flight rather than by the report size. Files
+ *       are separated by a leading comma on every file but the first, which
+ *       works because every file produces exactly one object.
+ */
+static bool leuko_cli_json_file(leuko_cli_report_t *report, const leuko_lint_result_t *result, const uint32_t *order, leuko_output_buffer_t *out,
+                                leuko_output_buffer_t *deferred)
+{
+    (void)report;
+    (void)deferred;
+    bool ok = leuko_output_buffer_puts(out, result->file_index ? ",{\"path\":" : "{\"path\":");
+    ok = ok && leuko_json_append_string(out, result->path, strlen(result->path));
+    ok = ok && leuko_output_buffer_puts(out, ",\"offenses\":[");
+    for (size_t i = 0; ok && i < result->diagnostics->count; ++i)
+    {
+        leuko_cli_offense_t o;
+        leuko_cli_offense_load(result, order[i], &o);
+        char message[LEUKO_CLI_MESSAGE_MAX];
+        size_t message_len = leuko_cli_offense_message(result, &o, message, sizeof(message));
+        if (message_len >= sizeof(message))
+        {
+            message_len = sizeof(message) - 1;
+        }
+        ok = leuko_output_buffer_printf(out, "%s{\"severity\":\"%s\",\"message\":", i ? "," : "", leuko_severity_to_string(o.severity));
+        ok = ok && leuko_json_append_string(out, message, message_len);
+        ok = ok && leuko_output_buffer_printf(out, ",\"cop_name\":\"%s/%s\",\"corrected\":%s,\"correctable\":%s,", o.rule->category, o.rule->name,
+                                              o.corrected ? "true" : "false", o.rule->autocorrectable ? "true" : "false");
+        ok = ok && leuko_output_buffer_printf(out,
+                                              "\"location\":{\"start_line\":%d,\"start_column\":%zu,\"last_line\":%d,\"last_column\":%zu,"
+                                              "\"length\":%zu,\"line\":%d,\"column\":%zu}}",
+                                              o.line, o.column, o.last_line, o.last_column, o.length, o.line, o.column);
+    }
+    return ok && leuko_output_buffer_puts(out, "]}");
+}
+
+/**
+ * @brief json: close the file list and add the summary.
+ */
+static bool leuko_cli_json_end(leuko_cli_report_t *report, const leuko_output_buffer_t *deferred, leuko_output_buffer_t *out)
+{
+    (void)deferred;
+    return leuko_output_buffer_printf(out, "],\"summary\":{\"offense_count\":%zu,\"target_file_count\":%zu,\"inspected_file_count\":%zu}}\n", report->totals.offenses,
+                                      report->files_count, report->totals.files_inspected);
+}
+
+const leuko_cli_formatter_ops_t leuko_cli_formatter_json_ops = {leuko_cli_json_begin, leuko_cli_json_file, leuko_cli_json_end};
@@ -0,0 +1,244 @@
+#include <string.h>
+#include "cli/formatters.h"
+
+/**
+ * @brief Append text with the XML/HTML special characters escaped.
+ * @param out Output buffer
+ * @param s Text
+ * @param n Length of the text
+ * @return true on success, false on allocation failure
+ */
+static bool leuko_cli_xml_escape(leuko_output_buffer_t *out, const char *s, size_t n)
+{
+    bool ok = true;
+    size_t run = 0;
+    for (size_t i = 0; ok && i < n; ++i)
+    {
+        const char *entity = NULL;
+        switch (s[i])
+        {
+        case '&':
+            entity = "&amp;";
+            break;
+        case '<':
+            entity = "&lt;";
+            break;
+        case '>':
+            entity = "&gt;";
+            break;
+        case '"':
+            entity = "&quot;";
+            break;
+        case '\'':
+            entity = "&apos;";
+            break;
+        default:
+            continue;
+        }
+        ok = leuko_output_buffer_append(out, s + run, i - run) && leuko_output_buffer_puts(out, entity);
+        run = i + 1;
+    }
+    return ok && leuko_output_buffer_append(out, s + run, n - run);
+}
+
+/**
+ * @brief Append a NUL-terminated string with XML/HTML special characters escaped.
+ */
+static bool leuko_cli_xml_escape_str(leuko_output_buffer_t *out, const char *s)
+{
+    return leuko_cli_xml_escape(out, s, strlen(s));
+}
+
+/**
+ * @brief Summary line with the trailing newline replaced by a suffix.
+ * @param report Report
+ * @param suffix Text to end the line with
+ * @param out Output buffer
+ * @return true on success, false on allocation failure
+ */
+static bool leuko_cli_render_summary_with(const leuko_cli_report_t *report, const char *suffix, leuko_output_buffer_t *out)
+{
+    if (!leuko_cli_render_summary(report, out))
+    {
+        return false;
+    }
+    out->len--;
+    return leuko_output_buffer_puts(out, suffix);
+}
+
+/* ------------------------------------------------------------------------ */
+/* markdown                                                                 */
+/* ------------------------------------------------------------------------ */
+
+/**
+ * @brief markdown: one section per file with offenses, collected for the end.
+ */
+static bool leuko_cli_markdown_file(leuko_cli_report_t *report, const leuko_lint_result_t *result, const uint32_t *order, leuko_output_buffer_t *out,
+                                    leuko_output_buffer_t *deferred)
+{
+    (void)report;
+    (void)out;
+    const leuko_diagnostic_buffer_t *diags = result->diagnostics;
+    if (diags->count == 0)
+    {
+        return true;
+    }
+    bool ok = leuko_output_buffer_printf(deferred, "### %s - (%zu offense%s)\n", result->path, diags->count, diags->count == 1 ? "" : "s");
+    for (size_t i = 0; ok && i < diags->count; ++i)
+    {
+        leuko_cli_offense_t o;
+        leuko_cli_offense_load(result, order[i], &o);
+        char message[LEUKO_CLI_MESSAGE_MAX];
+        leuko_cli_offense_message(result, &o, message, sizeof(message));
+        ok = leuko_output_buffer_printf(deferred, "  * **Line # %d - %s:** %s/%s: %s\n\n    ```rb\n    ", o.line, leuko_severity_to_string(o.severity), o.rule->category,
+                                        o.rule->name, message);
+        ok = ok && leuko_output_buffer_append(deferred, (const char *)o.line_start, (size_t)(o.line_end - o.line_start));
+        ok = ok && leuko_output_buffer_puts(deferred, "\n    ```\n\n");
+    }
+    return ok;
+}
+
+/**
+ * @brief markdown: title and summary, then the collected sections.
+ */
+static bool leuko_cli_markdown_end(leuko_cli_report_t *report, const leuko_output_buffer_t *deferred, leuko_output_buffer_t *out)
+{
+    bool ok = leuko_output_buffer_puts(out, "# RuboCop Inspection Report\n\n");
+    ok = ok && leuko_cli_render_summary_with(report, ":\n\n", out);
+    return ok && leuko_output_buffer_append(out, deferred->data, deferred->len);
+}
+
+/* ------------------------------------------------------------------------ */
+/* html                                                                     */
+/* ------------------------------------------------------------------------ */
+
+/**
+ * @brief html: one box per file with offenses, collected for the end.
+ */
+static bool leuko_cli_html_file(leuko_cli_report_t *report, const leuko_lint_result_t *result, const uint32_t *order, leuko_output_buffer_t *out,
+                                leuko_output_buffer_t *deferred)
+{
+    (void)report;
+    (void)out;
+    const leuko_diagnostic_buffer_t *diags = result->diagnostics;
+    if (diags->count == 0)
+    {
+        return true;
+    }
+    bool ok = leuko_output_buffer_puts(deferred, "<div class=\"offense-box\">\n<h2 class=\"box-title\">");
+    ok = ok && leuko_cli_xml_escape_str(deferred, result->path);
+    ok = ok && leuko_output_buffer_printf(deferred, " - %zu offense%s</h2>\n", diags->count, diags->count == 1 ? "" : "s");
+    for (size_t i = 0; ok && i < diags->count; ++i)
+    {
+        leuko_cli_offense_t o;
+        leuko_cli_offense_load(result, order[i], &o);
+        char message[LEUKO_CLI_MESSAGE_MAX];
+        leuko_cli_offense_message(result, &o, message, sizeof(message));
+        const char *severity = leuko_severity_to_string(o.severity);
+        ok = leuko_output_buffer_printf(deferred, "<div class=\"offense\"><span class=\"location\">Line #%d</span> &ndash; <span class=\"severity %s\">%s:</span> ",
+                                        o.line, severity, severity);
+        ok = ok && leuko_output_buffer_printf(deferred, "<span class=\"message\">%s/%s: ", o.rule->category, o.rule->name);
+        ok = ok && leuko_cli_xml_escape_str(deferred, message);
+        ok = ok && leuko_output_buffer_puts(deferred, "</span>\n<pre><code>");
+        ok = ok && leuko_cli_xml_escape(deferred, (const char *)o.line_start, (size_t)(o.line_end - o.line_start));
+        ok = ok && leuko_output_buffer_puts(deferred, "</code></pre></div>\n");
+    }
+    return ok && leuko_output_buffer_puts(deferred, "</div>\n");
+}
+
+/**
+ * @brief html: document head and summary, then the collected boxes.
+ */
+static bool leuko_cli_html_end(leuko_cli_report_t *report, const leuko_output_buffer_t *deferred, leuko_output_buffer_t *out)
+{
+    bool ok = leuko_output_buffer_puts(out, "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"UTF-8\">\n<title>RuboCop Inspection Report</title>\n</head>\n<body>\n"
+                                            "<h1>RuboCop Inspection Report</h1>\n<p class=\"summary\">");
+    ok = ok && leuko_cli_render_summary_with(report, "</p>\n", out);
+    ok = ok && leuko_output_buffer_append(out, deferred->data, deferred->len);
+    return ok && leuko_output_buffer_puts(out, "</body>\n</html>\n");
+}
+
+/* ------------------------------------------------------------------------ */
+/* junit                                                                    */
+/* ------------------------------------------------------------------------ */
+
+/**
+ * @brief junit: one test case per file and rule, with a failure per offense.
+ * @note The class name is the path without `.rb`, with '/' replaced by '.'.
+ */
+static bool leuko_cli_junit_file(leuko_cli_report_t *report, const leuko_lint_result_t *result, const uint32_t *order, leuko_output_buffer_t *out,
+                                 leuko_output_buffer_t *deferred)
+{
+    (void)report;
+    (void)out;
+    if (!result->ps)
+    {
+        return true;
+    }
+    const leuko_diagnostic_buffer_t *diags = result->diagnostics;
+    size_t path_len = strlen(result->path);
+    if (path_len > 3 && strcmp(result->path + path_len - 3, ".rb") == 0)
+    {
+        path_len -= 3;
+    }
+    char classname[LEUKO_CLI_MESSAGE_MAX];
+    size_t n = path_len < sizeof(classname) - 1 ? path_len : sizeof(classname) - 1;
+    for (size_t i = 0; i < n; ++i)
+    {
+        classname[i] = result->path[i] == '/' ? '.' : result->path[i];
+    }
+    classname[n] = '\0';
+
+    size_t rule_count = 0;
+    const leuko_rule_t *const *rules = leuko_rules_all(&rule_count);
+    bool ok = true;
+    for (size_t r = 0; ok && r < rule_count; ++r)
+    {
+        ok = leuko_output_buffer_puts(deferred, "    <testcase classname='");
+        ok = ok && leuko_cli_xml_escape_str(deferred, classname);
+        ok = ok && leuko_output_buffer_printf(deferred, "' name='%s/%s'", rules[r]->category, rules[r]->name);
+        bool open = false;
+        for (size_t i = 0; ok && i < diags->count; ++i)
+        {
+            if (diags->rule_ids[order[i]] != rules[r]->id)
+            {
+                continue;
+            }
+            if (!open)
+            {
+                ok = leuko_output_buffer_puts(deferred, ">\n");
+                open = true;
+            }
+            leuko_cli_offense_t o;
+            leuko_cli_offense_load(result, order[i], &o);
+            char message[LEUKO_CLI_MESSAGE_MAX];
+            leuko_cli_offense_message(result, &o, message, sizeof(message));
+            ok = ok && leuko_output_buffer_printf(deferred, "      <failure type='%s/%s' message='", o.rule->category, o.rule->name);
+            ok = ok && leuko_cli_xml_escape_str(deferred, message);
+            ok = ok && leuko_output_buffer_puts(deferred, "'>\n        ");
+            ok = ok && leuko_cli_xml_escape_str(deferred, result->path);
+            ok = ok && leuko_output_buffer_printf(deferred, ":%d:%zu\n      </failure>\n", o.line, o.column);
+        }
+        ok = ok && leuko_output_buffer_puts(deferred, open ? "    </testcase>\n" : "/>\n");
+    }
+    return ok;
+}
+
+/**
+ * @brief junit: test suite totals, then the collected test cases.
+ */
+static bool leuko_cli_junit_end(leuko_cli_report_t *report, const leuko_output_buffer_t *deferred, leuko_output_buffer_t *out)
+{
+    size_t rule_count = 0;
+    leuko_rules_all(&rule_count);
+    bool ok = leuko_output_buffer_printf(out, "<?xml version='1.0'?>\n<testsuites>\n  <testsuite name='rubocop' tests='%zu' failures='%zu'>\n",
+                                         report->totals.files_inspected * rule_count, report->totals.offenses);
+    ok = ok && leuko_output_buffer_append(out, deferred->data, deferred->len);
+    return ok && leuko_output_buffer_puts(out, "  </testsuite>\n</testsuites>\n");
+}
+
+/* clang-format off */
+const leuko_cli_formatter_ops_t leuko_cli_formatter_markdown_ops = {NULL, leuko_cli_markdown_file, leuko_cli_markdown_end};
+const leuko_cli_formatter_ops_t leuko_cli_formatter_html_ops     = {NULL, leuko_cli_html_file,     leuko_cli_html_end};
+const leuko_cli_formatter_ops_t leuko_cli_formatter_junit_ops    = {NULL, leuko_cli_junit_file,    leuko_cli_junit_end};
+/* clang-format on */
@@ -0,0 +1,445 @@
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cli/formatters.h"
+
+/**
+ * @brief Worst severity among the diagnostics of a file.
+ * @param diags Diagnostic buffer (must not be empty)
+ * @return Highest severity
+ */
+static leuko_severity_t leuko_cli_worst_severity(const leuko_diagnostic_buffer_t *diags)
+{
+    uint8_t worst = 0;
+    for (size_t i = 0; i < diags->count; ++i)
+    {
+        if (diags->severities[i] > worst)
+        {
+            worst = diags->severities[i];
+        }
+    }
+    return (leuko_severity_t)worst;
+}
+
+/**
+ * @brief Number of decimal digits of a count.
+ * @param v Count
+ * @return Number of digits (at least 1)
+ */
+static int leuko_cli_digits(size_t v)
+{
+    int n = 1;
+    while (v >= 10)
+    {
+        v /= 10;
+        ++n;
+    }
+    return n;
+}
+
+/* ------------------------------------------------------------------------ */
+/* progress / autogenconf / pacman                                          */
+/* ------------------------------------------------------------------------ */
+
+/**
+ * @brief progress: print the number of files to inspect.
+ */
+static bool leuko_cli_progress_begin(leuko_cli_report_t *report, leuko_output_buffer_t *out)
+{
+    return leuko_output_buffer_printf(out, "Inspecting %zu file%s\n", report->files_count, report->files_count == 1 ? "" : "s");
+}
+
+/**
+ * @brief progress: one character per file; offenses are kept for the end.
+ */
+static bool leuko_cli_progress_file(leuko_cli_report_t *report, const leuko_lint_result_t *result, const uint32_t *order, leuko_output_buffer_t *out,
+                                    leuko_output_buffer_t *deferred)
+{
+    (void)report;
+    if (result->diagnostics->count == 0)
+    {
+        return leuko_output_buffer_putc(out, '.');
+    }
+    return leuko_output_buffer_putc(out, leuko_severity_code(leuko_cli_worst_severity(result->diagnostics))) &&
+           leuko_cli_render_clang_offenses(result, order, deferred);
+}
+
+/**
+ * @brief progress: end the progress line, then print all offenses and the summary.
+ */
+static bool leuko_cli_progress_end(leuko_cli_report_t *report, const leuko_output_buffer_t *deferred, leuko_output_buffer_t *out)
+{
+    bool ok = leuko_output_buffer_putc(out, '\n');
+    if (report->totals.offenses > 0)
+    {
+        ok = ok && leuko_output_buffer_puts(out, "\nOffenses:\n\n");
+        ok = ok && leuko_output_buffer_append(out, deferred->data, deferred->len);
+    }
+    ok = ok && leuko_output_buffer_putc(out, '\n');
+    return ok && leuko_cli_render_summary(report, out);
+}
+
+/**
+ * @brief pacman: print the number of files to eat.
+ */
+static bool leuko_cli_pacman_begin(leuko_cli_report_t *report, leuko_output_buffer_t *out)
+{
+    return leuko_output_buffer_printf(out, "Eating %zu file%s\n", report->files_count, report->files_count == 1 ? "" : "s");
+}
+
+/**
+ * @brief pacman: a dot for clean files, a ghost for files with offenses.
+ */
+static bool leuko_cli_pacman_file(leuko_cli_report_t *report, const leuko_lint_result_t *result, const uint32_t *order, leuko_output_buffer_t *out,
+                                  leuko_output_buffer_t *deferred)
+{
+    (void)report;
+    if (result->diagnostics->count == 0)
+    {
+        return leuko_output_buffer_putc(out, '.');
+    }
+    return leuko_output_buffer_puts(out, "\xE1\x97\xA3") && leuko_cli_render_clang_offenses(result, order, deferred);
+}
+
+/* ------------------------------------------------------------------------ */
+/* clang / fuubar                                                           */
+/* ------------------------------------------------------------------------ */
+
+/**
+ * @brief clang: offenses with source line and carets, as soon as the file is done.
+ */
+static bool leuko_cli_clang_file(leuko_cli_report_t *report, const leuko_lint_result_t *result, const uint32_t *order, leuko_output_buffer_t *out,
+                                 leuko_output_buffer_t *deferred)
+{
+    (void)report;
+    (void)deferred;
+    return leuko_cli_render_clang_offenses(result, order, out);
+}
+
+/**
+ * @brief Summary preceded by an empty line (simple, clang, tap, ...).
+ */
+static bool leuko_cli_summary_end(leuko_cli_report_t *report, const leuko_output_buffer_t *deferred, leuko_output_buffer_t *out)
+{
+    (void)deferred;
+    return leuko_output_buffer_putc(out, '\n') && leuko_cli_render_summary(report, out);
+}
+
+/* ------------------------------------------------------------------------ */
+/* emacs / files                                                            */
+/* ------------------------------------------------------------------------ */
+
+/**
+ * @brief Absolute path of a file, falling back to the path as given.
+ * @param path Path
+ * @param buf Buffer of PATH_MAX bytes
+ * @return Absolute path
+ */
+static const char *leuko_cli_absolute_path(const char *path, char *buf)
+{
+    return realpath(path, buf) ? buf : path;
+}
+
+/**
+ * @brief emacs: one line per offense with the absolute path.
+ */
+static bool leuko_cli_emacs_file(leuko_cli_report_t *report, const leuko_lint_result_t *result, const uint32_t *order, leuko_output_buffer_t *out,
+                                 leuko_output_buffer_t *deferred)
+{
+    (void)report;
+    (void)deferred;
+    if (result->diagnostics->count == 0)
+    {
+        return true;
+    }
+    char abs[PATH_MAX];
+    const char *path = leuko_cli_absolute_path(result->path, abs);
+    bool ok = true;
+    for (size_t i = 0; ok && i < result->diagnostics->count; ++i)
+    {
+        leuko_cli_offense_t o;
+        leuko_cli_offense_load(result, order[i], &o);
+        char message[LEUKO_CLI_MESSAGE_MAX];
+        leuko_cli_offense_message(result, &o, message, sizeof(message));
+        ok = leuko_output_buffer_printf(out, "%s:%d:%zu: %c: %s%s/%s: %s\n", path, o.line, o.column, leuko_severity_code(o.severity), leuko_cli_offense_status(&o),
+                                        o.rule->category, o.rule->name, message);
+    }
+    return ok;
+}
+
+/**
+ * @brief files: the absolute path of every file with offenses.
+ */
+static bool leuko_cli_file_list_file(leuko_cli_report_t *report, const leuko_lint_result_t *result, const uint32_t *order, leuko_output_buffer_t *out,
+                                     leuko_output_buffer_t *deferred)
+{
+    (void)report;
+    (void)order;
+    (void)deferred;
+    if (result->diagnostics->count == 0)
+    {
+        return true;
+    }
+    char abs[PATH_MAX];
+    return leuko_output_buffer_puts(out, leuko_cli_absolute_path(result->path, abs)) && leuko_output_buffer_putc(out, '\n');
+}
+
+/* ------------------------------------------------------------------------ */
+/* simple / quiet                                                           */
+/* ------------------------------------------------------------------------ */
+
+/**
+ * @brief simple: a "== path ==" heading followed by one line per offense.
+ */
+static bool leuko_cli_simple_file(leuko_cli_report_t *report, const leuko_lint_result_t *result, const uint32_t *order, leuko_output_buffer_t *out,
+                                  leuko_output_buffer_t *deferred)
+{
+    (void)report;
+    (void)deferred;
+    if (result->diagnostics->count == 0)
+    {
+        return true;
+    }
+    bool ok = leuko_output_buffer_printf(out, "== %s ==\n", result->path);
+    for (size_t i = 0; ok && i < result->diagnostics->count; ++i)
+    {
+        leuko_cli_offense_t o;
+        leuko_cli_offense_load(result, order[i], &o);
+        char message[LEUKO_CLI_MESSAGE_MAX];
+        leuko_cli_offense_message(result, &o, message, sizeof(message));
+        ok = leuko_output_buffer_printf(out, "%c:%3d:%3zu: %s%s/%s: %s\n", leuko_severity_code(o.severity), o.line, o.column, leuko_cli_offense_status(&o),
+                                        o.rule->category, o.rule->name, message);
+    }
+    return ok;
+}
+
+/**
+ * @brief quiet: the summary only when something was found.
+ */
+static bool leuko_cli_quiet_end(leuko_cli_report_t *report, const leuko_output_buffer_t *deferred, leuko_output_buffer_t *out)
+{
+    return report->totals.offenses == 0 || leuko_cli_summary_end(report, deferred, out);
+}
+
+/* ------------------------------------------------------------------------ */
+/* tap                                                                      */
+/* ------------------------------------------------------------------------ */
+
+/**
+ * @brief tap: the test plan.
+ */
+static bool leuko_cli_tap_begin(leuko_cli_report_t *report, leuko_output_buffer_t *out)
+{
+    return leuko_output_buffer_printf(out, "1..%zu\n", report->files_count);
+}
+
+/**
+ * @brief tap: one test point per file, offenses as diagnostics lines.
+ */
+static bool leuko_cli_tap_file(leuko_cli_report_t *report, const leuko_lint_result_t *result, const uint32_t *order, leuko_output_buffer_t *out,
+                               leuko_output_buffer_t *deferred)
+{
+    (void)report;
+    (void)deferred;
+    const leuko_diagnostic_buffer_t *diags = result->diagnostics;
+    bool ok = leuko_output_buffer_printf(out, "%s %zu - %s\n", diags->count == 0 ? "ok" : "not ok", result->file_index + 1, result->path);
+    for (size_t i = 0; ok && i < diags->count; ++i)
+    {
+        leuko_cli_offense_t o;
+        leuko_cli_offense_load(result, order[i], &o);
+        char message[LEUKO_CLI_MESSAGE_MAX];
+        leuko_cli_offense_message(result, &o, message, sizeof(message));
+        ok = leuko_output_buffer_printf(out, "# %s:%d:%zu: %c: %s%s/%s: %s\n", result->path, o.line, o.column, leuko_severity_code(o.severity),
+                                        leuko_cli_offense_status(&o), o.rule->category, o.rule->name, message);
+        ok = ok && leuko_cli_render_source_line(&o, "# ", out);
+    }
+    return ok;
+}
+
+/* ------------------------------------------------------------------------ */
+/* github                                                                   */
+/* ------------------------------------------------------------------------ */
+
+/**
+ * @brief Append text escaped for a GitHub Actions workflow command.
+ * @param out Output buffer
+ * @param s Text
+ * @param property Escape ':' and ',' too (property values)
+ * @return true on success, false on allocation failure
+ */
+static bool leuko_cli_github_escape(leuko_output_buffer_t *out, const char *s, bool property)
+{
+    bool ok = true;
+    for (; ok && *s; ++s)
+    {
+        switch (*s)
+        {
+        case '%':
+            ok = leuko_output_buffer_puts(out, "%25");
+            break;
+        case '\r':
+            ok = leuko_output_buffer_puts(out, "%0D");
+            break;
+        case '\n':
+            ok = leuko_output_buffer_puts(out, "%0A");
+            break;
+        case ':':
+            ok = property ? leuko_output_buffer_puts(out, "%3A") : leuko_output_buffer_putc(out, *s);
+            break;
+        case ',':
+            ok = property ? leuko_output_buffer_puts(out, "%2C") : leuko_output_buffer_putc(out, *s);
+            break;
+        default:
+            ok = leuko_output_buffer_putc(out, *s);
+            break;
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief github: one workflow command per offense (annotations in pull requests).
+ */
+static bool leuko_cli_github_file(leuko_cli_report_t *report, const leuko_lint_result_t *result, const uint32_t *order, leuko_output_buffer_t *out,
+                                  leuko_output_buffer_t *deferred)
+{
+    (void)report;
+    (void)deferred;
+    bool ok = true;
+    for (size_t i = 0; ok && i < result->diagnostics->count; ++i)
+    {
+        leuko_cli_offense_t o;
+        leuko_cli_offense_load(result, order[i], &o);
+        char message[LEUKO_CLI_MESSAGE_MAX];
+        leuko_cli_offense_message(result, &o, message, sizeof(message));
+        ok = leuko_output_buffer_printf(out, "::%s file=", o.severity >= LEUKO_SEVERITY_ERROR ? "error" : "warning");
+        ok = ok && leuko_cli_github_escape(out, result->path, true);
+        ok = ok && leuko_output_buffer_printf(out, ",line=%d,col=%zu::%s/%s: ", o.line, o.column, o.rule->category, o.rule->name);
+        ok = ok && leuko_cli_github_escape(out, message, false);
+        ok = ok && leuko_output_buffer_putc(out, '\n');
+    }
+    return ok;
+}
+
+/* ------------------------------------------------------------------------ */
+/* offenses / worst                                                         */
+/* ------------------------------------------------------------------------ */
+
+/**
+ * @brief Row of a count table.
+ */
+typedef struct leuko_cli_count_row_s
+{
+    size_t count;
+    size_t key; /* rule id or file index */
+    const char *category;
+    const char *name;
+} leuko_cli_count_row_t;
+
+/**
+ * @brief Order rows by count (descending), then by name.
+ */
+static int leuko_cli_count_row_cmp(const void *a, const void *b)
+{
+    const leuko_cli_count_row_t *ra = a;
+    const leuko_cli_count_row_t *rb = b;
+    if (ra->count != rb->count)
+    {
+        return ra->count < rb->count ? 1 : -1;
+    }
+    int c = strcmp(ra->category ? ra->category : "", rb->category ? rb->category : "");
+    return c ? c : strcmp(ra->name, rb->name);
+}
+
+/**
+ * @brief Render a sorted count table followed by the total line.
+ * @param report Report
+ * @param rows Rows (sorted in place)
+ * @param row_count Number of rows
+ * @param out Output buffer
+ * @return true on success, false on allocation failure
+ */
+static bool leuko_cli_render_count_table(const leuko_cli_report_t *report, leuko_cli_count_row_t *rows, size_t row_count, leuko_output_buffer_t *out)
+{
+    qsort(rows, row_count, sizeof(*rows), leuko_cli_count_row_cmp);
+    int width = leuko_cli_digits(report->totals.offenses) + 2;
+    bool ok = leuko_output_buffer_putc(out, '\n');
+    for (size_t i = 0; ok && i < row_count; ++i)
+    {
+        if (rows[i].category)
+        {
+            ok = leuko_output_buffer_printf(out, "%-*zu%s/%s\n", width, rows[i].count, rows[i].category, rows[i].name);
+        }
+        else
+        {
+            ok = leuko_output_buffer_printf(out, "%-*zu%s\n", width, rows[i].count, rows[i].name);
+        }
+    }
+    ok = ok && leuko_output_buffer_puts(out, "--\n");
+    return ok && leuko_output_buffer_printf(out, "%-*zuTotal in %zu files\n", width, report->totals.offenses, report->totals.files_with_offenses);
+}
+
+/**
+ * @brief offenses: offense count per rule.
+ */
+static bool leuko_cli_offense_count_end(leuko_cli_report_t *report, const leuko_output_buffer_t *deferred, leuko_output_buffer_t *out)
+{
+    (void)deferred;
+    leuko_cli_count_row_t *rows = malloc(LEUKO_RULE_ID_COUNT * sizeof(*rows));
+    if (!rows)
+    {
+        return false;
+    }
+    size_t n = 0;
+    for (size_t r = 0; r < LEUKO_RULE_ID_COUNT; ++r)
+    {
+        const leuko_rule_t *rule = report->totals.rule_counts[r] ? leuko_rule_by_id((leuko_rule_id_t)r) : NULL;
+        if (rule)
+        {
+            rows[n++] = (leuko_cli_count_row_t){.count = report->totals.rule_counts[r], .key = r, .category = rule->category, .name = rule->name};
+        }
+    }
+    bool ok = leuko_cli_render_count_table(report, rows, n, out);
+    free(rows);
+    return ok;
+}
+
+/**
+ * @brief worst: offense count per file.
+ */
+static bool leuko_cli_worst_offenders_end(leuko_cli_report_t *report, const leuko_output_buffer_t *deferred, leuko_output_buffer_t *out)
+{
+    (void)deferred;
+    leuko_cli_count_row_t *rows = malloc((report->totals.files_with_offenses + 1) * sizeof(*rows));
+    if (!rows)
+    {
+        return false;
+    }
+    size_t n = 0;
+    for (size_t f = 0; f < report->files_count && n < report->totals.files_with_offenses; ++f)
+    {
+        if (report->file_offenses[f])
+        {
+            rows[n++] = (leuko_cli_count_row_t){.count = report->file_offenses[f], .key = f, .category = NULL, .name = report->files[f]};
+        }
+    }
+    bool ok = leuko_cli_render_count_table(report, rows, n, out);
+    free(rows);
+    return ok;
+}
+
+/* clang-format off */
+const leuko_cli_formatter_ops_t leuko_cli_formatter_progress_ops        = {leuko_cli_progress_begin, leuko_cli_progress_file,  leuko_cli_progress_end};
+const leuko_cli_formatter_ops_t leuko_cli_formatter_auto_gen_ops        = {leuko_cli_progress_begin, leuko_cli_progress_file,  leuko_cli_progress_end};
+const leuko_cli_formatter_ops_t leuko_cli_formatter_pacman_ops          = {leuko_cli_pacman_begin,   leuko_cli_pacman_file,    leuko_cli_progress_end};
+const leuko_cli_formatter_ops_t leuko_cli_formatter_clang_ops           = {NULL,                     leuko_cli_clang_file,     leuko_cli_summary_end};
+const leuko_cli_formatter_ops_t leuko_cli_formatter_fuubar_ops          = {NULL,                     leuko_cli_clang_file,     leuko_cli_summary_end};
+const leuko_cli_formatter_ops_t leuko_cli_formatter_emacs_ops           = {NULL,                     leuko_cli_emacs_file,     NULL};
+const leuko_cli_formatter_ops_t leuko_cli_formatter_simple_ops          = {NULL,                     leuko_cli_simple_file,    leuko_cli_summary_end};
+const leuko_cli_formatter_ops_t leuko_cli_formatter_quiet_ops           = {NULL,                     leuko_cli_simple_file,    leuko_cli_quiet_end};
+const leuko_cli_formatter_ops_t leuko_cli_formatter_file_list_ops       = {NULL,                     leuko_cli_file_list_file, NULL};
+const leuko_cli_formatter_ops_t leuko_cli_formatter_tap_ops             = {leuko_cli_tap_begin,      leuko_cli_tap_file,       leuko_cli_summary_end};
+const leuko_cli_formatter_ops_t leuko_cli_formatter_github_ops          = {NULL,                     leuko_cli_github_file,    NULL};
+const leuko_cli_formatter_ops_t leuko_cli_formatter_offense_count_ops   = {NULL,                     NULL,                     leuko_cli_offense_count_end};
+const leuko_cli_formatter_ops_t leuko_cli_formatter_worst_offenders_ops = {NULL,                     NULL,                     leuko_cli_worst_offenders_end};
+/* clang-format on */
@@ -5,6 +5,7 @@
 #include "cli/parser.h"
 #include "cli/formatter.h"
 #include "common/registry.h"
+#include "utils/string_array.h"
 #include "version.h"
 
 /**
@@ -17,13 +18,28 @@ static void print_help(void)
     printf("  -a, --auto-correct          Automatically fix safe issues\n");
     printf("  -A, --auto-correct-all      Automatically fix all issues (including unsafe)\n");
     printf("  -c, --config <path>         Specify configuration file path\n");
+    printf("      --changed-since <rev>   Only lint files changed since a git revision\n");
+    printf("      --changed-lines         With --changed-since, only report offenses on changed lines\n");
     printf("      --except <rule1,rule2>  Exclude specific rules\n");
+    printf("      --exit-code-only        Print nothing; exit with 1 as soon as any diagnostic at or above the fail level is found\n");
+    printf("      --fail-level <severity> Minimum severity that makes the exit code non-zero (default: refactor)\n");
     printf("  -x, --fix-layout            Fix layout issues (safe only)\n");
-    printf("  -f, --format <format>       Specify output format (text, json)\n");
+    printf("  -f, --format <format>       Specify output format (default: " LEUKO_CLI_FORMATTER_NAME_PROGRESS "), one of:\n");
+    printf("                              " LEUKO_CLI_FORMATTER_NAME_PROGRESS ", " LEUKO_CLI_FORMATTER_NAME_AUTO_GEN ", " LEUKO_CLI_FORMATTER_NAME_CLANG_STYLE
+           ", " LEUKO_CLI_FORMATTER_NAME_FUUBAR_STYLE ", " LEUKO_CLI_FORMATTER_NAME_PACMAN_STYLE ", " LEUKO_CLI_FORMATTER_NAME_EMACS_STYLE ",\n");
+    printf("                              " LEUKO_CLI_FORMATTER_NAME_SIMPLE ", " LEUKO_CLI_FORMATTER_NAME_QUIET ", " LEUKO_CLI_FORMATTER_NAME_FILE_LIST
+           ", " LEUKO_CLI_FORMATTER_NAME_JSON ", " LEUKO_CLI_FORMATTER_NAME_JUNIT_STYLE ", " LEUKO_CLI_FORMATTER_NAME_OFFENCE_COUNT
+           ", " LEUKO_CLI_FORMATTER_NAME_WORST_OFFENDERS ",\n");
+    printf("                              " LEUKO_CLI_FORMATTER_NAME_HTML ", " LEUKO_CLI_FORMATTER_NAME_MARKDOWN ", " LEUKO_CLI_FORMATTER_NAME_TAP
+           ", " LEUKO_CLI_FORMATTER_NAME_GITHUB_ACTIONS ", " LEUKO_CLI_FORMATTER_NAME_DIFF " (corrections as a unified diff)\n");
+    printf("      --fsync                 Sync corrected files to disk before exiting\n");
     printf("  -h, --help                  Show this help message\n");
     printf("  -v, --version               Show version information\n");
     printf("      --only <rule1,rule2>    Only include specific rules\n");
     printf("      --parallel              Enable automatic parallel execution (set jobs to CPU count)\n");
+    printf("      --profile-rules[=json|table]\n");
+    printf("                              Print time, calls and offenses per rule to stderr, slowest first (default: table)\n");
+    printf("      --trace <path>          Write a timeline of every file's stages per worker (Chrome trace format)\n");
     printf("      --init                  Initialize .leukocyte directory and templates (README, gitignore.template)\n");
     printf("      --sync                  Regenerate .leukocyte.resolved.json by searching for .rubocop.yml in the current directory or its parents\n");
 }
@@ -57,6 +73,8 @@ static bool leuko_cli_options_initialize(leuko_cli_options_t *cli_opts)
     cli_opts->except_count = 0;
     cli_opts->fix_mode = LEUKO_FIX_MODE_NONE;
     cli_opts->parallel = false;
+    cli_opts->fail_level = LEUKO_SEVERITY_REFACTOR;
+    cli_opts->exit_code_only = false;
     return true;
 }
 
@@ -78,16 +96,23 @@ leuko_parse_result_t leuko_cli_options_parse(int argc, char *argv[], leuko_cli_o
         /* clang-format off */
         {"auto-correct"    , no_argument      , 0, 'a'},
         {"auto-correct-all", no_argument      , 0, 'A'},
+        {"changed-lines"   , no_argument      , 0, 0  },
+        {"changed-since"   , required_argument, 0, 0  },
         {"config"          , required_argument, 0, 'c'},
         {"except"          , required_argument, 0, 0  },
+        {"exit-code-only"  , no_argument      , 0, 0  },
+        {"fail-level"      , required_argument, 0, 0  },
         {"fix-layout"      , no_argument      , 0, 'x'},
         {"format"          , required_argument, 0, 'f'},
+        {"fsync"           , no_argument      , 0, 0  },
         {"help"            , no_argument      , 0, 'h'},
         {"only"            , required_argument, 0, 0  },
         {"version"         , no_argument      , 0, 'v'},
         {"parallel"        , no_argument      , 0, 0  },
+        {"profile-rules"   , optional_argument, 0, 0  },
         {"init"            , no_argument      , 0, 0  },
         {"sync"            , no_argument      , 0, 0  },
+        {"trace"           , required_argument, 0, 0  },
         {0, 0, 0, 0}
         /* clang-format on */
     };
@@ -173,10 +198,57 @@ leuko_parse_result_t leuko_cli_options_parse(int argc, char *argv[], leuko_cli_o
                     free(tmp);
                 }
             }
+            if (strcmp(long_options[option_index].name, "exit-code-only") == 0)
+            {
+                cli_opts->exit_code_only = true;
+            }
+            if (strcmp(long_options[option_index].name, "fail-level") == 0)
+            {
+                if (!leuko_severity_from_string(optarg, &cli_opts->fail_level))
+                {
+                    fprintf(stderr, "Invalid severity: %s\n", optarg);
+                    return LEUKO_CLI_OPTIONS_PARSE_ERROR;
+                }
+            }
+            if (strcmp(long_options[option_index].name, "changed-since") == 0)
+            {
+                free(cli_opts->changed_since);
+                cli_opts->changed_since = strdup(optarg);
+            }
+            if (strcmp(long_options[option_index].name, "changed-lines") == 0)
+            {
+                cli_opts->changed_lines = true;
+            }
+            if (strcmp(long_options[option_index].name, "fsync") == 0)
+            {
+                cli_opts->fsync = true;
+            }
             if (strcmp(long_options[option_index].name, "parallel") == 0)
             {
                 cli_opts->parallel = true;
             }
+            if (strcmp(long_options[option_index].name, "profile-rules") == 0)
+            {
+                cli_opts->profile_rules = true;
+                if (!optarg || strcmp(optarg, "table") == 0)
+                {
+                    cli_opts->profile_format = LEUKO_RULE_PROFILE_TABLE;
+                }
+                else if (strcmp(optarg, "json") == 0)
+                {
+                    cli_opts->profile_format = LEUKO_RULE_PROFILE_JSON;
+                }
+                else
+                {
+                    fprintf(stderr, "Invalid profile format: %s\n", optarg);
+                    return LEUKO_CLI_OPTIONS_PARSE_ERROR;
+                }
+            }
+            if (strcmp(long_options[option_index].name, "trace") == 0)
+            {
+                free(cli_opts->trace_path);
+                cli_opts->trace_path = strdup(optarg);
+            }
             if (strcmp(long_options[option_index].name, "init") == 0)
             {
                 cli_opts->init = true;
@@ -193,6 +265,12 @@ leuko_parse_result_t leuko_cli_options_parse(int argc, char *argv[], leuko_cli_o
         }
     }
 
+    if (cli_opts->changed_lines && !cli_opts->changed_since)
+    {
+        fprintf(stderr, "--changed-lines requires --changed-since\n");
+        return LEUKO_CLI_OPTIONS_PARSE_ERROR;
+    }
+
     // Remaining args are paths, if any.
     if (optind < argc)
     {
@@ -232,4 +310,6 @@ void leuko_cli_options_free(leuko_cli_options_t *opts)
     }
     free(opts->except);
     free(opts->config_path);
+    free(opts->changed_since);
+    free(opts->trace_path);
 }
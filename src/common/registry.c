@@ -0,0 +1,126 @@
+#include "prism.h"
+#include "common/registry.h"
+
+/**
+ * @brief Node type list of an AST input entry.
+ */
+#define LEUKO_RULE_NODES(...) \
+    .node_types = (const uint16_t[]){__VA_ARGS__}, .node_type_count = sizeof((const uint16_t[]){__VA_ARGS__}) / sizeof(uint16_t)
+
+/**
+ * @brief Registry entry of a rule, at the index of its id.
+ */
+#define LEUKO_RULE_INFO(ID, CATEGORY, INPUT, AUTOCORRECTABLE, SAFE, ...)                                                             \
+    [LEUKO_RULE_ID_##ID] = {.id = LEUKO_RULE_ID_##ID, .category = LEUKO_RULE_CATEGORY_NAME_##CATEGORY, .name = LEUKO_RULE_NAME_##ID, \
+                            .input = LEUKO_RULE_INPUT_##INPUT, .autocorrectable = AUTOCORRECTABLE, .safe_autocorrect = SAFE, __VA_ARGS__}
+
+/**
+ * @brief Scheduling facts of every registered rule.
+ * @note Implemented rules must agree with their `leuko_rule_t` definition.
+ *       For the others, the input and node types are the ones the rule
+ *       will be written against (the RuboCop cop's hooks, in Prism terms).
+ */
+const leuko_rule_info_t leuko_rule_registry[LEUKO_RULE_ID_COUNT] = {
+    /* clang-format off */
+    LEUKO_RULE_INFO(ACCESS_MODIFIER_INDENTATION,                    LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CLASS_NODE, PM_MODULE_NODE, PM_SINGLETON_CLASS_NODE, PM_BLOCK_NODE)),
+    LEUKO_RULE_INFO(ARGUMENT_ALIGNMENT,                             LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE, PM_SUPER_NODE)),
+    LEUKO_RULE_INFO(ARRAY_ALIGNMENT,                                LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_ARRAY_NODE)),
+    LEUKO_RULE_INFO(ASSIGNMENT_INDENTATION,                         LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_LOCAL_VARIABLE_WRITE_NODE, PM_INSTANCE_VARIABLE_WRITE_NODE, PM_CLASS_VARIABLE_WRITE_NODE, PM_GLOBAL_VARIABLE_WRITE_NODE, PM_CONSTANT_WRITE_NODE, PM_CONSTANT_PATH_WRITE_NODE, PM_MULTI_WRITE_NODE)),
+    LEUKO_RULE_INFO(BEGIN_END_ALIGNMENT,                            LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_BEGIN_NODE)),
+    LEUKO_RULE_INFO(BLOCK_ALIGNMENT,                                LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_BLOCK_NODE, PM_LAMBDA_NODE)),
+    LEUKO_RULE_INFO(BLOCK_END_NEWLINE,                              LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_BLOCK_NODE, PM_LAMBDA_NODE)),
+    LEUKO_RULE_INFO(CASE_INDENTATION,                               LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CASE_NODE, PM_CASE_MATCH_NODE)),
+    LEUKO_RULE_INFO(CLASS_STRUCTURE,                                LAYOUT, AST,    true , false, LEUKO_RULE_NODES(PM_CLASS_NODE, PM_SINGLETON_CLASS_NODE)),
+    LEUKO_RULE_INFO(CLOSING_HEREDOC_INDENTATION,                    LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_STRING_NODE, PM_INTERPOLATED_STRING_NODE, PM_X_STRING_NODE, PM_INTERPOLATED_X_STRING_NODE)),
+    LEUKO_RULE_INFO(CLOSING_PARENTHESIS_INDENTATION,                LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE, PM_SUPER_NODE, PM_DEF_NODE, PM_PARENTHESES_NODE)),
+    LEUKO_RULE_INFO(COMMENT_INDENTATION,                            LAYOUT, TOKENS, true , true ),
+    LEUKO_RULE_INFO(CONDITION_POSITION,                             LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_IF_NODE, PM_UNLESS_NODE, PM_WHILE_NODE, PM_UNTIL_NODE)),
+    LEUKO_RULE_INFO(DEF_END_ALIGNMENT,                              LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_DEF_NODE)),
+    LEUKO_RULE_INFO(DOT_POSITION,                                   LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE)),
+    LEUKO_RULE_INFO(ELSE_ALIGNMENT,                                 LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_IF_NODE, PM_UNLESS_NODE, PM_CASE_NODE, PM_CASE_MATCH_NODE, PM_BEGIN_NODE)),
+    LEUKO_RULE_INFO(EMPTY_COMMENT,                                  LAYOUT, TOKENS, true , true ),
+    LEUKO_RULE_INFO(EMPTY_LINE_AFTER_GUARD_CLAUSE,                  LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_IF_NODE, PM_UNLESS_NODE)),
+    LEUKO_RULE_INFO(EMPTY_LINE_AFTER_MAGIC_COMMENT,                 LAYOUT, TOKENS, true , true ),
+    LEUKO_RULE_INFO(EMPTY_LINE_AFTER_MULTILINE_CONDITION,           LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_IF_NODE, PM_UNLESS_NODE, PM_WHILE_NODE, PM_UNTIL_NODE, PM_WHEN_NODE, PM_RESCUE_NODE)),
+    LEUKO_RULE_INFO(EMPTY_LINE_BETWEEN_DEFS,                        LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_STATEMENTS_NODE)),
+    LEUKO_RULE_INFO(EMPTY_LINES,                                    LAYOUT, TOKENS, true , true ),
+    LEUKO_RULE_INFO(EMPTY_LINES_AFTER_MODULE_INCLUSION,             LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE)),
+    LEUKO_RULE_INFO(EMPTY_LINES_AROUND_ACCESS_MODIFIER,             LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE)),
+    LEUKO_RULE_INFO(EMPTY_LINES_AROUND_ARGUMENTS,                   LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE)),
+    LEUKO_RULE_INFO(EMPTY_LINES_AROUND_ATTRIBUTE_ACCESSOR,          LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE)),
+    LEUKO_RULE_INFO(EMPTY_LINES_AROUND_BEGIN_BODY,                  LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_BEGIN_NODE)),
+    LEUKO_RULE_INFO(EMPTY_LINES_AROUND_BLOCK_BODY,                  LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_BLOCK_NODE, PM_LAMBDA_NODE)),
+    LEUKO_RULE_INFO(EMPTY_LINES_AROUND_CLASS_BODY,                  LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CLASS_NODE, PM_SINGLETON_CLASS_NODE)),
+    LEUKO_RULE_INFO(EMPTY_LINES_AROUND_EXCEPTION_HANDLING_KEYWORDS, LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_DEF_NODE, PM_BLOCK_NODE, PM_BEGIN_NODE)),
+    LEUKO_RULE_INFO(EMPTY_LINES_AROUND_METHOD_BODY,                 LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_DEF_NODE)),
+    LEUKO_RULE_INFO(EMPTY_LINES_AROUND_MODULE_BODY,                 LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_MODULE_NODE)),
+    LEUKO_RULE_INFO(END_ALIGNMENT,                                  LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CLASS_NODE, PM_MODULE_NODE, PM_SINGLETON_CLASS_NODE, PM_IF_NODE, PM_UNLESS_NODE, PM_WHILE_NODE, PM_UNTIL_NODE, PM_CASE_NODE, PM_CASE_MATCH_NODE)),
+    LEUKO_RULE_INFO(END_OF_LINE,                                    LAYOUT, LINES,  false, false),
+    LEUKO_RULE_INFO(EXTRA_SPACING,                                  LAYOUT, TOKENS, true , true ),
+    LEUKO_RULE_INFO(FIRST_ARGUMENT_INDENTATION,                     LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE, PM_SUPER_NODE)),
+    LEUKO_RULE_INFO(FIRST_ARRAY_ELEMENT_INDENTATION,                LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_ARRAY_NODE)),
+    LEUKO_RULE_INFO(FIRST_ARRAY_ELEMENT_LINE_BREAK,                 LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_ARRAY_NODE)),
+    LEUKO_RULE_INFO(FIRST_HASH_ELEMENT_INDENTATION,                 LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_HASH_NODE, PM_KEYWORD_HASH_NODE)),
+    LEUKO_RULE_INFO(FIRST_HASH_ELEMENT_LINE_BREAK,                  LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_HASH_NODE)),
+    LEUKO_RULE_INFO(FIRST_METHOD_ARGUMENT_LINE_BREAK,               LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE, PM_SUPER_NODE)),
+    LEUKO_RULE_INFO(FIRST_METHOD_PARAMETER_LINE_BREAK,              LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_DEF_NODE)),
+    LEUKO_RULE_INFO(FIRST_PARAMETER_INDENTATION,                    LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_DEF_NODE)),
+    LEUKO_RULE_INFO(HASH_ALIGNMENT,                                 LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_HASH_NODE, PM_KEYWORD_HASH_NODE)),
+    LEUKO_RULE_INFO(HEREDOC_ARGUMENT_CLOSING_PARENTHESIS,           LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE)),
+    LEUKO_RULE_INFO(HEREDOC_INDENTATION,                            LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_STRING_NODE, PM_INTERPOLATED_STRING_NODE, PM_X_STRING_NODE, PM_INTERPOLATED_X_STRING_NODE)),
+    LEUKO_RULE_INFO(INDENTATION_CONSISTENCY,                        LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_STATEMENTS_NODE)),
+    LEUKO_RULE_INFO(INDENTATION_STYLE,                              LAYOUT, LINES,  true , true ),
+    LEUKO_RULE_INFO(INDENTATION_WIDTH,                              LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CLASS_NODE, PM_MODULE_NODE, PM_SINGLETON_CLASS_NODE, PM_DEF_NODE, PM_BLOCK_NODE, PM_LAMBDA_NODE, PM_IF_NODE, PM_UNLESS_NODE, PM_WHILE_NODE, PM_UNTIL_NODE, PM_FOR_NODE, PM_CASE_NODE, PM_CASE_MATCH_NODE, PM_BEGIN_NODE)),
+    LEUKO_RULE_INFO(LINE_LENGTH,                                    LAYOUT, LINES,  false, false),
+    LEUKO_RULE_INFO(INITIAL_INDENTATION,                            LAYOUT, TOKENS, true , true ),
+    LEUKO_RULE_INFO(LEADING_COMMENT_SPACE,                          LAYOUT, TOKENS, true , true ),
+    LEUKO_RULE_INFO(LEADING_EMPTY_LINES,                            LAYOUT, TOKENS, true , true ),
+    LEUKO_RULE_INFO(LINE_CONTINUATION_LEADING_SPACE,                LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_INTERPOLATED_STRING_NODE)),
+    LEUKO_RULE_INFO(LINE_CONTINUATION_SPACING,                      LAYOUT, LINES,  true , true ),
+    LEUKO_RULE_INFO(LINE_END_STRING_CONCATENATION_INDENTATION,      LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_INTERPOLATED_STRING_NODE)),
+    LEUKO_RULE_INFO(MULTILINE_ARRAY_BRACE_LAYOUT,                   LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_ARRAY_NODE)),
+    LEUKO_RULE_INFO(MULTILINE_ARRAY_LINE_BREAKS,                    LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_ARRAY_NODE)),
+    LEUKO_RULE_INFO(MULTILINE_ASSIGNMENT_LAYOUT,                    LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_LOCAL_VARIABLE_WRITE_NODE, PM_INSTANCE_VARIABLE_WRITE_NODE, PM_CLASS_VARIABLE_WRITE_NODE, PM_GLOBAL_VARIABLE_WRITE_NODE, PM_CONSTANT_WRITE_NODE, PM_CONSTANT_PATH_WRITE_NODE, PM_MULTI_WRITE_NODE)),
+    LEUKO_RULE_INFO(MULTILINE_BLOCK_LAYOUT,                         LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_BLOCK_NODE, PM_LAMBDA_NODE)),
+    LEUKO_RULE_INFO(MULTILINE_HASH_BRACE_LAYOUT,                    LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_HASH_NODE)),
+    LEUKO_RULE_INFO(MULTILINE_HASH_KEY_LINE_BREAKS,                 LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_HASH_NODE)),
+    LEUKO_RULE_INFO(MULTILINE_METHOD_ARGUMENT_LINE_BREAKS,          LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE)),
+    LEUKO_RULE_INFO(MULTILINE_METHOD_CALL_BRACE_LAYOUT,             LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE)),
+    LEUKO_RULE_INFO(MULTILINE_METHOD_CALL_INDENTATION,              LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE)),
+    LEUKO_RULE_INFO(MULTILINE_METHOD_DEFINITION_BRACE_LAYOUT,       LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_DEF_NODE)),
+    LEUKO_RULE_INFO(MULTILINE_METHOD_PARAMETER_LINE_BREAKS,         LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_DEF_NODE)),
+    LEUKO_RULE_INFO(MULTILINE_OPERATION_INDENTATION,                LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_AND_NODE, PM_OR_NODE, PM_CALL_NODE)),
+    LEUKO_RULE_INFO(PARAMETER_ALIGNMENT,                            LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_DEF_NODE)),
+    LEUKO_RULE_INFO(REDUNDANT_LINE_BREAK,                           LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE, PM_AND_NODE, PM_OR_NODE, PM_LOCAL_VARIABLE_WRITE_NODE, PM_INSTANCE_VARIABLE_WRITE_NODE)),
+    LEUKO_RULE_INFO(RESCUE_ENSURE_ALIGNMENT,                        LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_RESCUE_NODE, PM_ENSURE_NODE)),
+    LEUKO_RULE_INFO(SINGLE_LINE_BLOCK_CHAIN,                        LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE)),
+    LEUKO_RULE_INFO(SPACE_AFTER_COLON,                              LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_ASSOC_NODE, PM_OPTIONAL_KEYWORD_PARAMETER_NODE)),
+    LEUKO_RULE_INFO(SPACE_AFTER_COMMA,                              LAYOUT, TOKENS, true , true ),
+    LEUKO_RULE_INFO(SPACE_AFTER_METHOD_NAME,                        LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_DEF_NODE)),
+    LEUKO_RULE_INFO(SPACE_AFTER_NOT,                                LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE)),
+    LEUKO_RULE_INFO(SPACE_AFTER_SEMICOLON,                          LAYOUT, TOKENS, true , true ),
+    LEUKO_RULE_INFO(SPACE_AROUND_BLOCK_PARAMETERS,                  LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_BLOCK_NODE)),
+    LEUKO_RULE_INFO(SPACE_AROUND_EQUALS_IN_PARAMETER_DEFAULT,       LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_OPTIONAL_PARAMETER_NODE)),
+    LEUKO_RULE_INFO(SPACE_AROUND_KEYWORD,                           LAYOUT, TOKENS, true , true ),
+    LEUKO_RULE_INFO(SPACE_AROUND_METHOD_CALL_OPERATOR,              LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE, PM_CONSTANT_PATH_NODE)),
+    LEUKO_RULE_INFO(SPACE_AROUND_OPERATORS,                         LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE, PM_AND_NODE, PM_OR_NODE, PM_ASSOC_NODE, PM_IF_NODE, PM_RESCUE_MODIFIER_NODE, PM_LOCAL_VARIABLE_WRITE_NODE, PM_INSTANCE_VARIABLE_WRITE_NODE, PM_CLASS_VARIABLE_WRITE_NODE, PM_GLOBAL_VARIABLE_WRITE_NODE, PM_CONSTANT_WRITE_NODE, PM_MULTI_WRITE_NODE)),
+    LEUKO_RULE_INFO(SPACE_BEFORE_BLOCK_BRACES,                      LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_BLOCK_NODE)),
+    LEUKO_RULE_INFO(SPACE_BEFORE_BRACKETS,                          LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE)),
+    LEUKO_RULE_INFO(SPACE_BEFORE_COMMA,                             LAYOUT, TOKENS, true , true ),
+    LEUKO_RULE_INFO(SPACE_BEFORE_COMMENT,                           LAYOUT, TOKENS, true , true ),
+    LEUKO_RULE_INFO(SPACE_BEFORE_FIRST_ARG,                         LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE)),
+    LEUKO_RULE_INFO(SPACE_BEFORE_SEMICOLON,                         LAYOUT, TOKENS, true , true ),
+    LEUKO_RULE_INFO(SPACE_IN_LAMBDA_LITERAL,                        LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_LAMBDA_NODE)),
+    LEUKO_RULE_INFO(SPACE_INSIDE_ARRAY_LITERAL_BRACKETS,            LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_ARRAY_NODE)),
+    LEUKO_RULE_INFO(SPACE_INSIDE_ARRAY_PERCENT_LITERAL,             LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_ARRAY_NODE)),
+    LEUKO_RULE_INFO(SPACE_INSIDE_BLOCK_BRACES,                      LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_BLOCK_NODE)),
+    LEUKO_RULE_INFO(SPACE_INSIDE_HASH_LITERAL_BRACES,               LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_HASH_NODE)),
+    LEUKO_RULE_INFO(SPACE_INSIDE_PARENS,                            LAYOUT, TOKENS, true , true ),
+    LEUKO_RULE_INFO(SPACE_INSIDE_PERCENT_LITERAL_DELIMITERS,        LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_ARRAY_NODE, PM_X_STRING_NODE, PM_INTERPOLATED_X_STRING_NODE)),
+    LEUKO_RULE_INFO(SPACE_INSIDE_RANGE_LITERAL,                     LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_RANGE_NODE)),
+    LEUKO_RULE_INFO(SPACE_INSIDE_REFERENCE_BRACKETS,                LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_CALL_NODE)),
+    LEUKO_RULE_INFO(SPACE_INSIDE_STRING_INTERPOLATION,              LAYOUT, AST,    true , true , LEUKO_RULE_NODES(PM_EMBEDDED_STATEMENTS_NODE)),
+    LEUKO_RULE_INFO(TRAILING_EMPTY_LINES,                           LAYOUT, BYTES,  true , true ),
+    LEUKO_RULE_INFO(TRAILING_WHITESPACE,                            LAYOUT, LINES,  true , true ),
+    /* clang-format on */
+};
@@ -0,0 +1,60 @@
+#include <string.h>
+#include "common/severity.h"
+
+/**
+ * @brief Mapping of severity names to enum values.
+ */
+static const struct
+{
+    const char *str;
+    const leuko_severity_t severity;
+} map[] = {
+    /* clang-format off */
+    {LEUKO_SEVERITY_NAME_INFO      , LEUKO_SEVERITY_INFO      },
+    {LEUKO_SEVERITY_NAME_REFACTOR  , LEUKO_SEVERITY_REFACTOR  },
+    {LEUKO_SEVERITY_NAME_CONVENTION, LEUKO_SEVERITY_CONVENTION},
+    {LEUKO_SEVERITY_NAME_WARNING   , LEUKO_SEVERITY_WARNING   },
+    {LEUKO_SEVERITY_NAME_ERROR     , LEUKO_SEVERITY_ERROR     },
+    {LEUKO_SEVERITY_NAME_FATAL     , LEUKO_SEVERITY_FATAL     },
+    /* clang-format on */
+};
+
+/**
+ * @brief Convert string to leuko_severity_t enum value.
+ * @param str Input string (severity name, or its single-letter code)
+ * @param out Output parameter to store the corresponding leuko_severity_t value
+ * @return true if conversion was successful, false otherwise
+ */
+bool leuko_severity_from_string(const char *str, leuko_severity_t *out)
+{
+    if (!str)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < sizeof(map) / sizeof(map[0]); ++i)
+    {
+        if (strcmp(str, map[i].str) == 0 || (str[0] == leuko_severity_code(map[i].severity) && str[1] == '\0'))
+        {
+            *out = map[i].severity;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Convert leuko_severity_t enum value to its name.
+ * @param severity Severity level
+ * @return Severity name (e.g. "convention"), or "unknown"
+ */
+const char *leuko_severity_to_string(leuko_severity_t severity)
+{
+    for (size_t i = 0; i < sizeof(map) / sizeof(map[0]); ++i)
+    {
+        if (map[i].severity == severity)
+        {
+            return map[i].str;
+        }
+    }
+    return "unknown";
+}
@@ -0,0 +1,173 @@
+#include <stdlib.h>
+#include <string.h>
+#include "diagnostics/diagnostic_buffer.h"
+
+/**
+ * @brief Initial number of slots allocated on first push.
+ * @note Sized so that typical files never grow the buffer at all.
+ */
+#define LEUKO_DIAGNOSTIC_BUFFER_INITIAL_CAPACITY 256
+
+/**
+ * @brief Bytes needed per diagnostic across all columns.
+ */
+#define LEUKO_DIAGNOSTIC_BUFFER_ROW_SIZE (sizeof(int32_t) * LEUKO_DIAGNOSTIC_ARG_MAX + sizeof(uint32_t) * 2 + sizeof(leuko_rule_id_t) + sizeof(uint8_t) * 2 + sizeof(leuko_message_id_t))
+
+/**
+ * @brief Point the column arrays into a backing block.
+ * @param buf Pointer to the diagnostic buffer
+ * @param block Backing allocation
+ * @param capacity Number of slots per column
+ * @note Columns are laid out from widest to narrowest to keep them aligned.
+ */
+static void leuko_diagnostic_buffer_layout(leuko_diagnostic_buffer_t *buf, void *block, size_t capacity)
+{
+    char *p = block;
+    buf->args = (int32_t *)p;
+    p += capacity * sizeof(int32_t) * LEUKO_DIAGNOSTIC_ARG_MAX;
+    buf->begin_offsets = (uint32_t *)p;
+    p += capacity * sizeof(uint32_t);
+    buf->end_offsets = (uint32_t *)p;
+    p += capacity * sizeof(uint32_t);
+    buf->rule_ids = (leuko_rule_id_t *)p;
+    p += capacity * sizeof(leuko_rule_id_t);
+    buf->severities = (uint8_t *)p;
+    p += capacity * sizeof(uint8_t);
+    buf->message_ids = (leuko_message_id_t *)p;
+    p += capacity * sizeof(leuko_message_id_t);
+    buf->flags = (uint8_t *)p;
+    buf->block = block;
+    buf->capacity = capacity;
+}
+
+/**
+ * @brief Initialize an empty diagnostic buffer (no allocation).
+ * @param buf Pointer to the diagnostic buffer
+ */
+void leuko_diagnostic_buffer_init(leuko_diagnostic_buffer_t *buf)
+{
+    memset(buf, 0, sizeof(*buf));
+}
+
+/**
+ * @brief Ensure the buffer can hold at least `capacity` diagnostics.
+ * @param buf Pointer to the diagnostic buffer
+ * @param capacity Required number of slots
+ * @return true on success, false on allocation failure
+ */
+bool leuko_diagnostic_buffer_reserve(leuko_diagnostic_buffer_t *buf, size_t capacity)
+{
+    if (capacity <= buf->capacity)
+    {
+        return true;
+    }
+    void *block = malloc(capacity * LEUKO_DIAGNOSTIC_BUFFER_ROW_SIZE);
+    if (!block)
+    {
+        return false;
+    }
+    leuko_diagnostic_buffer_t old = *buf;
+    leuko_diagnostic_buffer_layout(buf, block, capacity);
+    if (old.count > 0)
+    {
+        memcpy(buf->begin_offsets, old.begin_offsets, old.count * sizeof(uint32_t));
+        memcpy(buf->end_offsets, old.end_offsets, old.count * sizeof(uint32_t));
+        memcpy(buf->rule_ids, old.rule_ids, old.count * sizeof(leuko_rule_id_t));
+        memcpy(buf->severities, old.severities, old.count * sizeof(uint8_t));
+        memcpy(buf->message_ids, old.message_ids, old.count * sizeof(leuko_message_id_t));
+        memcpy(buf->flags, old.flags, old.count * sizeof(uint8_t));
+        memcpy(buf->args, old.args, old.count * sizeof(int32_t) * LEUKO_DIAGNOSTIC_ARG_MAX);
+    }
+    free(old.block);
+    return true;
+}
+
+/**
+ * @brief Grow the buffer geometrically (slow path of push).
+ * @param buf Pointer to the diagnostic buffer
+ * @return true on success, false on allocation failure
+ */
+bool leuko_diagnostic_buffer_grow(leuko_diagnostic_buffer_t *buf)
+{
+    size_t capacity = buf->capacity ? buf->capacity * 2 : LEUKO_DIAGNOSTIC_BUFFER_INITIAL_CAPACITY;
+    return leuko_diagnostic_buffer_reserve(buf, capacity);
+}
+
+/**
+ * @brief Drop all diagnostics but keep the allocation for the next file.
+ * @param buf Pointer to the diagnostic buffer
+ */
+void leuko_diagnostic_buffer_clear(leuko_diagnostic_buffer_t *buf)
+{
+    buf->count = 0;
+}
+
+/**
+ * @brief Compare two packed (offset, index) sort keys.
+ */
+static int leuko_diagnostic_key_cmp(const void *a, const void *b)
+{
+    uint64_t ka = *(const uint64_t *)a;
+    uint64_t kb = *(const uint64_t *)b;
+    return (ka > kb) - (ka < kb);
+}
+
+/**
+ * @brief Compute the output order of the diagnostics.
+ * @param buf Pointer to the diagnostic buffer
+ * @param out_order Output: malloc'd array of `buf->count` indices (caller frees)
+ * @return true on success, false on allocation failure
+ * @note Diagnostics are ordered by begin offset (hence line, then column);
+ *       ties keep insertion order, i.e. rule execution order.
+ */
+bool leuko_diagnostic_buffer_sorted_order(const leuko_diagnostic_buffer_t *buf, uint32_t **out_order)
+{
+    *out_order = NULL;
+    if (buf->count == 0)
+    {
+        return true;
+    }
+    uint64_t *keys = malloc(buf->count * sizeof(uint64_t));
+    uint32_t *order = malloc(buf->count * sizeof(uint32_t));
+    if (!keys || !order)
+    {
+        free(keys);
+        free(order);
+        return false;
+    }
+
+    bool sorted = true;
+    for (size_t i = 0; i < buf->count; ++i)
+    {
+        keys[i] = ((uint64_t)buf->begin_offsets[i] << 32) | (uint64_t)i;
+        if (i > 0 && keys[i] < keys[i - 1])
+        {
+            sorted = false;
+        }
+    }
+    if (!sorted)
+    {
+        qsort(keys, buf->count, sizeof(uint64_t), leuko_diagnostic_key_cmp);
+    }
+    for (size_t i = 0; i < buf->count; ++i)
+    {
+        order[i] = (uint32_t)(keys[i] & 0xFFFFFFFFu);
+    }
+    free(keys);
+    *out_order = order;
+    return true;
+}
+
+/**
+ * @brief Free memory owned by the buffer.
+ * @param buf Pointer to the diagnostic buffer
+ */
+void leuko_diagnostic_buffer_free(leuko_diagnostic_buffer_t *buf)
+{
+    if (!buf)
+    {
+        return;
+    }
+    free(buf->block);
+    memset(buf, 0, sizeof(*buf));
+}
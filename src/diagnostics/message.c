@@ -0,0 +1,52 @@
+#include <stdio.h>
+#include <string.h>
+#include "diagnostics/message.h"
+
+/**
+ * @brief Render a message template into a caller-provided buffer.
+ * @param tmpl Template text; `%d` is replaced by the next argument, `%%` by '%'
+ * @param args Message arguments
+ * @param arg_count Number of arguments available
+ * @param out Output buffer (always NUL-terminated when out_size > 0)
+ * @param out_size Size of the output buffer
+ * @return Length of the rendered message (may exceed out_size - 1 if truncated)
+ * @note Templates are fixed strings interned by each rule, so this is the only
+ *       place message text is produced, and only when a formatter asks for it.
+ */
+size_t leuko_message_render(const char *tmpl, const int32_t *args, size_t arg_count, char *out, size_t out_size)
+{
+    size_t len = 0;
+    size_t next_arg = 0;
+    for (const char *p = tmpl; *p; ++p)
+    {
+        char num[16];
+        const char *piece = p;
+        size_t piece_len = 1;
+        if (p[0] == '%' && p[1] == 'd')
+        {
+            int32_t v = next_arg < arg_count ? args[next_arg] : 0;
+            ++next_arg;
+            piece_len = (size_t)snprintf(num, sizeof(num), "%d", (int)v);
+            piece = num;
+            ++p;
+        }
+        else if (p[0] == '%' && p[1] == '%')
+        {
+            ++p;
+        }
+        if (len + piece_len < out_size)
+        {
+            memcpy(out + len, piece, piece_len);
+        }
+        else if (len < out_size)
+        {
+            memcpy(out + len, piece, out_size - 1 - len);
+        }
+        len += piece_len;
+    }
+    if (out_size > 0)
+    {
+        out[len < out_size ? len : out_size - 1] = '\0';
+    }
+    return len;
+}
@@ -0,0 +1,991 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "prism.h"
+#include "engine/engine.h"
+#include "engine/profile.h"
+#include "engine/trace.h"
+#include "quickfix/change_map.h"
+#include "quickfix/edit_list.h"
+#include "rules/rule.h"
+#include "sources/signature.h"
+#include "engine/write_back.h"
+#include "leuko_debug.h"
+#include "utils/clock.h"
+#include "utils/file.h"
+#include "utils/allocator/prism_xallocator.h"
+
+/**
+ * @brief Bound on Prism node type values dispatched to AST input rules.
+ */
+#define LEUKO_ENGINE_NODE_TYPES 256
+
+/**
+ * @brief Number of 64-bit words in a set of AST input rules.
+ */
+#define LEUKO_ENGINE_RULE_WORDS ((LEUKO_RULE_ID_COUNT + 63) / 64)
+
+/**
+ * @brief Rules to run over one pass, split by the input they need.
+ */
+typedef struct leuko_engine_plan_s
+{
+    const leuko_rule_t *line_rules[LEUKO_RULE_ID_COUNT]; /* byte and line input rules */
+    size_t line_rule_count;
+    const leuko_rule_t *token_rules[LEUKO_RULE_ID_COUNT];
+    size_t token_rule_count;
+    const leuko_rule_t *ast_rules[LEUKO_RULE_ID_COUNT];
+    size_t ast_rule_count;
+    uint64_t node_rules[LEUKO_ENGINE_NODE_TYPES][LEUKO_ENGINE_RULE_WORDS]; /* bit i: ast_rules[i] is called for nodes of the type */
+} leuko_engine_plan_t;
+
+/**
+ * @brief Per-file engine state.
+ */
+typedef struct leuko_engine_state_s
+{
+    const leuko_engine_options_t *opts;
+    leuko_rule_context_t *ctx;
+    leuko_engine_plan_t plan;      /* rules of the current pass */
+    size_t checked;                /* diagnostics already checked against the fail level */
+    bool stopped;                  /* work on this file was abandoned */
+    const leuko_line_set_t *lines; /* lines offenses are reported on (NULL: all) */
+    leuko_rule_profile_t *profile; /* timings of the worker (NULL: not profiled) */
+    leuko_trace_ring_t *trace;     /* timeline of the worker (NULL: not traced) */
+} leuko_engine_state_t;
+
+/**
+ * @brief One parse of a source buffer and everything derived from it.
+ * @note Passes between autocorrect iterations whose edits stayed local to
+ *       line ends are not parsed: only the line table is rebuilt.
+ */
+typedef struct leuko_engine_pass_s
+{
+    const uint8_t *source;        /* source bytes (owned by the caller) */
+    size_t source_len;            /* number of bytes */
+    bool parsed;                  /* parser and root are valid */
+    pm_parser_t parser;           /* parser state */
+    pm_node_t *root;              /* AST root */
+    leuko_processed_source_t ps;  /* line table */
+    leuko_trace_ring_t *trace;    /* timeline of the worker (NULL: not traced) */
+} leuko_engine_pass_t;
+
+/**
+ * @brief Check whether any diagnostic at or above a severity exists.
+ * @param diagnostics Diagnostic buffer
+ * @param from First index to check
+ * @param fail_level Minimum severity
+ * @return true if a failing diagnostic was found
+ * @note Corrected offenses never fail the run.
+ */
+bool leuko_engine_has_failure(const leuko_diagnostic_buffer_t *diagnostics, size_t from, leuko_severity_t fail_level)
+{
+    for (size_t i = from; i < diagnostics->count; ++i)
+    {
+        if (diagnostics->severities[i] >= (uint8_t)fail_level && !(diagnostics->flags[i] & LEUKO_DIAGNOSTIC_FLAG_CORRECTED))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Drop the diagnostics that do not touch any of the given lines.
+ * @param diagnostics Diagnostic buffer
+ * @param from First index to filter
+ * @param ps Line table the lines are numbered in
+ * @param changes Corrections leading from that source to the one the offsets refer to (NULL: none)
+ * @param lines Lines to keep offenses on
+ * @note Runs before any message is rendered. Must not run while edits
+ *       refer to diagnostic indices.
+ */
+static void leuko_engine_filter_lines(leuko_diagnostic_buffer_t *diagnostics, size_t from, leuko_processed_source_t *ps, const leuko_change_map_t *changes,
+                                      const leuko_line_set_t *lines)
+{
+    size_t kept = from;
+    for (size_t i = from; i < diagnostics->count; ++i)
+    {
+        size_t begin = diagnostics->begin_offsets[i];
+        size_t end = diagnostics->end_offsets[i];
+        if (changes)
+        {
+            begin = leuko_change_map_original_offset(changes, begin);
+            end = leuko_change_map_original_offset(changes, end);
+        }
+        int32_t first = leuko_processed_source_line_of_pos(ps, leuko_offset_to_pos(ps, begin));
+        int32_t last = leuko_processed_source_line_of_pos(ps, leuko_offset_to_pos(ps, end > begin ? end - 1 : begin));
+        if (leuko_line_set_intersects(lines, first, last))
+        {
+            if (kept != i)
+            {
+                leuko_diagnostic_buffer_move(diagnostics, kept, i);
+            }
+            kept++;
+        }
+    }
+    diagnostics->count = kept;
+}
+
+/**
+ * @brief Cancellation checkpoint between units of work.
+ * @param state Engine state
+ * @return true if linting of the current file should stop
+ * @note In stop-on-diagnostic mode, newly reported diagnostics are checked
+ *       here and the shared flag is raised for every other worker.
+ */
+static bool leuko_engine_checkpoint(leuko_engine_state_t *state)
+{
+    if (state->stopped)
+    {
+        return true;
+    }
+    const leuko_engine_options_t *opts = state->opts;
+    leuko_diagnostic_buffer_t *diags = state->ctx->diagnostics;
+    if (opts->stop_on_diagnostic && diags->count > state->checked)
+    {
+        if (state->lines)
+        {
+            leuko_engine_filter_lines(diags, state->checked, state->ctx->ps, NULL, state->lines);
+        }
+        bool failed = leuko_engine_has_failure(diags, state->checked, opts->fail_level);
+        state->checked = diags->count;
+        if (failed)
+        {
+            if (opts->cancel)
+            {
+                __atomic_store_n(opts->cancel, 1, __ATOMIC_RELAXED);
+            }
+            state->stopped = true;
+            return true;
+        }
+    }
+    if (leuko_engine_cancelled(opts))
+    {
+        state->stopped = true;
+    }
+    return state->stopped;
+}
+
+/**
+ * @brief Account one timed rule call to the profile.
+ * @param state Engine state (profiled)
+ * @param rule Rule that was called
+ * @param start Clock reading taken before the call
+ * @param before Number of diagnostics before the call
+ */
+static inline void leuko_engine_profile_add(leuko_engine_state_t *state, const leuko_rule_t *rule, uint64_t start, size_t before)
+{
+    leuko_rule_profile_entry_t *entry = &state->profile->rules[rule->id];
+    entry->ns += leuko_clock_ns() - start;
+    entry->calls++;
+    entry->offenses += state->ctx->diagnostics->count - before;
+}
+
+/**
+ * @brief Call the entry point of a byte or line input rule.
+ * @param state Engine state
+ * @param rule Rule
+ */
+static inline void leuko_engine_check_source(leuko_engine_state_t *state, const leuko_rule_t *rule)
+{
+    if (!state->profile)
+    {
+        rule->check_source(rule, state->ctx);
+        return;
+    }
+    size_t before = state->ctx->diagnostics->count;
+    uint64_t start = leuko_clock_ns();
+    rule->check_source(rule, state->ctx);
+    leuko_engine_profile_add(state, rule, start, before);
+}
+
+/**
+ * @brief Call the entry point of a token input rule.
+ * @param state Engine state
+ * @param rule Rule
+ * @param token Current token
+ */
+static inline void leuko_engine_check_token(leuko_engine_state_t *state, const leuko_rule_t *rule, const leuko_token_t *token)
+{
+    if (!state->profile)
+    {
+        rule->check_token(rule, state->ctx, token);
+        return;
+    }
+    size_t before = state->ctx->diagnostics->count;
+    uint64_t start = leuko_clock_ns();
+    rule->check_token(rule, state->ctx, token);
+    leuko_engine_profile_add(state, rule, start, before);
+}
+
+/**
+ * @brief Call the entry point of an AST input rule.
+ * @param state Engine state
+ * @param rule Rule
+ * @param node Current node
+ */
+static inline void leuko_engine_check_node(leuko_engine_state_t *state, const leuko_rule_t *rule, const pm_node_t *node)
+{
+    if (!state->profile)
+    {
+        rule->check_node(rule, state->ctx, node);
+        return;
+    }
+    size_t before = state->ctx->diagnostics->count;
+    uint64_t start = leuko_clock_ns();
+    rule->check_node(rule, state->ctx, node);
+    leuko_engine_profile_add(state, rule, start, before);
+}
+
+/**
+ * @brief Prism visitor: dispatch a node to the AST input rules subscribed to its type.
+ * @param node Current node
+ * @param data Pointer to leuko_engine_state_t
+ * @return true to continue into child nodes
+ */
+static bool leuko_engine_visit_node(const pm_node_t *node, void *data)
+{
+    leuko_engine_state_t *state = data;
+    if (leuko_engine_checkpoint(state))
+    {
+        return false;
+    }
+    pm_node_type_t type = PM_NODE_TYPE(node);
+    if (type >= LEUKO_ENGINE_NODE_TYPES)
+    {
+        return true;
+    }
+    const uint64_t *words = state->plan.node_rules[type];
+    for (size_t w = 0; w < LEUKO_ENGINE_RULE_WORDS; ++w)
+    {
+        for (uint64_t bits = words[w]; bits; bits &= bits - 1)
+        {
+            const leuko_rule_t *rule = state->plan.ast_rules[w * 64 + (size_t)__builtin_ctzll(bits)];
+            leuko_engine_check_node(state, rule, node);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Pick the enabled rules that can fire on a source.
+ * @param plan Output: rules by input
+ * @param rules Enabled rules
+ * @param rule_count Number of enabled rules
+ * @param source Source bytes
+ * @param source_len Number of bytes
+ * @note The byte signature is only scanned for the features the enabled
+ *       rules ask about. When no AST input rule is left, the pass does not
+ *       need a parse: token input rules are fed by the built-in lexer. AST
+ *       input rules are only called for the node types their registry
+ *       entry subscribes to (every type when it lists none).
+ */
+static void leuko_engine_plan(leuko_engine_plan_t *plan, const leuko_rule_t *const *rules, size_t rule_count, const uint8_t *source, size_t source_len)
+{
+    uint32_t wanted = 0;
+    for (size_t i = 0; i < rule_count; ++i)
+    {
+        wanted |= rules[i]->features;
+    }
+    uint32_t found = wanted ? leuko_signature_scan(source, source_len, wanted) : 0;
+    plan->line_rule_count = 0;
+    plan->token_rule_count = 0;
+    plan->ast_rule_count = 0;
+    for (size_t i = 0; i < rule_count; ++i)
+    {
+        if (rules[i]->features && !(rules[i]->features & found))
+        {
+            continue;
+        }
+        leuko_rule_input_t input = leuko_rule_info(rules[i]->id)->input;
+        if (input <= LEUKO_RULE_INPUT_LINES)
+        {
+            plan->line_rules[plan->line_rule_count++] = rules[i];
+        }
+        else if (input == LEUKO_RULE_INPUT_TOKENS)
+        {
+            plan->token_rules[plan->token_rule_count++] = rules[i];
+        }
+        else
+        {
+            plan->ast_rules[plan->ast_rule_count++] = rules[i];
+        }
+    }
+    if (plan->ast_rule_count == 0)
+    {
+        return;
+    }
+    memset(plan->node_rules, 0, sizeof(plan->node_rules));
+    for (size_t i = 0; i < plan->ast_rule_count; ++i)
+    {
+        const leuko_rule_info_t *info = leuko_rule_info(plan->ast_rules[i]->id);
+        uint64_t bit = (uint64_t)1 << (i % 64);
+        for (size_t t = 0; t < LEUKO_ENGINE_NODE_TYPES && info->node_type_count == 0; ++t)
+        {
+            plan->node_rules[t][i / 64] |= bit;
+        }
+        for (size_t n = 0; n < info->node_type_count; ++n)
+        {
+            if (info->node_types[n] < LEUKO_ENGINE_NODE_TYPES)
+            {
+                plan->node_rules[info->node_types[n]][i / 64] |= bit;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Parse a source buffer and build its line table.
+ * @param pass Pass to initialize
+ * @param source Source bytes (must outlive the pass)
+ * @param source_len Number of bytes
+ * @note Prism allocations of the pass go to the per-file arena.
+ */
+static void leuko_engine_pass_begin(leuko_engine_pass_t *pass, const uint8_t *source, size_t source_len)
+{
+    pass->source = source;
+    pass->source_len = source_len;
+    pass->parsed = true;
+    uint64_t start = leuko_trace_begin(pass->trace);
+    leuko_x_allocator_begin();
+    pm_parser_init(&pass->parser, source, source_len, NULL);
+    pass->root = pm_parse(&pass->parser);
+    leuko_trace_end(pass->trace, "parse", NULL, start);
+    start = leuko_trace_begin(pass->trace);
+    leuko_processed_source_init_from_parser(&pass->ps, &pass->parser);
+    leuko_trace_end(pass->trace, "processed_source", NULL, start);
+}
+
+/**
+ * @brief Build only the line table of a source buffer.
+ * @param pass Pass to initialize
+ * @param source Source bytes (must outlive the pass)
+ * @param source_len Number of bytes
+ * @param start_line_number Number of the first line
+ */
+static void leuko_engine_pass_begin_lines(leuko_engine_pass_t *pass, const uint8_t *source, size_t source_len, int32_t start_line_number)
+{
+    pass->source = source;
+    pass->source_len = source_len;
+    pass->parsed = false;
+    pass->root = NULL;
+    uint64_t start = leuko_trace_begin(pass->trace);
+    leuko_processed_source_init_from_source(&pass->ps, source, source_len, start_line_number);
+    leuko_trace_end(pass->trace, "processed_source", NULL, start);
+}
+
+/**
+ * @brief Plan the rules of a source and build the pass they need.
+ * @param state Engine state (its plan is replaced)
+ * @param pass Pass to initialize
+ * @param rules Enabled rules
+ * @param rule_count Number of enabled rules
+ * @param source Source bytes (must outlive the pass)
+ * @param source_len Number of bytes
+ * @note Prism only runs when an AST input rule can fire.
+ */
+static void leuko_engine_pass_begin_planned(leuko_engine_state_t *state, leuko_engine_pass_t *pass, const leuko_rule_t *const *rules, size_t rule_count,
+                                            const uint8_t *source, size_t source_len)
+{
+    leuko_engine_plan(&state->plan, rules, rule_count, source, source_len);
+    if (state->plan.ast_rule_count > 0)
+    {
+        leuko_engine_pass_begin(pass, source, source_len);
+    }
+    else
+    {
+        leuko_engine_pass_begin_lines(pass, source, source_len, 1);
+    }
+    state->ctx->parser = pass->parsed ? &pass->parser : NULL;
+}
+
+/**
+ * @brief Release everything built by `leuko_engine_pass_begin` or `leuko_engine_pass_begin_lines`.
+ * @param pass Pass
+ */
+static void leuko_engine_pass_end(leuko_engine_pass_t *pass)
+{
+    leuko_processed_source_free(&pass->ps);
+    if (pass->parsed)
+    {
+        pm_node_destroy(&pass->parser, pass->root);
+        pm_parser_free(&pass->parser);
+        leuko_x_allocator_end();
+    }
+}
+
+/**
+ * @brief Lexer callback: dispatch a token to every token input rule.
+ * @param token Current token
+ * @param data Pointer to leuko_engine_state_t
+ */
+static void leuko_engine_visit_token(const leuko_token_t *token, void *data)
+{
+    leuko_engine_state_t *state = data;
+    if (state->stopped)
+    {
+        return;
+    }
+    for (size_t i = 0; i < state->plan.token_rule_count; ++i)
+    {
+        leuko_engine_check_token(state, state->plan.token_rules[i], token);
+    }
+}
+
+/**
+ * @brief Run the token input rules over the whole source of a pass.
+ * @param state Engine state (its context points at the pass)
+ * @param pass Pass
+ * @note The same lexer run fills the line flags of the processed source,
+ *       so line input rules asking for them do not lex the file again.
+ */
+static void leuko_engine_run_tokens(leuko_engine_state_t *state, leuko_engine_pass_t *pass)
+{
+    leuko_processed_source_t *ps = &pass->ps;
+    if (state->plan.token_rule_count == 0 || leuko_engine_checkpoint(state))
+    {
+        return;
+    }
+    uint64_t start = leuko_trace_begin(state->trace);
+    uint8_t *flags = NULL;
+    if (!ps->line_flags && ps->line_count > 0)
+    {
+        flags = malloc(ps->line_count);
+    }
+    leuko_lex(pass->source, pass->source_len, ps->line_count, flags, leuko_engine_visit_token, state);
+    if (flags)
+    {
+        ps->line_flags = flags;
+    }
+    leuko_trace_end(state->trace, "token_rules", NULL, start);
+    leuko_engine_checkpoint(state);
+}
+
+/**
+ * @brief Run the planned rules over one pass.
+ * @param state Engine state (its context points at the pass)
+ * @param pass Pass
+ */
+static void leuko_engine_run_rules(leuko_engine_state_t *state, leuko_engine_pass_t *pass)
+{
+    const leuko_engine_plan_t *plan = &state->plan;
+    state->ctx->line_begin = 0;
+    state->ctx->line_end = pass->ps.line_count;
+    leuko_engine_run_tokens(state, pass);
+    uint64_t start = leuko_trace_begin(state->trace);
+    for (size_t i = 0; i < plan->line_rule_count && !leuko_engine_checkpoint(state); ++i)
+    {
+        leuko_engine_check_source(state, plan->line_rules[i]);
+    }
+    leuko_trace_end(state->trace, "line_rules", NULL, start);
+    if (pass->parsed && plan->ast_rule_count > 0 && !leuko_engine_checkpoint(state))
+    {
+        start = leuko_trace_begin(state->trace);
+        pm_visit_node(pass->root, leuko_engine_visit_node, state);
+        leuko_trace_end(state->trace, "ast_rules", NULL, start);
+    }
+    leuko_engine_checkpoint(state);
+}
+
+/**
+ * @brief Run the line input rules over the dirty lines of an unparsed pass.
+ * @param state Engine state (its context points at the pass)
+ * @param pass Pass built by `leuko_engine_pass_begin_lines`
+ * @param dirty One byte per line, non-zero for lines to check
+ * @note Each run of consecutive dirty lines is checked as one range. Byte
+ *       and token input rules check the whole source again: their offenses
+ *       are not tied to lines, and lexing costs less than tracking which
+ *       tokens the edits moved.
+ */
+static void leuko_engine_run_dirty_lines(leuko_engine_state_t *state, leuko_engine_pass_t *pass, const uint8_t *dirty)
+{
+    const leuko_engine_plan_t *plan = &state->plan;
+    leuko_rule_context_t *ctx = state->ctx;
+    ctx->parser = NULL;
+    leuko_engine_run_tokens(state, pass);
+    uint64_t start = leuko_trace_begin(state->trace);
+    size_t line_count = pass->ps.line_count;
+    ctx->line_begin = 0;
+    ctx->line_end = line_count;
+    for (size_t i = 0; i < plan->line_rule_count && !leuko_engine_checkpoint(state); ++i)
+    {
+        if (leuko_rule_info(plan->line_rules[i]->id)->input == LEUKO_RULE_INPUT_BYTES)
+        {
+            leuko_engine_check_source(state, plan->line_rules[i]);
+        }
+    }
+    for (size_t line = 0; line < line_count && !leuko_engine_checkpoint(state);)
+    {
+        if (!dirty[line])
+        {
+            ++line;
+            continue;
+        }
+        ctx->line_begin = line;
+        while (line < line_count && dirty[line])
+        {
+            ++line;
+        }
+        ctx->line_end = line;
+        for (size_t i = 0; i < plan->line_rule_count && !leuko_engine_checkpoint(state); ++i)
+        {
+            if (leuko_rule_info(plan->line_rules[i]->id)->input == LEUKO_RULE_INPUT_LINES)
+            {
+                leuko_engine_check_source(state, plan->line_rules[i]);
+            }
+        }
+    }
+    leuko_trace_end(state->trace, "line_rules", NULL, start);
+    leuko_engine_checkpoint(state);
+}
+
+/**
+ * @brief Check whether the applied edits leave the token stream intact.
+ * @param edits Resolved and applied edits
+ * @param diagnostics Diagnostics of the pass that produced them
+ * @param pass Pass that produced them (still holding the old source)
+ * @return true if the next pass may skip parsing
+ * @note An edit is local when it replaces spaces and tabs with spaces and
+ *       tabs right before a line break (or the end of the file). Such an
+ *       edit can only change string contents, never where tokens, lines,
+ *       heredocs or the `__END__` marker are, with two exceptions that are
+ *       rejected: whitespace after a backslash (removing it makes a line
+ *       continuation) and whitespace after `__END__`. A dropped correction of
+ *       an AST input rule also needs a reparse to be proposed again (the
+ *       other rules run in every pass).
+ */
+static bool leuko_engine_edits_are_local(const leuko_edit_list_t *edits, const leuko_diagnostic_buffer_t *diagnostics, const leuko_engine_pass_t *pass)
+{
+    for (size_t i = 0; i < diagnostics->count; ++i)
+    {
+        if ((diagnostics->flags[i] & (LEUKO_DIAGNOSTIC_FLAG_HAS_EDIT | LEUKO_DIAGNOSTIC_FLAG_CORRECTED)) == LEUKO_DIAGNOSTIC_FLAG_HAS_EDIT &&
+            leuko_rule_info(diagnostics->rule_ids[i])->input == LEUKO_RULE_INPUT_AST)
+        {
+            return false;
+        }
+    }
+    const uint8_t *src = pass->source;
+    for (size_t i = 0; i < edits->count; ++i)
+    {
+        const leuko_edit_t *e = &edits->edits[i];
+        if (e->end < pass->source_len && src[e->end] != '\n' && src[e->end] != '\r')
+        {
+            return false;
+        }
+        if (e->begin > 0 && src[e->begin - 1] == '\\')
+        {
+            return false;
+        }
+        if (e->begin >= 7 && memcmp(src + e->begin - 7, "__END__", 7) == 0 && (e->begin == 7 || src[e->begin - 8] == '\n'))
+        {
+            return false;
+        }
+        for (uint32_t b = e->begin; b < e->end; ++b)
+        {
+            if (src[b] != ' ' && src[b] != '\t')
+            {
+                return false;
+            }
+        }
+        const char *text = edits->text + e->text_offset;
+        for (uint32_t b = 0; b < e->text_len; ++b)
+        {
+            if (text[b] != ' ' && text[b] != '\t')
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 0-based index of the line containing a byte offset.
+ */
+static size_t leuko_engine_line_index(const leuko_processed_source_t *ps, size_t offset)
+{
+    return (size_t)(leuko_processed_source_line_of_pos(ps, leuko_offset_to_pos(ps, offset)) - ps->start_line_number);
+}
+
+/**
+ * @brief Mark the lines a line input rule has to check again after local edits.
+ * @param edits Resolved and applied edits
+ * @param diagnostics Diagnostics of the pass that produced them
+ * @param pass Pass that produced them (still holding the old source)
+ * @return One byte per line, non-zero for dirty lines (caller frees), or NULL on allocation failure
+ * @note Local edits never add or remove line breaks, so line indices are the
+ *       same in the corrected source. Dirty lines are the lines of every edit
+ *       and of every line input offense that proposed a correction, applied or
+ *       dropped: the latter must be reported again to be retried.
+ */
+static uint8_t *leuko_engine_dirty_lines(const leuko_edit_list_t *edits, const leuko_diagnostic_buffer_t *diagnostics, const leuko_engine_pass_t *pass)
+{
+    const leuko_processed_source_t *ps = &pass->ps;
+    uint8_t *dirty = calloc(ps->line_count ? ps->line_count : 1, 1);
+    if (!dirty)
+    {
+        return NULL;
+    }
+    for (size_t i = 0; i < edits->count; ++i)
+    {
+        dirty[leuko_engine_line_index(ps, edits->edits[i].begin)] = 1;
+    }
+    for (size_t i = 0; i < diagnostics->count; ++i)
+    {
+        if ((diagnostics->flags[i] & LEUKO_DIAGNOSTIC_FLAG_HAS_EDIT) && leuko_rule_info(diagnostics->rule_ids[i])->input == LEUKO_RULE_INPUT_LINES)
+        {
+            size_t begin = diagnostics->begin_offsets[i];
+            size_t end = diagnostics->end_offsets[i] > begin ? diagnostics->end_offsets[i] - 1 : begin;
+            for (size_t line = leuko_engine_line_index(ps, begin), last = leuko_engine_line_index(ps, end); line <= last; ++line)
+            {
+                dirty[line] = 1;
+            }
+        }
+    }
+    return dirty;
+}
+
+/**
+ * @brief Keep the offenses of a pass that local edits cannot have changed.
+ * @param edits Resolved and applied edits
+ * @param diagnostics Diagnostics of the pass that produced them
+ * @param carried Output: kept offenses with offsets moved to the corrected source (cleared first)
+ * @param pass Pass that produced them (still holding the old source)
+ * @param dirty Dirty lines from `leuko_engine_dirty_lines`
+ * @note AST input offenses are all kept; line input offenses are kept
+ *       unless they touch a dirty line, where they are found again; byte and
+ *       token input offenses are all found again.
+ */
+static void leuko_engine_carry_over(const leuko_edit_list_t *edits, const leuko_diagnostic_buffer_t *diagnostics, leuko_diagnostic_buffer_t *carried,
+                                    const leuko_engine_pass_t *pass, const uint8_t *dirty)
+{
+    const leuko_processed_source_t *ps = &pass->ps;
+    leuko_diagnostic_buffer_clear(carried);
+    for (size_t i = 0; i < diagnostics->count; ++i)
+    {
+        if (diagnostics->flags[i] & LEUKO_DIAGNOSTIC_FLAG_CORRECTED)
+        {
+            continue;
+        }
+        size_t begin = diagnostics->begin_offsets[i];
+        size_t end = diagnostics->end_offsets[i];
+        leuko_rule_input_t input = leuko_rule_info(diagnostics->rule_ids[i])->input;
+        if (input == LEUKO_RULE_INPUT_BYTES || input == LEUKO_RULE_INPUT_TOKENS)
+        {
+            continue;
+        }
+        if (input == LEUKO_RULE_INPUT_LINES)
+        {
+            bool touched = false;
+            for (size_t line = leuko_engine_line_index(ps, begin), last = leuko_engine_line_index(ps, end > begin ? end - 1 : begin); line <= last && !touched; ++line)
+            {
+                touched = dirty[line] != 0;
+            }
+            if (touched)
+            {
+                continue;
+            }
+        }
+        if (leuko_diagnostic_buffer_push_from(carried, diagnostics, i))
+        {
+            carried->begin_offsets[carried->count - 1] = (uint32_t)leuko_edit_list_map_offset(edits, begin);
+            carried->end_offsets[carried->count - 1] = (uint32_t)leuko_edit_list_map_offset(edits, end);
+        }
+    }
+}
+
+/**
+ * @brief Apply the corrections of one pass and keep the corrected offenses.
+ * @param edits Edits collected by the pass
+ * @param diagnostics Diagnostics of the pass
+ * @param corrected Corrected offenses of all passes so far (offsets are moved to the new source)
+ * @param pass Pass that produced the edits
+ * @param out Output: corrected source (caller frees)
+ * @param out_len Output: length of the corrected source
+ * @return true if the source changed, false if nothing could be applied
+ * @note All edits are resolved and applied at once in a single copy of the
+ *       source; offenses whose edits were dropped are found again by the
+ *       next pass.
+ */
+static bool leuko_engine_apply_corrections(leuko_edit_list_t *edits, leuko_diagnostic_buffer_t *diagnostics, leuko_diagnostic_buffer_t *corrected,
+                                           const leuko_engine_pass_t *pass, uint8_t **out, size_t *out_len)
+{
+    for (size_t i = 0; i < edits->count; ++i)
+    {
+        diagnostics->flags[edits->edits[i].group] |= LEUKO_DIAGNOSTIC_FLAG_HAS_EDIT;
+    }
+    if (leuko_edit_list_resolve(edits) == 0 || !leuko_edit_list_apply(edits, pass->source, pass->source_len, out, out_len))
+    {
+        return false;
+    }
+    for (size_t i = 0; i < edits->count; ++i)
+    {
+        diagnostics->flags[edits->edits[i].group] |= LEUKO_DIAGNOSTIC_FLAG_CORRECTED;
+    }
+    for (size_t i = 0; i < diagnostics->count; ++i)
+    {
+        if (diagnostics->flags[i] & LEUKO_DIAGNOSTIC_FLAG_CORRECTED)
+        {
+            leuko_diagnostic_buffer_push_from(corrected, diagnostics, i);
+        }
+    }
+    for (size_t i = 0; i < corrected->count; ++i)
+    {
+        corrected->begin_offsets[i] = (uint32_t)leuko_edit_list_map_offset(edits, corrected->begin_offsets[i]);
+        corrected->end_offsets[i] = (uint32_t)leuko_edit_list_map_offset(edits, corrected->end_offsets[i]);
+    }
+    return true;
+}
+
+/**
+ * @brief Lint a source already in memory (shared by the file and buffer entry points).
+ * @param job File the source belongs to
+ * @param opts Engine options
+ * @param trace Worker's trace ring (NULL: not traced)
+ * @param lint_start Start of the "lint" span (read included)
+ * @param source Source (malloc'd, freed here)
+ * @param source_len Source length
+ * @param diagnostics Per-worker diagnostic buffer (already cleared)
+ * @param on_result Callback receiving the result while the source is alive (may be NULL)
+ * @param data User data for the callback
+ */
+static void leuko_engine_lint_source(const leuko_lint_job_t *job, const leuko_engine_options_t *opts, leuko_trace_ring_t *trace, uint64_t lint_start, uint8_t *source,
+                                     size_t source_len, leuko_diagnostic_buffer_t *diagnostics, leuko_lint_result_fn on_result, void *data)
+{
+    size_t all_count = 0;
+    const leuko_rule_t *const *all = leuko_rules_all(&all_count);
+    const leuko_rule_t *rules[LEUKO_RULE_ID_COUNT];
+    size_t rule_count = 0;
+    for (size_t i = 0; i < all_count; ++i)
+    {
+        if (!opts->enabled || leuko_rule_set_has(opts->enabled, all[i]->id))
+        {
+            rules[rule_count++] = all[i];
+        }
+    }
+
+    bool fixing = opts->fix_mode != LEUKO_FIX_MODE_NONE;
+    leuko_edit_list_t edits;
+    leuko_diagnostic_buffer_t corrected;
+    leuko_diagnostic_buffer_t carried;
+    leuko_change_map_t changes;
+    bool changes_ok = true;
+    leuko_edit_list_init(&edits);
+    leuko_change_map_init(&changes);
+    leuko_diagnostic_buffer_init(&corrected);
+    leuko_diagnostic_buffer_init(&carried);
+
+    leuko_engine_pass_t pass;
+    pass.trace = trace;
+    leuko_rule_context_t ctx = {
+        .ps = &pass.ps,
+        .parser = NULL,
+        .diagnostics = diagnostics,
+        .edits = fixing ? &edits : NULL,
+        .fix_mode = opts->fix_mode,
+    };
+    leuko_engine_state_t state = {
+        .opts = opts,
+        .ctx = &ctx,
+        .checked = 0,
+        .stopped = false,
+        .lines = job->lines,
+        .profile = opts->profiles ? &opts->profiles[job->worker_index] : NULL,
+        .trace = trace,
+    };
+    leuko_engine_pass_begin_planned(&state, &pass, rules, rule_count, source, source_len);
+    leuko_engine_run_rules(&state, &pass);
+
+    uint8_t *original = NULL; /* source as read, kept once corrections apply */
+    size_t original_len = 0;
+    size_t passes = 1;
+    for (; fixing && edits.count > 0 && !state.stopped && passes < LEUKO_ENGINE_MAX_CORRECTION_PASSES; ++passes)
+    {
+        uint8_t *fixed = NULL;
+        size_t fixed_len = 0;
+        uint64_t start = leuko_trace_begin(trace);
+        bool applied = leuko_engine_apply_corrections(&edits, diagnostics, &corrected, &pass, &fixed, &fixed_len);
+        leuko_trace_end(trace, "correct", NULL, start);
+        if (!applied)
+        {
+            break;
+        }
+        changes_ok = changes_ok && leuko_change_map_add(&changes, &edits);
+        bool local = !opts->full_relint && leuko_engine_edits_are_local(&edits, diagnostics, &pass);
+        uint8_t *dirty = local ? leuko_engine_dirty_lines(&edits, diagnostics, &pass) : NULL;
+        LEUKO_LOG_DEBUG(LEUKO_LOG_ENGINE, "%s: pass %zu applied %zu edits, %s\n", job->path, passes, edits.count, dirty ? "rechecking dirty lines" : "reparsing");
+        if (dirty)
+        {
+            leuko_engine_carry_over(&edits, diagnostics, &carried, &pass, dirty);
+        }
+        int32_t start_line_number = pass.ps.start_line_number;
+        leuko_engine_pass_end(&pass);
+        if (original)
+        {
+            free(source);
+        }
+        else
+        {
+            original = source;
+            original_len = source_len;
+        }
+        source = fixed;
+        source_len = fixed_len;
+
+        leuko_diagnostic_buffer_clear(diagnostics);
+        leuko_edit_list_clear(&edits);
+        state.checked = 0;
+        if (dirty)
+        {
+            leuko_engine_plan(&state.plan, rules, rule_count, source, source_len);
+            leuko_engine_pass_begin_lines(&pass, source, source_len, start_line_number);
+            for (size_t i = 0; i < carried.count; ++i)
+            {
+                leuko_diagnostic_buffer_push_from(diagnostics, &carried, i);
+            }
+            leuko_engine_run_dirty_lines(&state, &pass, dirty);
+            free(dirty);
+        }
+        else
+        {
+            leuko_engine_pass_begin_planned(&state, &pass, rules, rule_count, source, source_len);
+            leuko_engine_run_rules(&state, &pass);
+        }
+    }
+
+    if (passes == LEUKO_ENGINE_MAX_CORRECTION_PASSES && edits.count > 0)
+    {
+        fprintf(stderr, "%s: autocorrect did not converge after %d passes\n", job->path, LEUKO_ENGINE_MAX_CORRECTION_PASSES);
+    }
+    if (original && !state.stopped)
+    {
+        for (size_t i = 0; i < corrected.count; ++i)
+        {
+            leuko_diagnostic_buffer_push_from(diagnostics, &corrected, i);
+        }
+        if (job->write_back && !leuko_write_back_file(job->write_back, job->path, original, original_len, source, source_len))
+        {
+            /* the file on disk still has these offenses */
+            for (size_t i = 0; i < diagnostics->count; ++i)
+            {
+                diagnostics->flags[i] &= (uint8_t)~LEUKO_DIAGNOSTIC_FLAG_CORRECTED;
+            }
+        }
+    }
+
+    if (job->lines && !original)
+    {
+        leuko_engine_filter_lines(diagnostics, 0, &pass.ps, NULL, job->lines);
+    }
+    else if (job->lines && changes_ok)
+    {
+        /* the lines are numbered in the file as read, offsets in the corrected source */
+        leuko_processed_source_t read_ps;
+        leuko_processed_source_init_from_source(&read_ps, original, original_len, pass.ps.start_line_number);
+        leuko_engine_filter_lines(diagnostics, 0, &read_ps, &changes, job->lines);
+        leuko_processed_source_free(&read_ps);
+    }
+    if (on_result && !state.stopped)
+    {
+        leuko_lint_result_t result = {
+            .path = job->path,
+            .file_index = job->file_index,
+            .worker_index = job->worker_index,
+            .ps = &pass.ps,
+            .diagnostics = diagnostics,
+            .original = original ? original : source,
+            .original_len = original ? original_len : source_len,
+            .changes = changes_ok ? &changes : NULL,
+        };
+        uint64_t start = leuko_trace_begin(trace);
+        on_result(&result, data);
+        leuko_trace_end(trace, "report", NULL, start);
+    }
+
+    leuko_engine_pass_end(&pass);
+    leuko_edit_list_free(&edits);
+    leuko_diagnostic_buffer_free(&corrected);
+    leuko_diagnostic_buffer_free(&carried);
+    leuko_change_map_free(&changes);
+    free(original);
+    free(source);
+    leuko_trace_end(trace, "lint", job->path, lint_start);
+}
+
+/**
+ * @brief Lint one file and hand the diagnostics to a callback.
+ * @param job File to lint
+ * @param opts Engine options
+ * @param diagnostics Per-worker diagnostic buffer (cleared before use)
+ * @param on_result Callback receiving the result while the source is alive (may be NULL)
+ * @param data User data for the callback
+ * @return true if the file was read and linted, false otherwise
+ * @note The result callback is skipped when the work was cancelled. When
+ *       autocorrecting, the file is linted again after each round of
+ *       corrections until no more apply (or the pass limit is hit), then
+ *       handed to the job's write-back stage once; if it cannot be written,
+ *       its offenses lose LEUKO_DIAGNOSTIC_FLAG_CORRECTED (and so fail the
+ *       run again). The result carries the original source and the
+ *       corrections as a change map either way.
+ *       With a line filter, offenses off the job's lines are dropped before
+ *       the result is handed out (corrections still cover the whole file).
+ *       The lines are numbered in the file as read: corrected offsets are
+ *       mapped back through the change map first (without one, nothing is
+ *       dropped).
+ *       Every pass only runs the enabled rules the source's byte signature
+ *       allows, and is not parsed when none of them needs the AST. A round
+ *       whose edits only touched whitespace at line ends is re-linted
+ *       incrementally: the source is not parsed again, other offenses are
+ *       carried over with shifted offsets, and only the line input rules run
+ *       on the dirty lines (byte and token input rules on the whole source).
+ */
+bool leuko_engine_lint_file(const leuko_lint_job_t *job, const leuko_engine_options_t *opts, leuko_diagnostic_buffer_t *diagnostics, leuko_lint_result_fn on_result, void *data)
+{
+    leuko_diagnostic_buffer_clear(diagnostics);
+    if (leuko_engine_cancelled(opts))
+    {
+        return false;
+    }
+
+    leuko_trace_ring_t *trace = opts->trace ? &opts->trace->rings[job->worker_index] : NULL;
+    uint64_t lint_start = leuko_trace_begin(trace);
+    uint8_t *source = NULL;
+    size_t source_len = 0;
+    if (!leuko_file_read_all(job->path, &source, &source_len))
+    {
+        fprintf(stderr, "%s: could not read file\n", job->path);
+        return false;
+    }
+    leuko_trace_end(trace, "read", NULL, lint_start);
+    leuko_engine_lint_source(job, opts, trace, lint_start, source, source_len, diagnostics, on_result, data);
+    return true;
+}
+
+/**
+ * @brief Lint a source held in memory, as if it had been read from the job's path.
+ * @param job File the source stands for (its path is only used in messages and the result)
+ * @param opts Engine options
+ * @param source Source (malloc'd; the engine takes ownership and frees it)
+ * @param source_len Source length
+ * @param diagnostics Per-worker diagnostic buffer (cleared before use)
+ * @param on_result Callback receiving the result while the source is alive (may be NULL)
+ * @param data User data for the callback
+ * @return true if the source was linted, false if the work was cancelled
+ * @note Same passes as leuko_engine_lint_file() minus the file read; with a
+ *       write-back stage the corrections are written to the job's path.
+ */
+bool leuko_engine_lint_buffer(const leuko_lint_job_t *job, const leuko_engine_options_t *opts, uint8_t *source, size_t source_len, leuko_diagnostic_buffer_t *diagnostics,
+                              leuko_lint_result_fn on_result, void *data)
+{
+    leuko_diagnostic_buffer_clear(diagnostics);
+    if (leuko_engine_cancelled(opts))
+    {
+        free(source);
+        return false;
+    }
+
+    leuko_trace_ring_t *trace = opts->trace ? &opts->trace->rings[job->worker_index] : NULL;
+    leuko_engine_lint_source(job, opts, trace, leuko_trace_begin(trace), source, source_len, diagnostics, on_result, data);
+    return true;
+}
@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include "engine/profile.h"
+#include "output/json_escape.h"
+
+/**
+ * @brief Add the timings of one profile to another.
+ * @param into Profile to add to
+ * @param from Profile to add
+ */
+void leuko_rule_profile_merge(leuko_rule_profile_t *into, const leuko_rule_profile_t *from)
+{
+    for (size_t i = 0; i < LEUKO_RULE_ID_COUNT; ++i)
+    {
+        into->rules[i].ns += from->rules[i].ns;
+        into->rules[i].calls += from->rules[i].calls;
+        into->rules[i].offenses += from->rules[i].offenses;
+    }
+}
+
+/**
+ * @brief Render the rules that ran, slowest first.
+ * @param profile Merged profile
+ * @param format Table or JSON array
+ * @param out Output buffer
+ * @return false on allocation failure
+ * @note Rules that were never called are left out.
+ */
+bool leuko_rule_profile_render(const leuko_rule_profile_t *profile, leuko_rule_profile_format_t format, leuko_output_buffer_t *out)
+{
+    uint16_t order[LEUKO_RULE_ID_COUNT];
+    size_t count = 0;
+    uint64_t total = 0;
+    for (size_t i = 0; i < LEUKO_RULE_ID_COUNT; ++i)
+    {
+        if (profile->rules[i].calls > 0)
+        {
+            order[count++] = (uint16_t)i;
+            total += profile->rules[i].ns;
+        }
+    }
+    /* slowest first; ties keep id order */
+    for (size_t i = 1; i < count; ++i)
+    {
+        uint16_t id = order[i];
+        size_t j = i;
+        for (; j > 0 && profile->rules[order[j - 1]].ns < profile->rules[id].ns; --j)
+        {
+            order[j] = order[j - 1];
+        }
+        order[j] = id;
+    }
+
+    bool json = format == LEUKO_RULE_PROFILE_JSON;
+    bool ok = json ? leuko_output_buffer_putc(out, '[')
+                   : leuko_output_buffer_printf(out, "%-48s %10s %6s %12s %9s %9s\n", "Rule", "Time (ms)", "%", "Calls", "ns/call", "Offenses");
+    for (size_t i = 0; i < count && ok; ++i)
+    {
+        const leuko_rule_info_t *info = leuko_rule_info((leuko_rule_id_t)order[i]);
+        const leuko_rule_profile_entry_t *entry = &profile->rules[order[i]];
+        char name[128];
+        int name_len = snprintf(name, sizeof(name), "%s/%s", info->category, info->name);
+        if (json)
+        {
+            ok = (i == 0 || leuko_output_buffer_putc(out, ',')) && leuko_output_buffer_puts(out, "{\"rule\":") &&
+                 leuko_json_append_string(out, name, (size_t)name_len) &&
+                 leuko_output_buffer_printf(out, ",\"ns\":%llu,\"calls\":%llu,\"offenses\":%llu}", (unsigned long long)entry->ns,
+                                            (unsigned long long)entry->calls, (unsigned long long)entry->offenses);
+        }
+        else
+        {
+            ok = leuko_output_buffer_printf(out, "%-48s %10.3f %6.1f %12llu %9llu %9llu\n", name, entry->ns / 1e6, total ? 100.0 * entry->ns / total : 0.0,
+                                            (unsigned long long)entry->calls, (unsigned long long)(entry->ns / entry->calls),
+                                            (unsigned long long)entry->offenses);
+        }
+    }
+    if (ok)
+    {
+        ok = json ? leuko_output_buffer_puts(out, "]\n") : leuko_output_buffer_printf(out, "%-48s %10.3f\n", "Total", total / 1e6);
+    }
+    return ok;
+}
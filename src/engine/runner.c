@@ -0,0 +1,180 @@
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "engine/runner.h"
+
+/**
+ * @brief State shared by all workers of a run.
+ */
+typedef struct leuko_runner_shared_s
+{
+    char *const *files;
+    size_t files_count;
+    size_t next_file;  /* next file index to claim (atomic) */
+    int cancel;        /* raised to stop all workers (atomic) */
+    leuko_engine_options_t engine;
+    const leuko_runner_options_t *opts;
+    size_t files_linted; /* atomic */
+    size_t diagnostics;  /* atomic */
+    int failed;          /* atomic */
+    int write_failed;    /* atomic */
+} leuko_runner_shared_t;
+
+/**
+ * @brief Number of online CPUs (at least 1).
+ * @return Default worker count
+ */
+size_t leuko_runner_default_jobs(void)
+{
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (size_t)n : 1;
+}
+
+/**
+ * @brief Per-thread worker state.
+ */
+typedef struct leuko_runner_worker_s
+{
+    leuko_runner_shared_t *shared;
+    size_t index;
+} leuko_runner_worker_t;
+
+/**
+ * @brief Resolve the number of workers for a run.
+ * @param opts Runner options
+ * @param files_count Number of files
+ * @return Number of workers that will be started (at least 1)
+ */
+size_t leuko_runner_jobs(const leuko_runner_options_t *opts, size_t files_count)
+{
+    size_t jobs = opts->jobs ? opts->jobs : leuko_runner_default_jobs();
+    if (jobs > files_count)
+    {
+        jobs = files_count;
+    }
+    return jobs ? jobs : 1;
+}
+
+/**
+ * @brief Worker loop: claim files one at a time until none are left or the run is cancelled.
+ * @param arg Pointer to leuko_runner_worker_t
+ * @return NULL
+ */
+static void *leuko_runner_worker(void *arg)
+{
+    leuko_runner_worker_t *worker = arg;
+    leuko_runner_shared_t *shared = worker->shared;
+    leuko_diagnostic_buffer_t diagnostics;
+    leuko_diagnostic_buffer_init(&diagnostics);
+    leuko_write_back_t write_back;
+    leuko_write_back_init(&write_back, shared->opts->fsync);
+    leuko_write_back_t *sink = shared->opts->dry_run ? NULL : &write_back;
+
+    for (;;)
+    {
+        if (__atomic_load_n(&shared->cancel, __ATOMIC_RELAXED))
+        {
+            break;
+        }
+        size_t idx = __atomic_fetch_add(&shared->next_file, 1, __ATOMIC_RELAXED);
+        if (idx >= shared->files_count)
+        {
+            break;
+        }
+        leuko_lint_job_t job = {.path = shared->files[idx], .file_index = idx, .worker_index = worker->index, .write_back = sink,
+                                .lines = shared->opts->lines ? shared->opts->lines[idx] : NULL};
+        if (leuko_engine_lint_file(&job, &shared->engine, &diagnostics, shared->opts->on_result, shared->opts->data))
+        {
+            __atomic_fetch_add(&shared->files_linted, 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&shared->diagnostics, diagnostics.count, __ATOMIC_RELAXED);
+            if (leuko_engine_has_failure(&diagnostics, 0, shared->engine.fail_level))
+            {
+                __atomic_store_n(&shared->failed, 1, __ATOMIC_RELAXED);
+            }
+        }
+        if (shared->opts->on_file_done)
+        {
+            shared->opts->on_file_done(idx, worker->index, shared->opts->data);
+        }
+    }
+
+    if (!leuko_write_back_flush(&write_back) || write_back.failed > 0)
+    {
+        __atomic_store_n(&shared->write_failed, 1, __ATOMIC_RELAXED);
+    }
+    leuko_diagnostic_buffer_free(&diagnostics);
+    return NULL;
+}
+
+/**
+ * @brief Lint files on a pool of worker threads.
+ * @param files File paths
+ * @param files_count Number of files
+ * @param opts Runner options
+ * @param stats Output: aggregate results
+ * @return true on success, false if no worker could be started
+ * @note With `opts->engine.stop_on_diagnostic`, the first failing diagnostic
+ *       cancels every worker: files not yet claimed are skipped and files in
+ *       flight stop at their next checkpoint. Corrected files are written by
+ *       the worker that linted them; synced ones are renamed into place by
+ *       the time this returns. A file that could not be written back sets
+ *       `stats->write_failed`.
+ */
+bool leuko_runner_run(char *const *files, size_t files_count, const leuko_runner_options_t *opts, leuko_runner_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    leuko_runner_shared_t shared;
+    memset(&shared, 0, sizeof(shared));
+    shared.files = files;
+    shared.files_count = files_count;
+    shared.opts = opts;
+    shared.engine = opts->engine;
+    shared.engine.cancel = &shared.cancel;
+
+    size_t jobs = leuko_runner_jobs(opts, files_count);
+
+    bool ok = true;
+    if (jobs <= 1)
+    {
+        leuko_runner_worker_t worker = {.shared = &shared, .index = 0};
+        leuko_runner_worker(&worker);
+    }
+    else
+    {
+        pthread_t *threads = calloc(jobs, sizeof(pthread_t));
+        leuko_runner_worker_t *workers = calloc(jobs, sizeof(leuko_runner_worker_t));
+        if (!threads || !workers)
+        {
+            free(threads);
+            free(workers);
+            return false;
+        }
+        size_t started = 0;
+        for (; started < jobs; ++started)
+        {
+            workers[started].shared = &shared;
+            workers[started].index = started;
+            if (pthread_create(&threads[started], NULL, leuko_runner_worker, &workers[started]) != 0)
+            {
+                break;
+            }
+        }
+        if (started == 0)
+        {
+            ok = false;
+        }
+        for (size_t i = 0; i < started; ++i)
+        {
+            pthread_join(threads[i], NULL);
+        }
+        free(threads);
+        free(workers);
+    }
+
+    stats->files_linted = shared.files_linted;
+    stats->diagnostics = shared.diagnostics;
+    stats->failed = shared.failed != 0;
+    stats->write_failed = shared.write_failed != 0;
+    return ok;
+}
@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "engine/trace.h"
+#include "output/json_escape.h"
+#include "output/output_buffer.h"
+#include "utils/file.h"
+
+/**
+ * @brief Allocate one ring per worker and start the clock.
+ * @param trace Trace to initialize
+ * @param ring_count Number of workers
+ * @return false on allocation failure (the trace is left empty)
+ */
+bool leuko_trace_init(leuko_trace_t *trace, size_t ring_count)
+{
+    memset(trace, 0, sizeof(*trace));
+    trace->rings = calloc(ring_count ? ring_count : 1, sizeof(leuko_trace_ring_t));
+    if (!trace->rings)
+    {
+        return false;
+    }
+    trace->ring_count = ring_count;
+    for (size_t i = 0; i < ring_count; ++i)
+    {
+        trace->rings[i].events = malloc(LEUKO_TRACE_RING_EVENTS * sizeof(leuko_trace_event_t));
+        if (!trace->rings[i].events)
+        {
+            leuko_trace_free(trace);
+            return false;
+        }
+    }
+    trace->origin = leuko_clock_ns();
+    return true;
+}
+
+/**
+ * @brief Append a clock reading as microseconds since the origin.
+ */
+static bool leuko_trace_append_us(leuko_output_buffer_t *out, uint64_t ns)
+{
+    return leuko_output_buffer_printf(out, "%llu.%03u", (unsigned long long)(ns / 1000), (unsigned)(ns % 1000));
+}
+
+/**
+ * @brief Write the trace in Chrome Trace Event format.
+ * @param trace Trace (workers must be done)
+ * @param path Output file (`chrome://tracing`, Perfetto)
+ * @return false on failure
+ * @note Every span is a complete ("X") event on the thread of its worker.
+ *       When a worker recorded more than LEUKO_TRACE_RING_EVENTS spans, only
+ *       its latest ones are written and the number dropped is reported in
+ *       `otherData`.
+ */
+bool leuko_trace_write(const leuko_trace_t *trace, const char *path)
+{
+    leuko_output_buffer_t out;
+    leuko_output_buffer_init(&out);
+    uint64_t dropped = 0;
+    bool ok = leuko_output_buffer_puts(&out, "{\"traceEvents\":[");
+    for (size_t t = 0; t < trace->ring_count && ok; ++t)
+    {
+        const leuko_trace_ring_t *ring = &trace->rings[t];
+        ok = leuko_output_buffer_printf(&out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":\"worker %zu\"}}", t ? "," : "", t, t);
+        uint64_t first = ring->recorded > LEUKO_TRACE_RING_EVENTS ? ring->recorded - LEUKO_TRACE_RING_EVENTS : 0;
+        dropped += first;
+        for (uint64_t i = first; i < ring->recorded && ok; ++i)
+        {
+            const leuko_trace_event_t *event = &ring->events[i & (LEUKO_TRACE_RING_EVENTS - 1)];
+            uint64_t start = event->start > trace->origin ? event->start - trace->origin : 0;
+            ok = leuko_output_buffer_printf(&out, ",{\"name\":\"%s\",\"cat\":\"leuko\",\"ph\":\"X\",\"pid\":1,\"tid\":%zu,\"ts\":", event->name, t) &&
+                 leuko_trace_append_us(&out, start) && leuko_output_buffer_puts(&out, ",\"dur\":") && leuko_trace_append_us(&out, event->end - event->start);
+            if (ok && event->file)
+            {
+                ok = leuko_output_buffer_puts(&out, ",\"args\":{\"file\":") && leuko_json_append_string(&out, event->file, strlen(event->file)) &&
+                     leuko_output_buffer_putc(&out, '}');
+            }
+            ok = ok && leuko_output_buffer_putc(&out, '}');
+        }
+    }
+    ok = ok && leuko_output_buffer_printf(&out, "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":%llu}}\n", (unsigned long long)dropped);
+    ok = ok && leuko_file_write_atomic(path, (const uint8_t *)out.data, out.len, 0644);
+    if (!ok)
+    {
+        fprintf(stderr, "%s: could not write trace\n", path);
+    }
+    leuko_output_buffer_free(&out);
+    return ok;
+}
+
+/**
+ * @brief Release the rings of a trace.
+ * @param trace Trace
+ */
+void leuko_trace_free(leuko_trace_t *trace)
+{
+    for (size_t i = 0; trace->rings && i < trace->ring_count; ++i)
+    {
+        free(trace->rings[i].events);
+    }
+    free(trace->rings);
+    trace->rings = NULL;
+    trace->ring_count = 0;
+}
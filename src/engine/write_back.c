@@ -0,0 +1,155 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "engine/write_back.h"
+#include "utils/file.h"
+
+/**
+ * @brief Initialize a write-back stage.
+ * @param wb Write-back stage
+ * @param sync Sync files and directories to disk before reporting them written
+ */
+void leuko_write_back_init(leuko_write_back_t *wb, bool sync)
+{
+    memset(wb, 0, sizeof(*wb));
+    wb->sync = sync;
+}
+
+/**
+ * @brief Record the outcome of replacing one file.
+ * @param wb Write-back stage
+ * @param target Replaced path
+ * @param ok Whether the file was replaced
+ * @return ok
+ */
+static bool leuko_write_back_done(leuko_write_back_t *wb, const char *target, bool ok)
+{
+    if (ok)
+    {
+        wb->written++;
+    }
+    else
+    {
+        wb->failed++;
+        fprintf(stderr, "%s: could not write corrected file\n", target);
+    }
+    return ok;
+}
+
+/**
+ * @brief Check whether two paths live in the same directory.
+ */
+static bool leuko_write_back_same_dir(const char *a, const char *b)
+{
+    const char *sa = strrchr(a, '/');
+    const char *sb = strrchr(b, '/');
+    size_t na = sa ? (size_t)(sa - a) : 0;
+    size_t nb = sb ? (size_t)(sb - b) : 0;
+    return na == nb && memcmp(a, b, na) == 0;
+}
+
+/**
+ * @brief Write a corrected file back if its bytes changed.
+ * @param wb Write-back stage
+ * @param path File path (symbolic links are followed, so the link is kept)
+ * @param original Bytes the file had when it was read
+ * @param original_len Number of original bytes
+ * @param data Corrected bytes
+ * @param len Number of corrected bytes
+ * @return false if the file, or the batch flushed with it, could not be
+ *         written (reported on stderr and counted in `wb->failed`)
+ * @note Unchanged files are not touched, so their mtime stays valid for
+ *       build caches. Changed files get the permission bits (and, where
+ *       allowed, the owner) of the file they replace and a new mtime. When
+ *       syncing, the rename is deferred to the next batch flush.
+ */
+bool leuko_write_back_file(leuko_write_back_t *wb, const char *path, const uint8_t *original, size_t original_len, const uint8_t *data, size_t len)
+{
+    if (original_len == len && memcmp(original, data, len) == 0)
+    {
+        return true;
+    }
+    char *target = realpath(path, NULL);
+    struct stat st;
+    if (!target || stat(target, &st) != 0)
+    {
+        free(target);
+        return leuko_write_back_done(wb, path, false);
+    }
+    char *tmp = NULL;
+    int fd = leuko_file_write_temp(target, data, len, st.st_mode & 07777, &tmp);
+    if (fd < 0)
+    {
+        bool ok = leuko_write_back_done(wb, target, false);
+        free(target);
+        return ok;
+    }
+    if (fchown(fd, st.st_uid, st.st_gid) != 0)
+    {
+        /* not permitted: the file keeps the owner of the process */
+    }
+
+    if (wb->sync)
+    {
+        wb->pending[wb->count++] = (leuko_write_back_pending_t){.fd = fd, .tmp = tmp, .target = target};
+        return wb->count < LEUKO_WRITE_BACK_BATCH || leuko_write_back_flush(wb);
+    }
+    bool ok = close(fd) == 0 && rename(tmp, target) == 0;
+    if (!ok)
+    {
+        unlink(tmp);
+    }
+    ok = leuko_write_back_done(wb, target, ok);
+    free(tmp);
+    free(target);
+    return ok;
+}
+
+/**
+ * @brief Sync and rename every pending file.
+ * @param wb Write-back stage
+ * @return false if any pending file could not be written (reported on stderr)
+ * @note Must be called once the worker is done so no file is left behind.
+ */
+bool leuko_write_back_flush(leuko_write_back_t *wb)
+{
+    bool all_ok = true;
+    for (size_t i = 0; i < wb->count; ++i)
+    {
+        leuko_write_back_pending_t *p = &wb->pending[i];
+        bool ok = fsync(p->fd) == 0;
+        ok = close(p->fd) == 0 && ok;
+        ok = ok && rename(p->tmp, p->target) == 0;
+        if (!ok)
+        {
+            unlink(p->tmp);
+            free(p->tmp);
+            p->tmp = NULL;
+        }
+        all_ok = leuko_write_back_done(wb, p->target, ok) && all_ok;
+    }
+    for (size_t i = 0; i < wb->count; ++i)
+    {
+        leuko_write_back_pending_t *p = &wb->pending[i];
+        bool synced = !p->tmp;
+        for (size_t j = 0; j < i && !synced; ++j)
+        {
+            synced = wb->pending[j].tmp && leuko_write_back_same_dir(wb->pending[j].target, p->target);
+        }
+        if (!synced && !leuko_file_sync_parent(p->target))
+        {
+            fprintf(stderr, "%s: could not sync directory\n", p->target);
+            wb->failed++;
+            all_ok = false;
+        }
+    }
+    for (size_t i = 0; i < wb->count; ++i)
+    {
+        free(wb->pending[i].tmp);
+        free(wb->pending[i].target);
+    }
+    wb->count = 0;
+    return all_ok;
+}
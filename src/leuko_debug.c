@@ -1,17 +1,202 @@
-#include <stdio.h>
+#include <pthread.h>
 #include <stdarg.h>
-#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include "leuko_debug.h"
+#include "output/output_writer.h"
 
 /* Diagnostic counters (visible to other translation units) */
 size_t g_diag_created = 0;
 size_t g_diag_freed = 0;
 
-/* Simple debug logging implementation. Prints to stderr. */
+int leuko_log_level = LEUKO_LOG_LEVEL_WARN;
+uint32_t leuko_log_categories = (1u << LEUKO_LOG_CATEGORY_COUNT) - 1;
+
+/**
+ * @brief Size of the per-thread log buffer.
+ */
+#define LEUKO_LOG_BUFFER_SIZE 8192
+
+/**
+ * @brief Room left in the buffer below which it is written out before formatting.
+ */
+#define LEUKO_LOG_LINE_RESERVE 1024
+
+static const char *const leuko_log_level_names[] = {"off", "error", "warn", "info", "debug", "trace"};
+static const char *const leuko_log_category_names[LEUKO_LOG_CATEGORY_COUNT] = {"general", "prism", "engine", "rules", "cli", "io"};
+
+/**
+ * @brief Messages of one thread not yet written to stderr.
+ */
+typedef struct leuko_log_buffer_s
+{
+    char data[LEUKO_LOG_BUFFER_SIZE];
+    size_t len;
+    bool mid_line;   /* the last message did not end with a newline */
+    bool registered; /* flushed when the thread exits */
+} leuko_log_buffer_t;
+
+static __thread leuko_log_buffer_t leuko_log_buffer;
+static pthread_key_t leuko_log_key;
+static pthread_once_t leuko_log_once = PTHREAD_ONCE_INIT;
+
+static void leuko_log_drain(leuko_log_buffer_t *buf)
+{
+    if (buf->len > 0)
+    {
+        leuko_output_write_all(STDERR_FILENO, buf->data, buf->len);
+        buf->len = 0;
+    }
+}
+
+static void leuko_log_thread_exit(void *data)
+{
+    leuko_log_drain(data);
+}
+
+static void leuko_log_process_exit(void)
+{
+    leuko_log_flush();
+}
+
+static void leuko_log_setup(void)
+{
+    pthread_key_create(&leuko_log_key, leuko_log_thread_exit);
+    atexit(leuko_log_process_exit);
+}
+
+/**
+ * @brief Format a message into the buffer of the calling thread.
+ * @note The buffer is written to stderr with one write when it runs low,
+ *       when the thread exits, at process exit, and after every error.
+ */
+static void leuko_log_vwrite(int level, leuko_log_category_t category, const char *fmt, va_list ap)
+{
+    leuko_log_buffer_t *buf = &leuko_log_buffer;
+    if (!buf->registered)
+    {
+        pthread_once(&leuko_log_once, leuko_log_setup);
+        pthread_setspecific(leuko_log_key, buf);
+        buf->registered = true;
+    }
+    if (sizeof(buf->data) - buf->len < LEUKO_LOG_LINE_RESERVE)
+    {
+        leuko_log_drain(buf);
+    }
+    if (!buf->mid_line)
+    {
+        int n = snprintf(buf->data + buf->len, sizeof(buf->data) - buf->len, "[%s %s] ", leuko_log_level_names[level], leuko_log_category_names[category]);
+        buf->len += n > 0 ? (size_t)n : 0;
+    }
+    size_t room = sizeof(buf->data) - buf->len;
+    int n = vsnprintf(buf->data + buf->len, room, fmt, ap);
+    if (n > 0 && (size_t)n >= room)
+    {
+        /* truncated: keep what fits and end the line */
+        buf->len = sizeof(buf->data) - 1;
+        buf->data[buf->len - 1] = '\n';
+    }
+    else if (n > 0)
+    {
+        buf->len += (size_t)n;
+    }
+    buf->mid_line = buf->len > 0 && buf->data[buf->len - 1] != '\n';
+    if (level <= LEUKO_LOG_LEVEL_ERROR)
+    {
+        leuko_log_drain(buf);
+    }
+}
+
+/**
+ * @brief Format a message if the runtime settings let it through.
+ * @param level Message level
+ * @param category Message category
+ * @param fmt printf format
+ * @note Use the `LEUKO_LOG_*` macros, which compile out above LEUKO_LOG_LEVEL.
+ */
+void leuko_log_write(int level, leuko_log_category_t category, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    leuko_log_vwrite(level, category, fmt, ap);
+    va_end(ap);
+}
+
+/**
+ * @brief Write out the messages buffered by the calling thread.
+ */
+void leuko_log_flush(void)
+{
+    leuko_log_drain(&leuko_log_buffer);
+}
+
+/**
+ * @brief Read the runtime log settings from `LEUKO_LOG`.
+ * @note The format is `<level>[:<category>,...]`, e.g. `debug:engine,rules`.
+ *       Levels above LEUKO_LOG_LEVEL are accepted but print nothing more.
+ *       Without the variable, warnings and errors of every category are
+ *       printed.
+ */
+void leuko_log_init(void)
+{
+    const char *env = getenv("LEUKO_LOG");
+    if (!env || !*env)
+    {
+        return;
+    }
+    const char *colon = strchr(env, ':');
+    size_t level_len = colon ? (size_t)(colon - env) : strlen(env);
+    int level = -1;
+    for (int i = LEUKO_LOG_LEVEL_OFF; i <= LEUKO_LOG_LEVEL_TRACE; ++i)
+    {
+        if (strlen(leuko_log_level_names[i]) == level_len && strncmp(env, leuko_log_level_names[i], level_len) == 0)
+        {
+            level = i;
+        }
+    }
+    if (level < 0)
+    {
+        fprintf(stderr, "LEUKO_LOG: unknown level %.*s\n", (int)level_len, env);
+        return;
+    }
+    uint32_t categories = (1u << LEUKO_LOG_CATEGORY_COUNT) - 1;
+    if (colon)
+    {
+        categories = 0;
+        for (const char *p = colon + 1; *p;)
+        {
+            size_t len = strcspn(p, ",");
+            bool found = false;
+            for (int c = 0; c < LEUKO_LOG_CATEGORY_COUNT; ++c)
+            {
+                if (strlen(leuko_log_category_names[c]) == len && strncmp(p, leuko_log_category_names[c], len) == 0)
+                {
+                    categories |= 1u << c;
+                    found = true;
+                }
+            }
+            if (!found && len > 0)
+            {
+                fprintf(stderr, "LEUKO_LOG: unknown category %.*s\n", (int)len, p);
+            }
+            p += len + (p[len] == ',');
+        }
+    }
+    __atomic_store_n(&leuko_log_categories, categories, __ATOMIC_RELAXED);
+    __atomic_store_n(&leuko_log_level, level, __ATOMIC_RELAXED);
+}
+
+/* Debug logging hook kept for vendor Prism: a Prism debug message. */
 void leuko_debug_log(const char *fmt, ...)
 {
+    if (LEUKO_LOG_LEVEL < LEUKO_LOG_LEVEL_DEBUG || !leuko_log_enabled(LEUKO_LOG_LEVEL_DEBUG, LEUKO_LOG_PRISM))
+    {
+        return;
+    }
     va_list ap;
     va_start(ap, fmt);
-    vfprintf(stderr, fmt, ap);
+    leuko_log_vwrite(LEUKO_LOG_LEVEL_DEBUG, LEUKO_LOG_PRISM, fmt, ap);
     va_end(ap);
 }
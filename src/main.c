@@ -2,6 +2,17 @@
 #include "cli/parser.h"
 #include "cli/init.h"
 #include "cli/sync.h"
+#include "cli/formatter.h"
+#include "engine/engine.h"
+#include "engine/profile.h"
+#include "engine/trace.h"
+#include "engine/runner.h"
+#include "leuko_debug.h"
+#include "output/output_buffer.h"
+#include "output/output_writer.h"
+#include "rules/rule.h"
+#include "utils/file.h"
+#include "utils/git_diff.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -16,6 +27,7 @@
  */
 int main(int argc, char *argv[])
 {
+    leuko_log_init();
     leuko_cli_options_t cli_opts = {0};
     leuko_parse_result_t parse_result = leuko_cli_options_parse(argc, argv, &cli_opts);
     switch (parse_result)
@@ -48,6 +60,158 @@ int main(int argc, char *argv[])
         return rc;
     }
 
+    /* --only and --except narrow the rules run on every file; a file whose
+       enabled rules all work on lines is not parsed. */
+    leuko_rule_set_t enabled;
+    bool selected = cli_opts.only_count > 0 || cli_opts.except_count > 0;
+    if (selected && !leuko_rules_select(cli_opts.only, cli_opts.only_count, cli_opts.except, cli_opts.except_count, &enabled))
+    {
+        leuko_cli_options_free(&cli_opts);
+        return LEUKO_EXIT_INVALID;
+    }
+
+    char **files = NULL;
+    size_t files_count = 0;
+    if (!leuko_file_collect_ruby(cli_opts.paths, cli_opts.paths_count, &files, &files_count))
+    {
+        leuko_cli_options_free(&cli_opts);
+        return LEUKO_EXIT_INVALID;
+    }
+
+    /* With --changed-since only the files git reports as changed are linted,
+       and with --changed-lines only offenses on their changed lines are
+       reported. */
+    leuko_git_changes_t changes = {0};
+    const leuko_line_set_t **lines = NULL;
+    if (cli_opts.changed_since)
+    {
+        lines = cli_opts.changed_lines ? calloc(files_count ? files_count : 1, sizeof(*lines)) : NULL;
+        if (!leuko_git_changes_load(cli_opts.changed_since, &changes) || (cli_opts.changed_lines && !lines))
+        {
+            for (size_t i = 0; i < files_count; ++i)
+            {
+                free(files[i]);
+            }
+            free(files);
+            free(lines);
+            leuko_git_changes_free(&changes);
+            leuko_cli_options_free(&cli_opts);
+            return LEUKO_EXIT_INVALID;
+        }
+        size_t kept = 0;
+        for (size_t i = 0; i < files_count; ++i)
+        {
+            const leuko_git_changed_file_t *changed = leuko_git_changes_find(&changes, files[i]);
+            if (!changed)
+            {
+                free(files[i]);
+                continue;
+            }
+            if (lines)
+            {
+                lines[kept] = &changed->lines;
+            }
+            files[kept++] = files[i];
+        }
+        files_count = kept;
+    }
+
+    /* The diff formatter prints the corrections instead of applying them
+       (safe ones unless -A asks for all). */
+    bool diff_only = cli_opts.formatter == LEUKO_CLI_FORMATTER_DIFF && !cli_opts.exit_code_only;
+
+    /* In exit-code-only mode nothing is printed and the first failing
+       diagnostic cancels all remaining work (unless files are being
+       corrected, which must run to the end). */
+    leuko_runner_options_t run_opts = {
+        .jobs = cli_opts.parallel ? 0 : 1,
+        .fsync = cli_opts.fsync,
+        .dry_run = diff_only,
+        .lines = lines,
+        .engine = {
+            .cancel = NULL,
+            .stop_on_diagnostic = cli_opts.exit_code_only && cli_opts.fix_mode == LEUKO_FIX_MODE_NONE,
+            .fail_level = cli_opts.fail_level,
+            .fix_mode = diff_only && cli_opts.fix_mode == LEUKO_FIX_MODE_NONE ? LEUKO_FIX_MODE_SAFE : cli_opts.fix_mode,
+            .enabled = selected ? &enabled : NULL,
+        },
+        .on_result = NULL,
+        .on_file_done = NULL,
+        .data = NULL,
+    };
+
+    /* With --profile-rules every worker times the rules it runs; the
+       timings are merged and printed to stderr once the run is over. */
+    size_t jobs = leuko_runner_jobs(&run_opts, files_count);
+    leuko_rule_profile_t *profiles = cli_opts.profile_rules ? calloc(jobs, sizeof(*profiles)) : NULL;
+    run_opts.engine.profiles = profiles;
+
+    /* With --trace every worker records the stages of its files in its own
+       ring; the timeline is written once the run is over. */
+    leuko_trace_t trace = {0};
+    bool tracing = cli_opts.trace_path && leuko_trace_init(&trace, jobs);
+    run_opts.engine.trace = tracing ? &trace : NULL;
+
+    /* Workers render into their own buffers; output is written in file
+       order by the report's writer thread. */
+    leuko_cli_report_t report;
+    bool reporting = !cli_opts.exit_code_only;
+    if (reporting)
+    {
+        if (!leuko_cli_report_begin(&report, cli_opts.formatter, files, files_count, jobs, STDOUT_FILENO))
+        {
+            free(profiles);
+            leuko_trace_free(&trace);
+            for (size_t i = 0; i < files_count; ++i)
+            {
+                free(files[i]);
+            }
+            free(files);
+            free(lines);
+            leuko_git_changes_free(&changes);
+            leuko_cli_options_free(&cli_opts);
+            return LEUKO_EXIT_INVALID;
+        }
+        run_opts.on_result = leuko_cli_report_on_result;
+        run_opts.on_file_done = leuko_cli_report_on_file_done;
+        run_opts.data = &report;
+    }
+
+    leuko_runner_stats_t stats;
+    bool ok = leuko_runner_run(files, files_count, &run_opts, &stats);
+    if (reporting)
+    {
+        ok = leuko_cli_report_end(&report) && ok;
+    }
+    if (cli_opts.profile_rules)
+    {
+        leuko_output_buffer_t out;
+        leuko_output_buffer_init(&out);
+        for (size_t i = 1; profiles && i < jobs; ++i)
+        {
+            leuko_rule_profile_merge(&profiles[0], &profiles[i]);
+        }
+        ok = profiles && leuko_rule_profile_render(&profiles[0], cli_opts.profile_format, &out) && leuko_output_write_all(STDERR_FILENO, out.data, out.len) && ok;
+        leuko_output_buffer_free(&out);
+        free(profiles);
+    }
+    if (cli_opts.trace_path)
+    {
+        ok = tracing && leuko_trace_write(&trace, cli_opts.trace_path) && ok;
+        leuko_trace_free(&trace);
+    }
+    for (size_t i = 0; i < files_count; ++i)
+    {
+        free(files[i]);
+    }
+    free(files);
+    free(lines);
+    leuko_git_changes_free(&changes);
+
     leuko_cli_options_free(&cli_opts);
-    return LEUKO_EXIT_OK;
+    if (!ok || stats.write_failed)
+    {
+        return LEUKO_EXIT_INVALID;
+    }
+    return stats.failed ? LEUKO_EXIT_DIAGNOSTICS : LEUKO_EXIT_OK;
 }
@@ -0,0 +1,121 @@
+#include <string.h>
+#include "output/json_escape.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief Whether a byte must be escaped inside a JSON string.
+ * @param c Byte
+ * @return true for control characters, '"' and '\\'
+ */
+static inline bool leuko_json_needs_escape(unsigned char c)
+{
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+/**
+ * @brief Find the first byte that must be escaped inside a JSON string.
+ * @param s Bytes (UTF-8)
+ * @param n Number of bytes
+ * @return Index of the first such byte, or `n` if there is none
+ * @note Scans 16 bytes per step with SSE2 or NEON when available; the tail
+ *       (and other targets) use the scalar loop. Bytes >= 0x80 never need
+ *       escaping, so UTF-8 sequences are copied as they are.
+ */
+size_t leuko_json_escape_scan(const char *s, size_t n)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+        /* v <= 0x1F (unsigned) iff max(v, 0x1F) == 0x1F */
+        __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(_mm_max_epu8(v, control), control), _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)));
+        int mask = _mm_movemask_epi8(hit);
+        if (mask)
+        {
+            return i + (size_t)__builtin_ctz((unsigned)mask);
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t control = vdupq_n_u8(0x20);
+    for (; i + 16 <= n; i += 16)
+    {
+        uint8x16_t v = vld1q_u8((const uint8_t *)(s + i));
+        uint8x16_t hit = vorrq_u8(vcltq_u8(v, control), vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, backslash)));
+        if (vmaxvq_u8(hit))
+        {
+            break; /* locate the byte with the scalar loop below */
+        }
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        if (leuko_json_needs_escape((unsigned char)s[i]))
+        {
+            return i;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief Append a JSON string literal, quotes included.
+ * @param out Output buffer
+ * @param s Text (UTF-8, not necessarily NUL-terminated)
+ * @param n Number of bytes
+ * @return true on success, false on allocation failure
+ * @note Clean runs between escapes are copied with a single append, so
+ *       typical messages and paths cost one scan and one copy.
+ */
+bool leuko_json_append_string(leuko_output_buffer_t *out, const char *s, size_t n)
+{
+    static const char hex[] = "0123456789abcdef";
+    bool ok = leuko_output_buffer_putc(out, '"');
+    while (ok && n > 0)
+    {
+        size_t run = leuko_json_escape_scan(s, n);
+        ok = leuko_output_buffer_append(out, s, run);
+        if (!ok || run == n)
+        {
+            break;
+        }
+        unsigned char c = (unsigned char)s[run];
+        switch (c)
+        {
+        case '"':
+            ok = leuko_output_buffer_append(out, "\\\"", 2);
+            break;
+        case '\\':
+            ok = leuko_output_buffer_append(out, "\\\\", 2);
+            break;
+        case '\n':
+            ok = leuko_output_buffer_append(out, "\\n", 2);
+            break;
+        case '\r':
+            ok = leuko_output_buffer_append(out, "\\r", 2);
+            break;
+        case '\t':
+            ok = leuko_output_buffer_append(out, "\\t", 2);
+            break;
+        default:
+        {
+            char esc[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+            ok = leuko_output_buffer_append(out, esc, sizeof(esc));
+            break;
+        }
+        }
+        s += run + 1;
+        n -= run + 1;
+    }
+    return ok && leuko_output_buffer_putc(out, '"');
+}
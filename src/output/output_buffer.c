@@ -0,0 +1,158 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "output/output_buffer.h"
+
+/**
+ * @brief Initial allocation of a buffer.
+ */
+#define LEUKO_OUTPUT_BUFFER_INITIAL_CAPACITY 4096
+
+/**
+ * @brief Initialize an empty output buffer (no allocation).
+ * @param buf Output buffer
+ */
+void leuko_output_buffer_init(leuko_output_buffer_t *buf)
+{
+    buf->data = NULL;
+    buf->len = 0;
+    buf->cap = 0;
+}
+
+/**
+ * @brief Make room for at least `extra` more bytes (slow path of append).
+ * @param buf Output buffer
+ * @param extra Number of bytes needed beyond the current length
+ * @return true on success, false on allocation failure
+ */
+bool leuko_output_buffer_grow(leuko_output_buffer_t *buf, size_t extra)
+{
+    size_t cap = buf->cap ? buf->cap : LEUKO_OUTPUT_BUFFER_INITIAL_CAPACITY;
+    while (cap - buf->len < extra)
+    {
+        cap *= 2;
+    }
+    if (cap == buf->cap)
+    {
+        return true;
+    }
+    char *data = realloc(buf->data, cap);
+    if (!data)
+    {
+        return false;
+    }
+    buf->data = data;
+    buf->cap = cap;
+    return true;
+}
+
+/**
+ * @brief Append a NUL-terminated string.
+ * @param buf Output buffer
+ * @param s String to append
+ * @return true on success, false on allocation failure
+ */
+bool leuko_output_buffer_puts(leuko_output_buffer_t *buf, const char *s)
+{
+    return leuko_output_buffer_append(buf, s, strlen(s));
+}
+
+/**
+ * @brief Append printf-style formatted text.
+ * @param buf Output buffer
+ * @param fmt Format string
+ * @return true on success, false on allocation or format failure
+ */
+bool leuko_output_buffer_printf(leuko_output_buffer_t *buf, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    size_t avail = buf->cap - buf->len;
+    int n = vsnprintf(avail ? buf->data + buf->len : NULL, avail, fmt, ap);
+    va_end(ap);
+    if (n < 0)
+    {
+        return false;
+    }
+    if ((size_t)n >= avail)
+    {
+        if (!leuko_output_buffer_grow(buf, (size_t)n + 1))
+        {
+            return false;
+        }
+        va_start(ap, fmt);
+        vsnprintf(buf->data + buf->len, buf->cap - buf->len, fmt, ap);
+        va_end(ap);
+    }
+    buf->len += (size_t)n;
+    return true;
+}
+
+/**
+ * @brief Append an unsigned decimal number.
+ * @param buf Output buffer
+ * @param v Value
+ * @return true on success, false on allocation failure
+ */
+bool leuko_output_buffer_append_uint(leuko_output_buffer_t *buf, uint64_t v)
+{
+    char tmp[20];
+    size_t n = 0;
+    do
+    {
+        tmp[sizeof(tmp) - 1 - n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    return leuko_output_buffer_append(buf, tmp + sizeof(tmp) - n, n);
+}
+
+/**
+ * @brief Append a byte repeated `n` times.
+ * @param buf Output buffer
+ * @param c Byte to repeat
+ * @param n Repeat count
+ * @return true on success, false on allocation failure
+ */
+bool leuko_output_buffer_append_repeat(leuko_output_buffer_t *buf, char c, size_t n)
+{
+    if (buf->cap - buf->len < n && !leuko_output_buffer_grow(buf, n))
+    {
+        return false;
+    }
+    memset(buf->data + buf->len, c, n);
+    buf->len += n;
+    return true;
+}
+
+/**
+ * @brief Hand the rendered bytes over to the caller and reset the buffer.
+ * @param buf Output buffer
+ * @param data Output: rendered bytes (caller frees), NULL if empty
+ * @param len Output: number of bytes
+ */
+void leuko_output_buffer_detach(leuko_output_buffer_t *buf, char **data, size_t *len)
+{
+    if (buf->len == 0)
+    {
+        *data = NULL;
+        *len = 0;
+        return;
+    }
+    *data = buf->data;
+    *len = buf->len;
+    leuko_output_buffer_init(buf);
+}
+
+/**
+ * @brief Free memory owned by the buffer.
+ * @param buf Output buffer
+ */
+void leuko_output_buffer_free(leuko_output_buffer_t *buf)
+{
+    if (!buf)
+    {
+        return;
+    }
+    free(buf->data);
+    leuko_output_buffer_init(buf);
+}
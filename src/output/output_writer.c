@@ -0,0 +1,290 @@
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "output/output_writer.h"
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+/**
+ * @brief One submitted chunk.
+ */
+typedef struct leuko_output_chunk_s
+{
+    char *data;          /* bytes to write now (may be NULL) */
+    size_t len;          /* number of bytes */
+    char *deferred;      /* bytes to keep for the end of the run (may be NULL) */
+    size_t deferred_len; /* number of deferred bytes */
+    int ready;           /* published flag (atomic) */
+} leuko_output_chunk_t;
+
+/**
+ * @brief Writer state.
+ */
+struct leuko_output_writer_s
+{
+    int fd;
+    leuko_output_chunk_t *chunks;
+    size_t chunk_count;
+    size_t next;                    /* next sequence number to write (writer thread only) */
+    leuko_output_buffer_t deferred; /* deferred bytes collected in sequence order */
+    int done;                       /* no more submissions (atomic) */
+    int sleeping;                   /* writer is waiting for chunks (atomic) */
+    bool failed;                    /* a write failed */
+    pthread_mutex_t mutex;          /* only guards the sleep/wake handshake */
+    pthread_cond_t cond;
+    pthread_t thread;
+};
+
+/**
+ * @brief Write a whole buffer, retrying on short writes and EINTR.
+ * @param fd File descriptor
+ * @param data Bytes to write
+ * @param len Number of bytes
+ * @return true on success, false on write error
+ */
+bool leuko_output_write_all(int fd, const char *data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = write(fd, data, len);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+/**
+ * @brief Write an iovec array completely, resuming after short writes.
+ * @param fd File descriptor
+ * @param iov I/O vectors (modified)
+ * @param iovcnt Number of vectors
+ * @return true on success, false on write error
+ */
+static bool leuko_output_writev_all(int fd, struct iovec *iov, int iovcnt)
+{
+    while (iovcnt > 0)
+    {
+        ssize_t n = writev(fd, iov, iovcnt);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        size_t left = (size_t)n;
+        while (iovcnt > 0 && left >= iov->iov_len)
+        {
+            left -= iov->iov_len;
+            ++iov;
+            --iovcnt;
+        }
+        if (iovcnt > 0)
+        {
+            iov->iov_base = (char *)iov->iov_base + left;
+            iov->iov_len -= left;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Write every contiguous ready chunk starting at `next`.
+ * @param w Writer
+ * @param skip_missing Skip chunks that were never submitted (final drain)
+ */
+static void leuko_output_writer_drain(leuko_output_writer_t *w, bool skip_missing)
+{
+    struct iovec iov[IOV_MAX];
+    while (w->next < w->chunk_count)
+    {
+        int iovcnt = 0;
+        size_t first = w->next;
+        while (w->next < w->chunk_count && iovcnt < IOV_MAX)
+        {
+            leuko_output_chunk_t *c = &w->chunks[w->next];
+            if (!__atomic_load_n(&c->ready, __ATOMIC_ACQUIRE))
+            {
+                if (!skip_missing)
+                {
+                    break;
+                }
+                ++w->next;
+                continue;
+            }
+            if (c->len > 0)
+            {
+                iov[iovcnt].iov_base = c->data;
+                iov[iovcnt].iov_len = c->len;
+                ++iovcnt;
+            }
+            if (c->deferred_len > 0 && !leuko_output_buffer_append(&w->deferred, c->deferred, c->deferred_len))
+            {
+                w->failed = true;
+            }
+            ++w->next;
+        }
+        if (iovcnt > 0 && !w->failed && !leuko_output_writev_all(w->fd, iov, iovcnt))
+        {
+            w->failed = true;
+        }
+        for (size_t i = first; i < w->next; ++i)
+        {
+            free(w->chunks[i].data);
+            free(w->chunks[i].deferred);
+            w->chunks[i].data = NULL;
+            w->chunks[i].deferred = NULL;
+        }
+        if (w->next == first)
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Writer thread main loop.
+ * @param arg Pointer to the writer
+ * @return NULL
+ */
+static void *leuko_output_writer_main(void *arg)
+{
+    leuko_output_writer_t *w = arg;
+    for (;;)
+    {
+        leuko_output_writer_drain(w, false);
+        if (__atomic_load_n(&w->done, __ATOMIC_SEQ_CST))
+        {
+            leuko_output_writer_drain(w, true);
+            break;
+        }
+        /* Sleep until a worker publishes the next chunk or the run ends */
+        pthread_mutex_lock(&w->mutex);
+        __atomic_store_n(&w->sleeping, 1, __ATOMIC_SEQ_CST);
+        while ((w->next >= w->chunk_count || !__atomic_load_n(&w->chunks[w->next].ready, __ATOMIC_SEQ_CST)) && !__atomic_load_n(&w->done, __ATOMIC_SEQ_CST))
+        {
+            pthread_cond_wait(&w->cond, &w->mutex);
+        }
+        __atomic_store_n(&w->sleeping, 0, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&w->mutex);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Wake the writer thread if it is sleeping.
+ * @param w Writer
+ */
+static void leuko_output_writer_wake(leuko_output_writer_t *w)
+{
+    if (__atomic_load_n(&w->sleeping, __ATOMIC_SEQ_CST))
+    {
+        pthread_mutex_lock(&w->mutex);
+        pthread_cond_signal(&w->cond);
+        pthread_mutex_unlock(&w->mutex);
+    }
+}
+
+/**
+ * @brief Create a writer and start its thread.
+ * @param fd Destination file descriptor
+ * @param chunk_count Number of sequence numbers (one chunk each)
+ * @return Writer, or NULL on failure
+ */
+leuko_output_writer_t *leuko_output_writer_new(int fd, size_t chunk_count)
+{
+    leuko_output_writer_t *w = calloc(1, sizeof(*w));
+    if (!w)
+    {
+        return NULL;
+    }
+    w->fd = fd;
+    w->chunk_count = chunk_count;
+    w->chunks = calloc(chunk_count ? chunk_count : 1, sizeof(leuko_output_chunk_t));
+    if (!w->chunks)
+    {
+        free(w);
+        return NULL;
+    }
+    leuko_output_buffer_init(&w->deferred);
+    pthread_mutex_init(&w->mutex, NULL);
+    pthread_cond_init(&w->cond, NULL);
+    if (pthread_create(&w->thread, NULL, leuko_output_writer_main, w) != 0)
+    {
+        pthread_mutex_destroy(&w->mutex);
+        pthread_cond_destroy(&w->cond);
+        free(w->chunks);
+        free(w);
+        return NULL;
+    }
+    return w;
+}
+
+/**
+ * @brief Publish the chunk for a sequence number.
+ * @param w Writer
+ * @param seq Sequence number (each must be submitted at most once)
+ * @param buf Bytes to write in order; ownership moves to the writer and the buffer is reset
+ * @param deferred Bytes to collect for the end of the run (may be NULL); same ownership rules
+ */
+void leuko_output_writer_submit(leuko_output_writer_t *w, size_t seq, leuko_output_buffer_t *buf, leuko_output_buffer_t *deferred)
+{
+    if (seq >= w->chunk_count)
+    {
+        return;
+    }
+    leuko_output_chunk_t *c = &w->chunks[seq];
+    leuko_output_buffer_detach(buf, &c->data, &c->len);
+    if (deferred)
+    {
+        leuko_output_buffer_detach(deferred, &c->deferred, &c->deferred_len);
+    }
+    __atomic_store_n(&c->ready, 1, __ATOMIC_SEQ_CST);
+    leuko_output_writer_wake(w);
+}
+
+/**
+ * @brief Flush all submitted chunks, stop the thread and free the writer.
+ * @param w Writer
+ * @param deferred_out Output: deferred bytes in sequence order (may be NULL to discard)
+ * @return true if every write succeeded
+ * @note Must be called after all submitting threads have finished.
+ */
+bool leuko_output_writer_finish(leuko_output_writer_t *w, leuko_output_buffer_t *deferred_out)
+{
+    __atomic_store_n(&w->done, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_lock(&w->mutex);
+    pthread_cond_signal(&w->cond);
+    pthread_mutex_unlock(&w->mutex);
+    pthread_join(w->thread, NULL);
+
+    bool ok = !w->failed;
+    if (deferred_out)
+    {
+        *deferred_out = w->deferred;
+    }
+    else
+    {
+        leuko_output_buffer_free(&w->deferred);
+    }
+    pthread_mutex_destroy(&w->mutex);
+    pthread_cond_destroy(&w->cond);
+    free(w->chunks);
+    free(w);
+    return ok;
+}
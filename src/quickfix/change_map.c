@@ -0,0 +1,146 @@
+#include <stdlib.h>
+#include <string.h>
+#include "quickfix/change_map.h"
+
+/**
+ * @brief Initialize an empty change map.
+ * @param map Change map
+ */
+void leuko_change_map_init(leuko_change_map_t *map)
+{
+    memset(map, 0, sizeof(*map));
+}
+
+/**
+ * @brief Fold the edits of one pass into the map.
+ * @param map Change map (corrected offsets refer to the source the edits were made against)
+ * @param edits Resolved and applied edits
+ * @return true on success, false on allocation failure (the map is unchanged)
+ * @note One merge sweep over the existing changes and the edits, both in
+ *       source order. Changes and edits that overlap or touch become one
+ *       change; original offsets outside the existing changes follow from
+ *       the running difference between the two sources.
+ */
+bool leuko_change_map_add(leuko_change_map_t *map, const leuko_edit_list_t *edits)
+{
+    size_t need = map->count + edits->count;
+    if (map->scratch_cap < need)
+    {
+        leuko_change_t *scratch = realloc(map->scratch, need * sizeof(leuko_change_t));
+        if (!scratch)
+        {
+            return false;
+        }
+        map->scratch = scratch;
+        map->scratch_cap = need;
+    }
+
+    const leuko_change_t *changes = map->changes;
+    const leuko_edit_t *e = edits->edits;
+    size_t r = 0;
+    size_t k = 0;
+    size_t n = 0;
+    int64_t delta = 0; /* corrected minus original offset after the last change passed */
+    while (r < map->count || k < edits->count)
+    {
+        bool from_change = r < map->count && (k == edits->count || changes[r].begin <= e[k].begin);
+        uint32_t begin = from_change ? changes[r].begin : e[k].begin;
+        uint32_t end = begin;
+        uint32_t orig_begin = from_change ? changes[r].orig_begin : (uint32_t)((int64_t)begin - delta);
+        int64_t shift_before = k > 0 ? edits->shifts[k - 1] : 0;
+        for (;;)
+        {
+            if (r < map->count && changes[r].begin <= end)
+            {
+                end = changes[r].end > end ? changes[r].end : end;
+                delta = (int64_t)changes[r].end - (int64_t)changes[r].orig_end;
+                r++;
+            }
+            else if (k < edits->count && e[k].begin <= end)
+            {
+                end = e[k].end > end ? e[k].end : end;
+                k++;
+            }
+            else
+            {
+                break;
+            }
+        }
+        int64_t shift_after = k > 0 ? edits->shifts[k - 1] : 0;
+        map->scratch[n++] = (leuko_change_t){
+            .orig_begin = orig_begin,
+            .orig_end = (uint32_t)((int64_t)end - delta),
+            .begin = (uint32_t)((int64_t)begin + shift_before),
+            .end = (uint32_t)((int64_t)end + shift_after),
+        };
+    }
+
+    leuko_change_t *tmp = map->changes;
+    size_t tmp_cap = map->capacity;
+    map->changes = map->scratch;
+    map->capacity = map->scratch_cap;
+    map->count = n;
+    map->scratch = tmp;
+    map->scratch_cap = tmp_cap;
+    return true;
+}
+
+/**
+ * @brief Map an offset of the corrected source back to the original source.
+ * @param map Change map
+ * @param offset Offset in the corrected source
+ * @return Offset of the same byte in the original source; inside a change,
+ *         the matching offset of the replaced range (clamped to its end)
+ */
+size_t leuko_change_map_original_offset(const leuko_change_map_t *map, size_t offset)
+{
+    size_t lo = 0;
+    size_t hi = map->count;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (map->changes[mid].begin <= offset)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    if (lo == 0)
+    {
+        return offset;
+    }
+    const leuko_change_t *c = &map->changes[lo - 1];
+    if (offset >= c->end)
+    {
+        return offset - c->end + c->orig_end;
+    }
+    size_t into = offset - c->begin;
+    return c->orig_begin + (into < (size_t)(c->orig_end - c->orig_begin) ? into : (size_t)(c->orig_end - c->orig_begin));
+}
+
+/**
+ * @brief Remove all changes while keeping the allocations.
+ * @param map Change map
+ */
+void leuko_change_map_clear(leuko_change_map_t *map)
+{
+    map->count = 0;
+}
+
+/**
+ * @brief Free memory owned by the map.
+ * @param map Change map
+ */
+void leuko_change_map_free(leuko_change_map_t *map)
+{
+    if (!map)
+    {
+        return;
+    }
+    free(map->changes);
+    free(map->scratch);
+    memset(map, 0, sizeof(*map));
+}
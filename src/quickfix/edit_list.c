@@ -0,0 +1,288 @@
+#include <stdlib.h>
+#include <string.h>
+#include "quickfix/edit_list.h"
+
+/**
+ * @brief Initial number of edits allocated on first push.
+ */
+#define LEUKO_EDIT_LIST_INITIAL_CAPACITY 64
+
+/**
+ * @brief Initialize an empty edit list (no allocation).
+ * @param list Edit list
+ */
+void leuko_edit_list_init(leuko_edit_list_t *list)
+{
+    memset(list, 0, sizeof(*list));
+}
+
+/**
+ * @brief Append an edit.
+ * @param list Edit list
+ * @param group Group of the edit (the index of the corrected diagnostic)
+ * @param begin Start offset of the replaced range
+ * @param end End offset of the replaced range (exclusive)
+ * @param text Replacement text (may be NULL when `text_len` is 0)
+ * @param text_len Length of the replacement
+ * @return true on success, false on allocation failure
+ */
+bool leuko_edit_list_push(leuko_edit_list_t *list, uint32_t group, size_t begin, size_t end, const char *text, size_t text_len)
+{
+    if (list->count == list->capacity)
+    {
+        size_t capacity = list->capacity ? list->capacity * 2 : LEUKO_EDIT_LIST_INITIAL_CAPACITY;
+        leuko_edit_t *edits = realloc(list->edits, capacity * sizeof(leuko_edit_t));
+        if (!edits)
+        {
+            return false;
+        }
+        list->edits = edits;
+        list->capacity = capacity;
+    }
+    if (list->text_cap - list->text_len < text_len)
+    {
+        size_t cap = list->text_cap ? list->text_cap : 256;
+        while (cap - list->text_len < text_len)
+        {
+            cap *= 2;
+        }
+        char *pool = realloc(list->text, cap);
+        if (!pool)
+        {
+            return false;
+        }
+        list->text = pool;
+        list->text_cap = cap;
+    }
+    if (text_len > 0)
+    {
+        memcpy(list->text + list->text_len, text, text_len);
+    }
+    leuko_edit_t *e = &list->edits[list->count];
+    e->begin = (uint32_t)begin;
+    e->end = (uint32_t)end;
+    e->text_offset = (uint32_t)list->text_len;
+    e->text_len = (uint32_t)text_len;
+    e->group = group;
+    e->seq = (uint32_t)list->count;
+    list->text_len += text_len;
+    list->count++;
+    return true;
+}
+
+/**
+ * @brief Order edits by range, then by insertion order.
+ * @note Insertions at an offset sort before a replacement starting there.
+ */
+static int leuko_edit_cmp(const void *a, const void *b)
+{
+    const leuko_edit_t *ea = a;
+    const leuko_edit_t *eb = b;
+    if (ea->begin != eb->begin)
+    {
+        return ea->begin < eb->begin ? -1 : 1;
+    }
+    if (ea->end != eb->end)
+    {
+        return ea->end < eb->end ? -1 : 1;
+    }
+    return (ea->seq > eb->seq) - (ea->seq < eb->seq);
+}
+
+/**
+ * @brief Sort the edits and drop every group that conflicts with an earlier one.
+ * @param list Edit list
+ * @return Number of edits left (0 on allocation failure)
+ * @note Two edits conflict when their ranges overlap or one is inserted
+ *       strictly inside the range the other replaces. Of two conflicting
+ *       groups the later one (higher group) is dropped as a whole; it is
+ *       reported again by the next lint pass and corrected then. Edits that
+ *       touch at a boundary, and insertions at the same offset, do not
+ *       conflict; the latter are applied in insertion order.
+ */
+size_t leuko_edit_list_resolve(leuko_edit_list_t *list)
+{
+    if (list->count == 0)
+    {
+        return 0;
+    }
+    qsort(list->edits, list->count, sizeof(leuko_edit_t), leuko_edit_cmp);
+
+    uint32_t groups = 0;
+    for (size_t i = 0; i < list->count; ++i)
+    {
+        if (list->edits[i].group >= groups)
+        {
+            groups = list->edits[i].group + 1;
+        }
+    }
+    uint8_t *rejected = calloc(groups, 1);
+    if (!rejected)
+    {
+        list->count = 0;
+        return 0;
+    }
+
+    /* The edit reaching furthest right is the only one a later edit (sorted by
+       begin) can overlap with first, so one sweep finds a conflict per group;
+       sweep again until no group is dropped. */
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        const leuko_edit_t *holder = NULL;
+        for (size_t i = 0; i < list->count; ++i)
+        {
+            const leuko_edit_t *e = &list->edits[i];
+            if (rejected[e->group])
+            {
+                continue;
+            }
+            if (holder && e->begin < holder->end)
+            {
+                uint32_t loser = e->group > holder->group ? e->group : holder->group;
+                rejected[loser] = 1;
+                changed = true;
+                if (loser == e->group)
+                {
+                    continue;
+                }
+            }
+            if (!holder || rejected[holder->group] || e->end > holder->end)
+            {
+                holder = e;
+            }
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < list->count; ++i)
+    {
+        if (!rejected[list->edits[i].group])
+        {
+            list->edits[kept++] = list->edits[i];
+        }
+    }
+    list->count = kept;
+    free(rejected);
+    return kept;
+}
+
+/**
+ * @brief Apply resolved edits in one linear copy of the source.
+ * @param list Edit list (after `leuko_edit_list_resolve`)
+ * @param source Original source
+ * @param source_len Length of the original source
+ * @param out Output: rewritten source (malloc'd and NUL-terminated, caller frees)
+ * @param out_len Output: length of the rewritten source
+ * @return true on success, false on allocation failure
+ * @note Records the offset shifts used by `leuko_edit_list_map_offset`.
+ */
+bool leuko_edit_list_apply(leuko_edit_list_t *list, const uint8_t *source, size_t source_len, uint8_t **out, size_t *out_len)
+{
+    *out = NULL;
+    *out_len = 0;
+    if (list->shifts_cap < list->count)
+    {
+        int64_t *shifts = realloc(list->shifts, list->count * sizeof(int64_t));
+        if (!shifts)
+        {
+            return false;
+        }
+        list->shifts = shifts;
+        list->shifts_cap = list->count;
+    }
+
+    int64_t delta = 0;
+    for (size_t i = 0; i < list->count; ++i)
+    {
+        const leuko_edit_t *e = &list->edits[i];
+        delta += (int64_t)e->text_len - (int64_t)(e->end - e->begin);
+        list->shifts[i] = delta;
+    }
+    size_t len = (size_t)((int64_t)source_len + delta);
+    uint8_t *buf = malloc(len + 1);
+    if (!buf)
+    {
+        return false;
+    }
+
+    uint8_t *p = buf;
+    size_t pos = 0;
+    for (size_t i = 0; i < list->count; ++i)
+    {
+        const leuko_edit_t *e = &list->edits[i];
+        memcpy(p, source + pos, e->begin - pos);
+        p += e->begin - pos;
+        if (e->text_len > 0)
+        {
+            memcpy(p, list->text + e->text_offset, e->text_len);
+            p += e->text_len;
+        }
+        pos = e->end;
+    }
+    memcpy(p, source + pos, source_len - pos);
+    buf[len] = '\0';
+    *out = buf;
+    *out_len = len;
+    return true;
+}
+
+/**
+ * @brief Map an offset of the original source to the rewritten source.
+ * @param list Edit list (after `leuko_edit_list_apply`)
+ * @param offset Offset in the original source
+ * @return Offset in the rewritten source
+ * @note Offsets inside a replaced range map to the start of its replacement;
+ *       text inserted exactly at `offset` ends up before it.
+ */
+size_t leuko_edit_list_map_offset(const leuko_edit_list_t *list, size_t offset)
+{
+    /* edits are sorted and disjoint, so `end` is sorted too */
+    size_t lo = 0;
+    size_t hi = list->count;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (list->edits[mid].end <= offset)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    int64_t shift = lo > 0 ? list->shifts[lo - 1] : 0;
+    if (lo < list->count && list->edits[lo].begin < offset)
+    {
+        offset = list->edits[lo].begin;
+    }
+    return (size_t)((int64_t)offset + shift);
+}
+
+/**
+ * @brief Drop all edits but keep the allocations.
+ * @param list Edit list
+ */
+void leuko_edit_list_clear(leuko_edit_list_t *list)
+{
+    list->count = 0;
+    list->text_len = 0;
+}
+
+/**
+ * @brief Free memory owned by the list.
+ * @param list Edit list
+ */
+void leuko_edit_list_free(leuko_edit_list_t *list)
+{
+    if (!list)
+    {
+        return;
+    }
+    free(list->edits);
+    free(list->text);
+    free(list->shifts);
+    memset(list, 0, sizeof(*list));
+}
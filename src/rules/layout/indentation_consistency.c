@@ -0,0 +1,236 @@
+#include <string.h>
+#include "rules/layout.h"
+
+/**
+ * @brief Check whether a node is a bare access modifier (e.g. `private`).
+ * @param node Node to check
+ * @return true if the node is a receiver-less, argument-less access modifier call
+ */
+static bool leuko_is_bare_access_modifier(const pm_node_t *node)
+{
+    if (!PM_NODE_TYPE_P(node, PM_CALL_NODE))
+    {
+        return false;
+    }
+    const pm_call_node_t *call = (const pm_call_node_t *)node;
+    if (call->receiver || call->arguments || call->block || !call->message_loc.start)
+    {
+        return false;
+    }
+    static const char *const modifiers[] = {"private", "protected", "public", "module_function"};
+    size_t len = (size_t)(call->message_loc.end - call->message_loc.start);
+    for (size_t i = 0; i < sizeof(modifiers) / sizeof(modifiers[0]); ++i)
+    {
+        if (strlen(modifiers[i]) == len && memcmp(call->message_loc.start, modifiers[i], len) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Maximum number of string bodies tracked while correcting one statement.
+ */
+#define LEUKO_INDENTATION_CONSISTENCY_MAX_STRINGS 64
+
+/**
+ * @brief Byte ranges of string and heredoc bodies inside a statement.
+ */
+typedef struct leuko_indentation_strings_s
+{
+    const uint8_t *starts[LEUKO_INDENTATION_CONSISTENCY_MAX_STRINGS];
+    const uint8_t *ends[LEUKO_INDENTATION_CONSISTENCY_MAX_STRINGS];
+    size_t count;
+    bool overflow; /* more bodies than tracked: do not correct */
+} leuko_indentation_strings_t;
+
+/**
+ * @brief Prism visitor: collect the bodies of (interpolated) strings and heredocs.
+ * @param node Current node
+ * @param data Pointer to leuko_indentation_strings_t
+ * @return true to continue into child nodes
+ */
+static bool leuko_indentation_collect_strings(const pm_node_t *node, void *data)
+{
+    leuko_indentation_strings_t *strings = data;
+    const uint8_t *start = NULL;
+    const uint8_t *end = NULL;
+    switch (PM_NODE_TYPE(node))
+    {
+    case PM_STRING_NODE:
+    {
+        const pm_string_node_t *str = (const pm_string_node_t *)node;
+        start = str->content_loc.start;
+        end = str->closing_loc.start ? str->closing_loc.end : str->content_loc.end;
+        break;
+    }
+    case PM_X_STRING_NODE:
+    {
+        const pm_x_string_node_t *str = (const pm_x_string_node_t *)node;
+        start = str->content_loc.start;
+        end = str->closing_loc.start ? str->closing_loc.end : str->content_loc.end;
+        break;
+    }
+    case PM_INTERPOLATED_STRING_NODE:
+    {
+        const pm_interpolated_string_node_t *str = (const pm_interpolated_string_node_t *)node;
+        start = str->parts.size > 0 ? str->parts.nodes[0]->location.start : str->opening_loc.end;
+        end = str->closing_loc.start ? str->closing_loc.end : node->location.end;
+        break;
+    }
+    case PM_INTERPOLATED_X_STRING_NODE:
+    {
+        const pm_interpolated_x_string_node_t *str = (const pm_interpolated_x_string_node_t *)node;
+        start = str->parts.size > 0 ? str->parts.nodes[0]->location.start : str->opening_loc.end;
+        end = str->closing_loc.start ? str->closing_loc.end : node->location.end;
+        break;
+    }
+    default:
+        return true;
+    }
+    if (start && end > start)
+    {
+        if (strings->count == LEUKO_INDENTATION_CONSISTENCY_MAX_STRINGS)
+        {
+            strings->overflow = true;
+            return false;
+        }
+        strings->starts[strings->count] = start;
+        strings->ends[strings->count] = end;
+        strings->count++;
+    }
+    return true;
+}
+
+/**
+ * @brief Correct the indentation of a misaligned statement.
+ * @param ctx Rule context
+ * @param node Misaligned statement
+ * @param column Current column of the statement
+ * @param base_column Column it should start at
+ * @note Like RuboCop's AlignmentCorrector, every line of the statement is
+ *       shifted by the same amount so its body keeps its relative layout.
+ *       Blank lines and lines starting inside a string or heredoc body are
+ *       left alone.
+ */
+static void leuko_indentation_consistency_correct(leuko_rule_context_t *ctx, const pm_node_t *node, size_t column, size_t base_column)
+{
+    leuko_indentation_strings_t strings = {.count = 0, .overflow = false};
+    pm_visit_node(node, leuko_indentation_collect_strings, &strings);
+    if (strings.overflow)
+    {
+        return;
+    }
+
+    static const char spaces[] = "                                                                ";
+    const leuko_processed_source_t *ps = ctx->ps;
+    size_t first = (size_t)(leuko_processed_source_line_of_pos(ps, node->location.start) - ps->start_line_number);
+    size_t last = (size_t)(leuko_processed_source_line_of_pos(ps, node->location.end > node->location.start ? node->location.end - 1 : node->location.end) -
+                           ps->start_line_number);
+    for (size_t i = first; i <= last && i < ps->line_count; ++i)
+    {
+        const uint8_t *line = ps->source_start + ps->line_start_offsets[i];
+        bool in_string = false;
+        for (size_t s = 0; s < strings.count && !in_string; ++s)
+        {
+            in_string = strings.starts[s] < line && line < strings.ends[s];
+        }
+        const uint8_t *ws = line;
+        while (ws < ps->source_end && (*ws == ' ' || *ws == '\t'))
+        {
+            ++ws;
+        }
+        if (in_string || ws == ps->source_end || *ws == '\n' || *ws == '\r')
+        {
+            continue;
+        }
+        if (base_column > column)
+        {
+            for (size_t n = base_column - column; n > 0;)
+            {
+                size_t chunk = n < sizeof(spaces) - 1 ? n : sizeof(spaces) - 1;
+                leuko_rule_correct(ctx, line, line, spaces, chunk);
+                n -= chunk;
+            }
+        }
+        else
+        {
+            size_t remove = column - base_column;
+            leuko_rule_correct(ctx, line, line + ((size_t)(ws - line) < remove ? (size_t)(ws - line) : remove), NULL, 0);
+        }
+    }
+}
+
+/**
+ * @brief Check that statements beginning their own line share one column.
+ * @param rule Rule definition
+ * @param ctx Rule context
+ * @param node Node to check
+ * @note Mirrors RuboCop's `check_alignment`: the base column is the column of
+ *       the first (non access modifier) statement.
+ */
+static void leuko_indentation_consistency_check_node(const leuko_rule_t *rule, leuko_rule_context_t *ctx, const pm_node_t *node)
+{
+    if (!PM_NODE_TYPE_P(node, PM_STATEMENTS_NODE))
+    {
+        return;
+    }
+    const pm_node_list_t *body = &((const pm_statements_node_t *)node)->body;
+    if (body->size < 2)
+    {
+        return;
+    }
+
+    bool have_base = false;
+    size_t base_column = 0;
+    int32_t prev_line = -1;
+    for (size_t i = 0; i < body->size; ++i)
+    {
+        const pm_node_t *child = body->nodes[i];
+        if (leuko_is_bare_access_modifier(child))
+        {
+            continue;
+        }
+        leuko_processed_source_pos_info_t info;
+        leuko_processed_source_pos_info(ctx->ps, child->location.start, &info);
+        if (!have_base)
+        {
+            base_column = info.column;
+            have_base = true;
+        }
+        else if (info.line_number > prev_line && info.column != base_column && leuko_processed_source_begins_its_line(ctx->ps, child->location.start))
+        {
+            if (leuko_rule_report(rule, ctx, child->location.start, child->location.end) && leuko_rule_autocorrect_enabled(rule, ctx))
+            {
+                leuko_indentation_consistency_correct(ctx, child, info.column, base_column);
+            }
+        }
+        prev_line = info.line_number;
+    }
+}
+
+/**
+ * @brief Message templates.
+ */
+static const char *const leuko_indentation_consistency_messages[] = {
+    "Inconsistent indentation detected.",
+};
+
+/**
+ * @brief Layout/IndentationConsistency
+ */
+const leuko_rule_t leuko_rule_layout_indentation_consistency = {
+    .id = LEUKO_RULE_ID_INDENTATION_CONSISTENCY,
+    .category = LEUKO_RULE_CATEGORY_NAME_LAYOUT,
+    .name = LEUKO_RULE_NAME_INDENTATION_CONSISTENCY,
+    .severity = LEUKO_SEVERITY_CONVENTION,
+    .messages = leuko_indentation_consistency_messages,
+    .message_count = sizeof(leuko_indentation_consistency_messages) / sizeof(leuko_indentation_consistency_messages[0]),
+    .autocorrectable = true,
+    .safe_autocorrect = true,
+    .features = 0,
+    .check_source = NULL,
+    .check_token = NULL,
+    .check_node = leuko_indentation_consistency_check_node,
+};
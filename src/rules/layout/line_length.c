@@ -0,0 +1,83 @@
+#include "rules/layout.h"
+
+/**
+ * @brief Default maximum line length (RuboCop `Max`).
+ */
+#define LEUKO_LINE_LENGTH_MAX 120
+
+/**
+ * @brief Check the lines of the context's range against the maximum length (in characters).
+ * @param rule Rule definition
+ * @param ctx Rule context
+ * @note The reported range starts at the first character beyond the limit.
+ *       Heredoc bodies are allowed to be long (RuboCop `AllowHeredoc`).
+ */
+static void leuko_line_length_check_source(const leuko_rule_t *rule, leuko_rule_context_t *ctx)
+{
+    leuko_processed_source_t *ps = ctx->ps;
+    for (size_t i = ctx->line_begin; i < ctx->line_end && i < ps->line_count; ++i)
+    {
+        const uint8_t *line = ps->source_start + ps->line_start_offsets[i];
+        const uint8_t *end = (i + 1 < ps->line_count) ? ps->source_start + ps->line_start_offsets[i + 1] : ps->source_end;
+        if (end > line && end[-1] == '\n')
+        {
+            --end;
+        }
+        if (end > line && end[-1] == '\r')
+        {
+            --end;
+        }
+        /* a line cannot exceed the limit in characters without exceeding it in bytes */
+        if ((size_t)(end - line) <= LEUKO_LINE_LENGTH_MAX)
+        {
+            continue;
+        }
+        const uint8_t *flags = leuko_processed_source_line_flags(ps);
+        if (flags && (flags[i] & LEUKO_LINE_HEREDOC))
+        {
+            continue;
+        }
+        size_t length = 0;
+        const uint8_t *overflow = NULL;
+        for (const uint8_t *p = line; p < end; ++p)
+        {
+            if ((*p & 0xC0) != 0x80)
+            {
+                if (length == LEUKO_LINE_LENGTH_MAX)
+                {
+                    overflow = p;
+                }
+                ++length;
+            }
+        }
+        if (overflow)
+        {
+            leuko_rule_report_message(rule, ctx, 0, overflow, end, (int32_t)length, LEUKO_LINE_LENGTH_MAX);
+        }
+    }
+}
+
+/**
+ * @brief Message templates.
+ */
+static const char *const leuko_line_length_messages[] = {
+    "Line is too long. [%d/%d]",
+};
+
+/**
+ * @brief Layout/LineLength
+ */
+const leuko_rule_t leuko_rule_layout_line_length = {
+    .id = LEUKO_RULE_ID_LINE_LENGTH,
+    .category = LEUKO_RULE_CATEGORY_NAME_LAYOUT,
+    .name = LEUKO_RULE_NAME_LINE_LENGTH,
+    .severity = LEUKO_SEVERITY_CONVENTION,
+    .messages = leuko_line_length_messages,
+    .message_count = sizeof(leuko_line_length_messages) / sizeof(leuko_line_length_messages[0]),
+    .autocorrectable = false,
+    .safe_autocorrect = false,
+    .features = 0,
+    .check_source = leuko_line_length_check_source,
+    .check_token = NULL,
+    .check_node = NULL,
+};
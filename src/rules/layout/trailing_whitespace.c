@@ -0,0 +1,74 @@
+#include <string.h>
+#include "rules/layout.h"
+
+/**
+ * @brief Check the lines of the context's range for trailing spaces or tabs.
+ * @param rule Rule definition
+ * @param ctx Rule context
+ * @note The line break (`\n` or `\r\n`) is not part of the line. Lines
+ *       after `__END__` are data and are not checked. A range never
+ *       starts past `__END__`: ranges are only narrowed to lines that had
+ *       offenses. Whitespace ending a line inside a string or heredoc body
+ *       is reported but not removed: it is part of the literal's value.
+ */
+static void leuko_trailing_whitespace_check_source(const leuko_rule_t *rule, leuko_rule_context_t *ctx)
+{
+    leuko_processed_source_t *ps = ctx->ps;
+    size_t source_len = (size_t)(ps->source_end - ps->source_start);
+    for (size_t i = ctx->line_begin; i < ctx->line_end && i < ps->line_count; ++i)
+    {
+        const uint8_t *line = ps->source_start + ps->line_start_offsets[i];
+        const uint8_t *end = (i + 1 < ps->line_count) ? ps->source_start + ps->line_start_offsets[i + 1] : ps->source_start + source_len;
+        if (end > line && end[-1] == '\n')
+        {
+            --end;
+        }
+        if (end > line && end[-1] == '\r')
+        {
+            --end;
+        }
+        if (end - line == 7 && memcmp(line, "__END__", 7) == 0)
+        {
+            break;
+        }
+        const uint8_t *ws = end;
+        while (ws > line && (ws[-1] == ' ' || ws[-1] == '\t'))
+        {
+            --ws;
+        }
+        if (ws < end)
+        {
+            bool reported = leuko_rule_report(rule, ctx, ws, end);
+            const uint8_t *flags = reported && leuko_rule_autocorrect_enabled(rule, ctx) ? leuko_processed_source_line_flags(ps) : NULL;
+            if (flags && !(flags[i] & LEUKO_LINE_IN_STRING))
+            {
+                leuko_rule_correct(ctx, ws, end, NULL, 0);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Message templates.
+ */
+static const char *const leuko_trailing_whitespace_messages[] = {
+    "Trailing whitespace detected.",
+};
+
+/**
+ * @brief Layout/TrailingWhitespace
+ */
+const leuko_rule_t leuko_rule_layout_trailing_whitespace = {
+    .id = LEUKO_RULE_ID_TRAILING_WHITESPACE,
+    .category = LEUKO_RULE_CATEGORY_NAME_LAYOUT,
+    .name = LEUKO_RULE_NAME_TRAILING_WHITESPACE,
+    .severity = LEUKO_SEVERITY_CONVENTION,
+    .messages = leuko_trailing_whitespace_messages,
+    .message_count = sizeof(leuko_trailing_whitespace_messages) / sizeof(leuko_trailing_whitespace_messages[0]),
+    .autocorrectable = true,
+    .safe_autocorrect = true,
+    .features = LEUKO_FEATURE_TRAILING_SPACE,
+    .check_source = leuko_trailing_whitespace_check_source,
+    .check_token = NULL,
+    .check_node = NULL,
+};
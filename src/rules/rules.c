@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <string.h>
+#include "rules/rule.h"
+#include "diagnostics/message.h"
+#include "rules/layout.h"
+
+/**
+ * @brief All implemented rules, in execution order.
+ */
+static const leuko_rule_t *const leuko_rules[] = {
+    &leuko_rule_layout_indentation_consistency,
+    &leuko_rule_layout_line_length,
+    &leuko_rule_layout_trailing_whitespace,
+};
+
+/**
+ * @brief Get all implemented rules.
+ * @param count Output: number of rules
+ * @return Array of rule pointers
+ */
+const leuko_rule_t *const *leuko_rules_all(size_t *count)
+{
+    *count = sizeof(leuko_rules) / sizeof(leuko_rules[0]);
+    return leuko_rules;
+}
+
+/**
+ * @brief Add the rules named by `--only`/`--except` entries to a set.
+ * @param set Rule set
+ * @param names Category (`Layout`), qualified (`Layout/LineLength`), bare (`LineLength`) or snake_case (`line_length`) names
+ * @param count Number of names
+ * @return false if a name is unknown (reported on stderr)
+ */
+static bool leuko_rules_add_names(leuko_rule_set_t *set, char *const *names, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!leuko_rule_set_add_name(set, names[i], strlen(names[i])))
+        {
+            fprintf(stderr, "Unrecognized rule or category: %s\n", names[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Select the rules enabled by `--only` and `--except`.
+ * @param only Names to keep (none: keep all)
+ * @param only_count Number of names to keep
+ * @param except Names to drop
+ * @param except_count Number of names to drop
+ * @param out Output: enabled rules
+ * @return false if a name is unknown
+ * @note Names are looked up in the generated perfect hash of rule names;
+ *       registered rules that are not implemented yet are accepted and
+ *       simply never run.
+ */
+bool leuko_rules_select(char *const *only, size_t only_count, char *const *except, size_t except_count, leuko_rule_set_t *out)
+{
+    leuko_rule_set_t dropped = {{0}};
+    memset(out, 0, sizeof(*out));
+    if (only_count == 0)
+    {
+        memset(out->words, 0xFF, sizeof(out->words));
+    }
+    if (!leuko_rules_add_names(out, only, only_count) || !leuko_rules_add_names(&dropped, except, except_count))
+    {
+        return false;
+    }
+    leuko_rule_set_remove(out, &dropped);
+    return true;
+}
+
+/**
+ * @brief Implemented rules indexed by registry id.
+ */
+static const leuko_rule_t *const leuko_rules_by_id[LEUKO_RULE_ID_COUNT] = {
+    [LEUKO_RULE_ID_INDENTATION_CONSISTENCY] = &leuko_rule_layout_indentation_consistency,
+    [LEUKO_RULE_ID_LINE_LENGTH] = &leuko_rule_layout_line_length,
+    [LEUKO_RULE_ID_TRAILING_WHITESPACE] = &leuko_rule_layout_trailing_whitespace,
+};
+
+/**
+ * @brief Look up an implemented rule by registry id.
+ * @param id Rule registry id
+ * @return Rule, or NULL if the rule is not implemented
+ */
+const leuko_rule_t *leuko_rule_by_id(leuko_rule_id_t id)
+{
+    return id < LEUKO_RULE_ID_COUNT ? leuko_rules_by_id[id] : NULL;
+}
+
+/**
+ * @brief Render the text of a diagnostic message.
+ * @param rule Reporting rule
+ * @param message_id Index into `rule->messages`
+ * @param args LEUKO_DIAGNOSTIC_ARG_MAX message arguments
+ * @param out Output buffer
+ * @param out_size Size of the output buffer
+ * @return Length of the rendered message
+ */
+size_t leuko_rule_render_message(const leuko_rule_t *rule, leuko_message_id_t message_id, const int32_t *args, char *out, size_t out_size)
+{
+    if (!rule || message_id >= rule->message_count)
+    {
+        return leuko_message_render("", args, 0, out, out_size);
+    }
+    return leuko_message_render(rule->messages[message_id], args, LEUKO_DIAGNOSTIC_ARG_MAX, out, out_size);
+}
@@ -0,0 +1,729 @@
+#include <string.h>
+#include "sources/lexer.h"
+
+/**
+ * @brief Deepest nesting of literals and interpolations followed.
+ */
+#define LEUKO_LEX_MAX_DEPTH 32
+
+/**
+ * @brief Most heredocs opened on one line.
+ */
+#define LEUKO_LEX_MAX_HEREDOCS 16
+
+/**
+ * @brief Symbols that join into one operator token (`<=>`, `&&=`, `**`).
+ */
+#define LEUKO_LEX_OPERATOR_CHARS "=<>!~&|*+-.^"
+
+/**
+ * @brief A literal body, or code inside an interpolation (`#{...}`).
+ */
+typedef struct leuko_lex_frame_s
+{
+    bool literal;  /* literal body (otherwise interpolated code) */
+    bool interp;   /* the literal supports `#{}` */
+    bool regexp;   /* option letters follow the closing delimiter */
+    uint8_t open;  /* opening bracket that nests inside the literal (0: none) */
+    uint8_t close; /* closing delimiter */
+    uint32_t nest; /* unmatched brackets (literal) or braces (interpolated code) */
+} leuko_lex_frame_t;
+
+/**
+ * @brief A heredoc whose body starts after the current line.
+ */
+typedef struct leuko_lex_heredoc_s
+{
+    const uint8_t *id; /* terminator */
+    size_t id_len;
+    bool indented; /* `<<-` or `<<~`: the terminator may be indented */
+} leuko_lex_heredoc_t;
+
+/**
+ * @brief Lexer state.
+ */
+typedef struct leuko_lex_s
+{
+    const uint8_t *s;
+    size_t len;
+    size_t pos;
+    size_t line;
+    size_t line_count;
+    uint8_t *flags;
+    leuko_lex_frame_t stack[LEUKO_LEX_MAX_DEPTH];
+    size_t depth; /* 0: top-level code */
+    leuko_lex_heredoc_t heredocs[LEUKO_LEX_MAX_HEREDOCS];
+    size_t heredoc_count;
+    bool value; /* the previous token ends a value, so an operator may follow */
+    bool ident; /* the previous token is an identifier, which may be a method taking a literal argument */
+    bool def;   /* the previous token is `def`: an operator here is a method name */
+    bool klass; /* the previous token is `class`: `<<` here opens a singleton class, not a heredoc */
+    leuko_token_fn on_token; /* token sink (may be NULL) */
+    void *data;
+} leuko_lex_t;
+
+/**
+ * @brief Whether a byte can be part of an identifier.
+ */
+static inline bool leuko_lex_ident_char(uint8_t c)
+{
+    return c == '_' || c >= 0x80 || (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+/**
+ * @brief Whether a byte is a space or a tab.
+ */
+static inline bool leuko_lex_blank(uint8_t c)
+{
+    return c == ' ' || c == '\t';
+}
+
+/**
+ * @brief Set flags on the current line.
+ */
+static inline void leuko_lex_mark(leuko_lex_t *lx, uint8_t flags)
+{
+    if (lx->flags && lx->line < lx->line_count)
+    {
+        lx->flags[lx->line] |= flags;
+    }
+}
+
+/**
+ * @brief Hand a token to the sink.
+ * @param lx Lexer
+ * @param type Token type
+ * @param start Offset of the first byte
+ * @param end Offset past the last byte
+ */
+static inline void leuko_lex_emit(leuko_lex_t *lx, leuko_token_type_t type, size_t start, size_t end)
+{
+    if (lx->on_token)
+    {
+        leuko_token_t token = {.type = type, .start = lx->s + start, .end = lx->s + end};
+        lx->on_token(&token, lx->data);
+    }
+}
+
+/**
+ * @brief Whether the byte at `pos` can start a literal argument.
+ * @param lx Lexer
+ * @param next Position of the first byte after the literal's opening
+ * @note After an operator or a keyword a literal always starts here. After
+ *       an identifier it does when a space comes before and none after, like
+ *       Ruby reads `puts /x/` and `foo <<~EOS` (and not `a / b`).
+ */
+static bool leuko_lex_argument(const leuko_lex_t *lx, size_t next)
+{
+    if (!lx->value)
+    {
+        return true;
+    }
+    return lx->ident && lx->pos > 0 && leuko_lex_blank(lx->s[lx->pos - 1]) && next < lx->len && !leuko_lex_blank(lx->s[next]) && lx->s[next] != '=' &&
+           lx->s[next] != '\n';
+}
+
+/**
+ * @brief Skip the bodies of the heredocs opened on the line just ended.
+ * @param lx Lexer positioned at the start of the first body line
+ */
+static void leuko_lex_heredoc_bodies(leuko_lex_t *lx)
+{
+    for (size_t h = 0; h < lx->heredoc_count; ++h)
+    {
+        const leuko_lex_heredoc_t *doc = &lx->heredocs[h];
+        while (lx->pos < lx->len)
+        {
+            const uint8_t *nl = memchr(lx->s + lx->pos, '\n', lx->len - lx->pos);
+            size_t end = nl ? (size_t)(nl - lx->s) : lx->len;
+            size_t b = lx->pos;
+            while (doc->indented && b < end && leuko_lex_blank(lx->s[b]))
+            {
+                ++b;
+            }
+            size_t e = end > b && lx->s[end - 1] == '\r' ? end - 1 : end;
+            bool terminator = e - b == doc->id_len && memcmp(lx->s + b, doc->id, doc->id_len) == 0;
+            if (terminator)
+            {
+                leuko_lex_emit(lx, LEUKO_TOKEN_HEREDOC_END, b, e);
+            }
+            else
+            {
+                leuko_lex_mark(lx, LEUKO_LINE_HEREDOC | LEUKO_LINE_IN_STRING);
+            }
+            lx->pos = nl ? end + 1 : lx->len;
+            lx->line += nl != NULL;
+            if (terminator)
+            {
+                break;
+            }
+        }
+    }
+    lx->heredoc_count = 0;
+}
+
+/**
+ * @brief Consume a line break.
+ * @param lx Lexer positioned at the `\n`
+ * @param in_literal The line break is part of a literal
+ * @note Heredoc bodies start on the line after their opening, whatever
+ *       else is still open on it.
+ */
+static void leuko_lex_newline(leuko_lex_t *lx, bool in_literal)
+{
+    if (in_literal)
+    {
+        leuko_lex_mark(lx, LEUKO_LINE_IN_STRING);
+    }
+    lx->pos++;
+    lx->line++;
+    if (lx->heredoc_count > 0)
+    {
+        leuko_lex_heredoc_bodies(lx);
+    }
+}
+
+/**
+ * @brief Enter a literal body or an interpolation.
+ * @return false if nesting is too deep to follow
+ */
+static bool leuko_lex_push(leuko_lex_t *lx, leuko_lex_frame_t frame)
+{
+    if (lx->depth == LEUKO_LEX_MAX_DEPTH)
+    {
+        return false;
+    }
+    lx->stack[lx->depth++] = frame;
+    lx->value = false;
+    lx->ident = false;
+    return true;
+}
+
+/**
+ * @brief Enter a literal delimited by `delim`.
+ * @param lx Lexer positioned after the delimiter
+ * @param delim Opening delimiter
+ * @param interp The literal supports `#{}`
+ * @param regexp The literal is a regexp
+ */
+static bool leuko_lex_push_literal(leuko_lex_t *lx, uint8_t delim, bool interp, bool regexp)
+{
+    static const char pairs[] = "()[]{}<>";
+    const char *pair = delim ? strchr(pairs, delim) : NULL;
+    leuko_lex_frame_t frame = {
+        .literal = true,
+        .interp = interp,
+        .regexp = regexp,
+        .open = pair && (pair - pairs) % 2 == 0 ? delim : 0,
+        .close = pair && (pair - pairs) % 2 == 0 ? (uint8_t)pair[1] : delim,
+        .nest = 0,
+    };
+    return leuko_lex_push(lx, frame);
+}
+
+/**
+ * @brief Handle the lines that mean something only at the start of a line.
+ * @param lx Lexer at a line start in top-level code
+ * @return true if lexing is over (`__END__`)
+ * @note `=begin`/`=end` comments are skipped whole.
+ */
+static bool leuko_lex_line_start(leuko_lex_t *lx)
+{
+    const uint8_t *p = lx->s + lx->pos;
+    size_t left = lx->len - lx->pos;
+    if (left >= 7 && memcmp(p, "__END__", 7) == 0 && (left == 7 || p[7] == '\n' || (p[7] == '\r' && (left == 8 || p[8] == '\n'))))
+    {
+        for (size_t line = lx->line + 1; lx->flags && line < lx->line_count; ++line)
+        {
+            lx->flags[line] |= LEUKO_LINE_DATA;
+        }
+        return true;
+    }
+    if (left >= 6 && memcmp(p, "=begin", 6) == 0 && (left == 6 || leuko_lex_blank(p[6]) || p[6] == '\n' || p[6] == '\r'))
+    {
+        size_t start = lx->pos;
+        while (lx->pos < lx->len)
+        {
+            const uint8_t *nl = memchr(lx->s + lx->pos, '\n', lx->len - lx->pos);
+            size_t end = nl ? (size_t)(nl - lx->s) : lx->len;
+            bool last = end - lx->pos >= 4 && memcmp(lx->s + lx->pos, "=end", 4) == 0 &&
+                        (end - lx->pos == 4 || leuko_lex_blank(lx->s[lx->pos + 4]) || lx->s[lx->pos + 4] == '\r');
+            lx->pos = end;
+            if (last || !nl)
+            {
+                break;
+            }
+            lx->pos++;
+            lx->line++;
+        }
+        leuko_lex_emit(lx, LEUKO_TOKEN_COMMENT, start, lx->pos);
+    }
+    return false;
+}
+
+/**
+ * @brief Lex one byte (or token) inside a literal body.
+ */
+static void leuko_lex_literal(leuko_lex_t *lx, leuko_lex_frame_t *top)
+{
+    uint8_t c = lx->s[lx->pos];
+    if (c == '\n')
+    {
+        leuko_lex_newline(lx, true);
+    }
+    else if (c == '\\' && lx->pos + 1 < lx->len)
+    {
+        if (lx->s[lx->pos + 1] == '\n')
+        {
+            lx->pos++;
+            leuko_lex_newline(lx, true);
+        }
+        else
+        {
+            lx->pos += 2;
+        }
+    }
+    else if (top->interp && c == '#' && lx->pos + 1 < lx->len && lx->s[lx->pos + 1] == '{')
+    {
+        leuko_lex_emit(lx, LEUKO_TOKEN_EMBEXPR_BEGIN, lx->pos, lx->pos + 2);
+        lx->pos += 2;
+        leuko_lex_frame_t frame = {.literal = false, .close = '}'};
+        if (!leuko_lex_push(lx, frame))
+        {
+            lx->pos = lx->len + 1;
+        }
+    }
+    else if (top->open && c == top->open)
+    {
+        top->nest++;
+        lx->pos++;
+    }
+    else if (c == top->close && top->nest > 0)
+    {
+        top->nest--;
+        lx->pos++;
+    }
+    else if (c == top->close)
+    {
+        size_t start = lx->pos++;
+        if (top->regexp)
+        {
+            while (lx->pos < lx->len && lx->s[lx->pos] >= 'a' && lx->s[lx->pos] <= 'z')
+            {
+                lx->pos++;
+            }
+        }
+        leuko_lex_emit(lx, LEUKO_TOKEN_STRING_END, start, lx->pos);
+        lx->depth--;
+        lx->value = true;
+        lx->ident = false;
+    }
+    else
+    {
+        lx->pos++;
+    }
+}
+
+/**
+ * @brief Try to read a heredoc opening (`<<ID`, `<<-ID`, `<<~ID`, quoted or not).
+ * @param lx Lexer positioned at the first `<`
+ * @return true if one was read (and queued)
+ */
+static bool leuko_lex_heredoc_open(leuko_lex_t *lx)
+{
+    size_t p = lx->pos + 2;
+    bool indented = p < lx->len && (lx->s[p] == '-' || lx->s[p] == '~');
+    p += indented;
+    if (p >= lx->len || !leuko_lex_argument(lx, lx->pos + 2))
+    {
+        return false;
+    }
+    uint8_t quote = lx->s[p];
+    size_t id = p;
+    size_t id_end = p;
+    if (quote == '\'' || quote == '"' || quote == '`')
+    {
+        id = ++p;
+        while (p < lx->len && lx->s[p] != quote && lx->s[p] != '\n')
+        {
+            ++p;
+        }
+        if (p >= lx->len || lx->s[p] != quote)
+        {
+            return false;
+        }
+        id_end = p++;
+    }
+    else
+    {
+        if (lx->s[p] >= '0' && lx->s[p] <= '9')
+        {
+            return false;
+        }
+        while (p < lx->len && leuko_lex_ident_char(lx->s[p]))
+        {
+            ++p;
+        }
+        id_end = p;
+    }
+    if (id_end == id || lx->heredoc_count == LEUKO_LEX_MAX_HEREDOCS)
+    {
+        return false;
+    }
+    lx->heredocs[lx->heredoc_count++] = (leuko_lex_heredoc_t){.id = lx->s + id, .id_len = id_end - id, .indented = indented};
+    leuko_lex_emit(lx, LEUKO_TOKEN_HEREDOC_BEGIN, lx->pos, p);
+    lx->pos = p;
+    lx->value = true;
+    lx->ident = false;
+    return true;
+}
+
+/**
+ * @brief Try to read a percent literal opening (`%w[`, `%q(`, `%{`, ...).
+ * @param lx Lexer positioned at the `%`
+ * @return true if one was read (and entered)
+ */
+static bool leuko_lex_percent_open(leuko_lex_t *lx)
+{
+    size_t p = lx->pos + 1;
+    if (p >= lx->len)
+    {
+        return false;
+    }
+    uint8_t type = 0;
+    if (strchr("qQwWiIrsx", lx->s[p]) && lx->s[p] != '\0')
+    {
+        type = lx->s[p++];
+    }
+    if (p >= lx->len || leuko_lex_ident_char(lx->s[p]) || leuko_lex_blank(lx->s[p]) || lx->s[p] == '\n' || lx->s[p] == '\r' || lx->s[p] == '=')
+    {
+        return false;
+    }
+    if (!leuko_lex_argument(lx, lx->pos + 1))
+    {
+        return false;
+    }
+    uint8_t delim = lx->s[p];
+    leuko_lex_emit(lx, LEUKO_TOKEN_STRING_BEGIN, lx->pos, p + 1);
+    lx->pos = p + 1;
+    bool interp = type == 0 || type == 'Q' || type == 'W' || type == 'I' || type == 'r' || type == 'x';
+    if (!leuko_lex_push_literal(lx, delim, interp, type == 'r'))
+    {
+        lx->pos = lx->len + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief Whether a delimiter comes again later on the current line.
+ * @note Used where an identifier leaves `/` ambiguous: a regexp argument is
+ *       only assumed when it closes on the same line.
+ */
+static bool leuko_lex_closes_on_line(const leuko_lex_t *lx, uint8_t delim)
+{
+    for (size_t p = lx->pos + 1; p < lx->len && lx->s[p] != '\n'; ++p)
+    {
+        if (lx->s[p] == delim)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Words after which an expression starts (no operator can follow).
+ */
+static bool leuko_lex_keyword(const uint8_t *word, size_t len)
+{
+    static const char *const keywords[] = {"and", "begin", "case", "do", "else", "elsif", "ensure", "if", "in", "not", "or", "rescue", "return", "then", "unless", "until", "when", "while", "yield"};
+    for (size_t i = 0; i < sizeof(keywords) / sizeof(keywords[0]); ++i)
+    {
+        if (strlen(keywords[i]) == len && memcmp(word, keywords[i], len) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Check whether an identifier is a reserved word.
+ */
+static bool leuko_lex_reserved(const uint8_t *word, size_t len)
+{
+    static const char *const reserved[] = {"__ENCODING__", "__FILE__", "__LINE__", "BEGIN", "END", "alias", "and", "begin", "break", "case", "class", "def", "defined?", "do", "else", "elsif", "end", "ensure", "false", "for", "if", "in", "module", "next", "nil", "not", "or", "redo", "rescue", "retry", "return", "self", "super", "then", "true", "undef", "unless", "until", "when", "while", "yield"};
+    for (size_t i = 0; i < sizeof(reserved) / sizeof(reserved[0]); ++i)
+    {
+        if (strlen(reserved[i]) == len && memcmp(word, reserved[i], len) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Lex one token of code.
+ */
+static void leuko_lex_code(leuko_lex_t *lx, leuko_lex_frame_t *top)
+{
+    const uint8_t *s = lx->s;
+    uint8_t c = s[lx->pos];
+    uint8_t next = lx->pos + 1 < lx->len ? s[lx->pos + 1] : 0;
+    if (c == ' ' || c == '\t' || c == '\r')
+    {
+        lx->pos++;
+        return;
+    }
+    bool def = lx->def;
+    bool klass = lx->klass;
+    lx->def = false;
+    lx->klass = false;
+    if (c == '\n')
+    {
+        leuko_lex_emit(lx, LEUKO_TOKEN_NEWLINE, lx->pos, lx->pos + 1);
+        leuko_lex_newline(lx, false);
+        lx->value = false;
+        lx->ident = false;
+    }
+    else if (def && c && strchr("/%<>=!~+-*&|^[`", c))
+    {
+        /* operator method name (`def /(other)`, `def <=>(other)`) */
+        size_t start = lx->pos;
+        while (lx->pos < lx->len && strchr("/%<>=!~+-*&|^[]`@", s[lx->pos]) && s[lx->pos] != '\0')
+        {
+            lx->pos++;
+        }
+        leuko_lex_emit(lx, LEUKO_TOKEN_IDENTIFIER, start, lx->pos);
+        lx->value = true;
+        lx->ident = false;
+    }
+    else if (c == '\\' && next == '\n')
+    {
+        lx->pos++;
+        leuko_lex_newline(lx, false);
+    }
+    else if (c == '#')
+    {
+        size_t start = lx->pos;
+        const uint8_t *nl = memchr(s + lx->pos, '\n', lx->len - lx->pos);
+        lx->pos = nl ? (size_t)(nl - s) : lx->len;
+        leuko_lex_emit(lx, LEUKO_TOKEN_COMMENT, start, lx->pos);
+    }
+    else if (c == '\'' || c == '"' || c == '`')
+    {
+        leuko_lex_emit(lx, LEUKO_TOKEN_STRING_BEGIN, lx->pos, lx->pos + 1);
+        lx->pos++;
+        if (!leuko_lex_push_literal(lx, c, c != '\'', false))
+        {
+            lx->pos = lx->len + 1;
+        }
+    }
+    else if (c == ':' && (next == '"' || next == '\''))
+    {
+        leuko_lex_emit(lx, LEUKO_TOKEN_STRING_BEGIN, lx->pos, lx->pos + 2);
+        lx->pos += 2;
+        if (!leuko_lex_push_literal(lx, next, next == '"', false))
+        {
+            lx->pos = lx->len + 1;
+        }
+    }
+    else if (c == ':' && next != ':' && next && strchr("/%<>=!~+-*&|^[`", next))
+    {
+        /* operator symbol (`:/`, `:<=>`, `:[]=`) */
+        size_t start = lx->pos++;
+        while (lx->pos < lx->len && strchr("/%<>=!~+-*&|^[]`", s[lx->pos]) && s[lx->pos] != '\0')
+        {
+            lx->pos++;
+        }
+        leuko_lex_emit(lx, LEUKO_TOKEN_SYMBOL, start, lx->pos);
+        lx->value = true;
+        lx->ident = false;
+    }
+    else if (c == '$' && next && !leuko_lex_ident_char(next) && next != '\n')
+    {
+        /* special global (`$'`, `$"`, `$/`) */
+        leuko_lex_emit(lx, LEUKO_TOKEN_IDENTIFIER, lx->pos, lx->pos + 2);
+        lx->pos += 2;
+        lx->value = true;
+        lx->ident = false;
+    }
+    else if (c == '?' && next && !leuko_lex_blank(next) && next != '\n' && next != '\r' && leuko_lex_argument(lx, lx->pos + 1) &&
+             (next == '\\' || lx->pos + 2 >= lx->len || !leuko_lex_ident_char(s[lx->pos + 2])))
+    {
+        /* character literal (`?a`, `?\n`) */
+        size_t start = lx->pos;
+        lx->pos += next == '\\' ? 3 : 2;
+        while (lx->pos < lx->len && (s[lx->pos] & 0xC0) == 0x80)
+        {
+            lx->pos++;
+        }
+        leuko_lex_emit(lx, LEUKO_TOKEN_CHARACTER, start, lx->pos < lx->len ? lx->pos : lx->len);
+        lx->value = true;
+        lx->ident = false;
+    }
+    else if (c == '%' && leuko_lex_percent_open(lx))
+    {
+        return;
+    }
+    else if (c == '/' && leuko_lex_argument(lx, lx->pos + 1) && (!lx->value || leuko_lex_closes_on_line(lx, '/')))
+    {
+        leuko_lex_emit(lx, LEUKO_TOKEN_STRING_BEGIN, lx->pos, lx->pos + 1);
+        lx->pos++;
+        if (!leuko_lex_push_literal(lx, '/', true, true))
+        {
+            lx->pos = lx->len + 1;
+        }
+    }
+    else if (c == '<' && next == '<' && !klass && leuko_lex_heredoc_open(lx))
+    {
+        return;
+    }
+    else if ((c == '@' || c == '$') && (leuko_lex_ident_char(next) || (c == '@' && next == '@')))
+    {
+        /* instance, class or global variable: a value, never a method call */
+        size_t start = lx->pos;
+        lx->pos += c == '@' && next == '@' ? 2 : 1;
+        while (lx->pos < lx->len && leuko_lex_ident_char(s[lx->pos]))
+        {
+            lx->pos++;
+        }
+        leuko_lex_emit(lx, LEUKO_TOKEN_IDENTIFIER, start, lx->pos);
+        lx->value = true;
+        lx->ident = false;
+    }
+    else if (leuko_lex_ident_char(c) && !(c >= '0' && c <= '9'))
+    {
+        size_t start = lx->pos;
+        while (lx->pos < lx->len && leuko_lex_ident_char(s[lx->pos]))
+        {
+            lx->pos++;
+        }
+        if (lx->pos < lx->len && (s[lx->pos] == '?' || s[lx->pos] == '!') && (lx->pos + 1 >= lx->len || s[lx->pos + 1] != '='))
+        {
+            lx->pos++;
+        }
+        bool label = lx->pos + 1 < lx->len && s[lx->pos] == ':' && s[lx->pos + 1] != ':';
+        bool keyword = label || leuko_lex_keyword(s + start, lx->pos - start);
+        lx->def = lx->pos - start == 3 && memcmp(s + start, "def", 3) == 0;
+        lx->klass = lx->pos - start == 5 && memcmp(s + start, "class", 5) == 0;
+        lx->pos += label;
+        leuko_lex_emit(lx, label ? LEUKO_TOKEN_LABEL : leuko_lex_reserved(s + start, lx->pos - start) ? LEUKO_TOKEN_KEYWORD : LEUKO_TOKEN_IDENTIFIER, start, lx->pos);
+        lx->value = !keyword;
+        lx->ident = !keyword;
+    }
+    else if (c >= '0' && c <= '9')
+    {
+        size_t start = lx->pos;
+        while (lx->pos < lx->len && (leuko_lex_ident_char(s[lx->pos]) || (s[lx->pos] == '.' && lx->pos + 1 < lx->len && s[lx->pos + 1] >= '0' && s[lx->pos + 1] <= '9')))
+        {
+            lx->pos++;
+        }
+        leuko_lex_emit(lx, LEUKO_TOKEN_NUMBER, start, lx->pos);
+        lx->value = true;
+        lx->ident = false;
+    }
+    else if (c == '}' && top && top->nest == 0)
+    {
+        /* end of an interpolation: back in the literal */
+        leuko_lex_emit(lx, LEUKO_TOKEN_EMBEXPR_END, lx->pos, lx->pos + 1);
+        lx->pos++;
+        lx->depth--;
+    }
+    else
+    {
+        if (top && c == '{')
+        {
+            top->nest++;
+        }
+        else if (top && c == '}')
+        {
+            top->nest--;
+        }
+        size_t start = lx->pos++;
+        bool punctuation = c && strchr(",;()[]{}", c);
+        if (c == ':' && next == ':')
+        {
+            lx->pos++;
+        }
+        while (!punctuation && lx->pos < lx->len && s[lx->pos] && strchr(LEUKO_LEX_OPERATOR_CHARS, s[lx->pos]) &&
+               strchr(LEUKO_LEX_OPERATOR_CHARS, c) && !(s[lx->pos] == '<' && lx->pos + 1 < lx->len && s[lx->pos + 1] == '<'))
+        {
+            lx->pos++;
+        }
+        leuko_lex_emit(lx, punctuation ? LEUKO_TOKEN_PUNCTUATION : LEUKO_TOKEN_OPERATOR, start, lx->pos);
+        lx->value = c == ')' || c == ']' || c == '}';
+        lx->ident = false;
+    }
+}
+
+/**
+ * @brief Lex Ruby source into tokens and per-line flags.
+ * @param source Source bytes
+ * @param len Number of bytes
+ * @param line_count Number of lines (one per newline plus one)
+ * @param flags Output: LEUKO_LINE_* bits per line, zeroed first (may be NULL)
+ * @param on_token Called for every token in source order (may be NULL)
+ * @param data Passed to on_token
+ * @return true on success, false if the source nests too deeply to follow
+ *         (flags are all zero and the tokens stop short)
+ * @note A lexer, not a parser: it tracks just enough of Ruby (quotes,
+ *       percent literals, regexps, heredocs, interpolation, comments) to
+ *       know where literal bodies are. Where Ruby itself needs the parse to
+ *       tell a literal from an operator (`/`, `%`, `<<`, `?`), it guesses
+ *       from the previous token the way Ruby's lexer does.
+ */
+bool leuko_lex(const uint8_t *source, size_t len, size_t line_count, uint8_t *flags, leuko_token_fn on_token, void *data)
+{
+    if (flags)
+    {
+        memset(flags, 0, line_count);
+    }
+    leuko_lex_t lx = {.s = source, .len = len, .line_count = line_count, .flags = flags, .on_token = on_token, .data = data};
+    while (lx.pos < lx.len)
+    {
+        leuko_lex_frame_t *top = lx.depth ? &lx.stack[lx.depth - 1] : NULL;
+        if (!top && (lx.pos == 0 || source[lx.pos - 1] == '\n'))
+        {
+            if (leuko_lex_line_start(&lx))
+            {
+                break;
+            }
+            if (lx.pos >= lx.len)
+            {
+                break;
+            }
+        }
+        if (top && top->literal)
+        {
+            leuko_lex_literal(&lx, top);
+        }
+        else
+        {
+            leuko_lex_code(&lx, top);
+        }
+    }
+    if (lx.pos > lx.len)
+    {
+        if (flags)
+        {
+            memset(flags, 0, line_count);
+        }
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Find the lines that continue a literal, heredoc bodies and `__END__` data.
+ * @param source Source bytes
+ * @param len Number of bytes
+ * @param line_count Number of lines (one per newline plus one)
+ * @param flags Output: LEUKO_LINE_* bits per line (zeroed first)
+ * @return true on success, false if the source nests too deeply to follow (flags are all zero)
+ */
+bool leuko_lex_line_flags(const uint8_t *source, size_t len, size_t line_count, uint8_t *flags)
+{
+    return leuko_lex(source, len, line_count, flags, NULL, NULL);
+}
@@ -0,0 +1,318 @@
+#include <stdlib.h>
+#include <string.h>
+#include "sources/processed_source.h"
+#include "sources/lexer.h"
+
+/**
+ * @brief Number of slots in the offset -> line lookup cache.
+ * @note Must be a power of two.
+ */
+#define LEUKO_OFFSET2LINE_CACHE_SIZE 256
+
+/**
+ * @brief Compute the offset of the first non-whitespace byte of each line.
+ * @param ps Pointer to the processed source
+ * @note Blank lines map to the offset of their line terminator.
+ */
+static void leuko_processed_source_compute_first_non_ws(leuko_processed_source_t *ps)
+{
+    size_t source_len = (size_t)(ps->source_end - ps->source_start);
+    for (size_t i = 0; i < ps->line_count; ++i)
+    {
+        size_t off = ps->line_start_offsets[i];
+        size_t end = (i + 1 < ps->line_count) ? ps->line_start_offsets[i + 1] : source_len;
+        while (off < end && (ps->source_start[off] == ' ' || ps->source_start[off] == '\t'))
+        {
+            ++off;
+        }
+        ps->line_first_non_ws_offsets[i] = off;
+    }
+}
+
+/**
+ * @brief Allocate the per-line tables and the lookup cache.
+ * @param ps Pointer to the processed source (source range and line_count set)
+ * @param line_starts Line start offsets to copy, or NULL to scan the source for newlines
+ */
+static void leuko_processed_source_setup(leuko_processed_source_t *ps, const size_t *line_starts)
+{
+    if (ps->line_count > 0)
+    {
+        ps->line_start_offsets = malloc(ps->line_count * sizeof(size_t));
+        ps->line_first_non_ws_offsets = malloc(ps->line_count * sizeof(size_t));
+        if (!ps->line_start_offsets || !ps->line_first_non_ws_offsets)
+        {
+            free(ps->line_start_offsets);
+            free(ps->line_first_non_ws_offsets);
+            ps->line_start_offsets = NULL;
+            ps->line_first_non_ws_offsets = NULL;
+            ps->line_count = 0;
+            return;
+        }
+        if (line_starts)
+        {
+            memcpy(ps->line_start_offsets, line_starts, ps->line_count * sizeof(size_t));
+        }
+        else
+        {
+            size_t n = 0;
+            const uint8_t *p = ps->source_start;
+            ps->line_start_offsets[n++] = 0;
+            while (n < ps->line_count && (p = memchr(p, '\n', (size_t)(ps->source_end - p))) != NULL)
+            {
+                ps->line_start_offsets[n++] = (size_t)(++p - ps->source_start);
+            }
+        }
+        leuko_processed_source_compute_first_non_ws(ps);
+    }
+
+    ps->offset2line_cap = LEUKO_OFFSET2LINE_CACHE_SIZE;
+    ps->offset2line_keys = malloc(ps->offset2line_cap * sizeof(size_t));
+    ps->offset2line_vals = malloc(ps->offset2line_cap * sizeof(size_t));
+    if (!ps->offset2line_keys || !ps->offset2line_vals)
+    {
+        free(ps->offset2line_keys);
+        free(ps->offset2line_vals);
+        ps->offset2line_keys = NULL;
+        ps->offset2line_vals = NULL;
+        ps->offset2line_cap = 0;
+        return;
+    }
+    /* SIZE_MAX marks an empty slot */
+    memset(ps->offset2line_keys, 0xff, ps->offset2line_cap * sizeof(size_t));
+}
+
+/**
+ * @brief Initialize a processed source from a parsed Prism parser.
+ * @param ps Pointer to the processed source to initialize
+ * @param parser Pointer to the parser (must outlive the processed source)
+ */
+void leuko_processed_source_init_from_parser(leuko_processed_source_t *ps, const pm_parser_t *parser)
+{
+    memset(ps, 0, sizeof(*ps));
+    if (!parser)
+    {
+        return;
+    }
+    ps->newline_list = &parser->newline_list;
+    ps->source_start = parser->start;
+    ps->source_end = parser->end;
+    ps->start_line_number = parser->start_line;
+    ps->line_count = parser->newline_list.size;
+    leuko_processed_source_setup(ps, parser->newline_list.offsets);
+}
+
+/**
+ * @brief Initialize a processed source from raw bytes, without parsing.
+ * @param ps Pointer to the processed source to initialize
+ * @param source Source bytes (must outlive the processed source)
+ * @param source_len Number of bytes
+ * @param start_line_number Number of the first line
+ * @note Produces the same line table as the parser would (one line per
+ *       newline plus one); `newline_list` is NULL.
+ */
+void leuko_processed_source_init_from_source(leuko_processed_source_t *ps, const uint8_t *source, size_t source_len, int32_t start_line_number)
+{
+    memset(ps, 0, sizeof(*ps));
+    ps->source_start = source;
+    ps->source_end = source + source_len;
+    ps->start_line_number = start_line_number;
+    ps->line_count = 1;
+    for (const uint8_t *p = source; (p = memchr(p, '\n', (size_t)(ps->source_end - p))) != NULL; ++p)
+    {
+        ps->line_count++;
+    }
+    leuko_processed_source_setup(ps, NULL);
+}
+
+/**
+ * @brief Find the 0-based line index containing an offset.
+ * @param ps Pointer to the processed source
+ * @param offset Byte offset from the start of the source
+ * @return Line index
+ * @note Checks the last looked-up line first (rules mostly walk forward),
+ *       then a small direct-mapped cache, then falls back to binary search.
+ */
+static size_t leuko_processed_source_line_index(const leuko_processed_source_t *ps, size_t offset)
+{
+    if (ps->line_count == 0)
+    {
+        return 0;
+    }
+
+    /* Fast path: same or next line as the previous lookup */
+    leuko_processed_source_t *mut = (leuko_processed_source_t *)ps;
+    size_t hint = ps->last_line_index;
+    if (hint < ps->line_count && ps->line_start_offsets[hint] <= offset)
+    {
+        if (hint + 1 >= ps->line_count || offset < ps->line_start_offsets[hint + 1])
+        {
+            return hint;
+        }
+        if (hint + 2 >= ps->line_count || offset < ps->line_start_offsets[hint + 2])
+        {
+            mut->last_line_index = hint + 1;
+            return hint + 1;
+        }
+    }
+
+    size_t slot = offset & (ps->offset2line_cap - 1);
+    if (ps->offset2line_cap && ps->offset2line_keys[slot] == offset)
+    {
+        mut->last_line_index = ps->offset2line_vals[slot];
+        return ps->offset2line_vals[slot];
+    }
+
+    size_t lo = 0;
+    size_t hi = ps->line_count;
+    while (hi - lo > 1)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (ps->line_start_offsets[mid] <= offset)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    if (ps->offset2line_cap)
+    {
+        if (ps->offset2line_keys[slot] == (size_t)-1)
+        {
+            mut->offset2line_count++;
+        }
+        ps->offset2line_keys[slot] = offset;
+        ps->offset2line_vals[slot] = lo;
+    }
+    mut->last_line_index = lo;
+    return lo;
+}
+
+/**
+ * @brief Get the 1-based line number of a position.
+ * @param ps Pointer to the processed source
+ * @param pos Pointer into the source
+ * @return Line number
+ */
+int32_t leuko_processed_source_line_of_pos(const leuko_processed_source_t *ps, const uint8_t *pos)
+{
+    size_t idx = leuko_processed_source_line_index(ps, leuko_pos_to_offset(ps, pos));
+    return ps->start_line_number + (int32_t)idx;
+}
+
+/**
+ * @brief Count characters (UTF-8 code points) in a byte range.
+ * @param start Start of the range
+ * @param end End of the range (exclusive)
+ * @return Number of characters
+ * @note RuboCop reports columns in characters, not bytes.
+ */
+static size_t leuko_utf8_char_count(const uint8_t *start, const uint8_t *end)
+{
+    size_t n = 0;
+    for (const uint8_t *p = start; p < end; ++p)
+    {
+        if ((*p & 0xC0) != 0x80)
+        {
+            ++n;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief Get the 0-based column of a position.
+ * @param ps Pointer to the processed source
+ * @param pos Pointer into the source
+ * @return Column in characters
+ */
+size_t leuko_processed_source_col_of_pos(const leuko_processed_source_t *ps, const uint8_t *pos)
+{
+    if (ps->line_count == 0)
+    {
+        return leuko_utf8_char_count(ps->source_start, pos);
+    }
+    size_t idx = leuko_processed_source_line_index(ps, leuko_pos_to_offset(ps, pos));
+    return leuko_utf8_char_count(ps->source_start + ps->line_start_offsets[idx], pos);
+}
+
+/**
+ * @brief Check whether only whitespace precedes a position on its line.
+ * @param ps Pointer to the processed source
+ * @param pos Pointer into the source
+ * @return true if pos is the first non-whitespace character of its line
+ */
+bool leuko_processed_source_begins_its_line(const leuko_processed_source_t *ps, const uint8_t *pos)
+{
+    if (ps->line_count == 0)
+    {
+        return false;
+    }
+    size_t offset = leuko_pos_to_offset(ps, pos);
+    size_t idx = leuko_processed_source_line_index(ps, offset);
+    return ps->line_first_non_ws_offsets[idx] == offset;
+}
+
+/**
+ * @brief Resolve line, column and indentation of a position in one lookup.
+ * @param ps Pointer to the processed source
+ * @param pos Pointer into the source
+ * @param out Output position information
+ */
+void leuko_processed_source_pos_info(leuko_processed_source_t *ps, const uint8_t *pos, leuko_processed_source_pos_info_t *out)
+{
+    if (ps->line_count == 0)
+    {
+        out->line_number = ps->start_line_number;
+        out->column = leuko_utf8_char_count(ps->source_start, pos);
+        out->indentation_column = 0;
+        return;
+    }
+    size_t idx = leuko_processed_source_line_index(ps, leuko_pos_to_offset(ps, pos));
+    const uint8_t *line_start = ps->source_start + ps->line_start_offsets[idx];
+    out->line_number = ps->start_line_number + (int32_t)idx;
+    out->column = leuko_utf8_char_count(line_start, pos);
+    /* indentation is spaces/tabs only, so bytes == characters */
+    out->indentation_column = ps->line_first_non_ws_offsets[idx] - ps->line_start_offsets[idx];
+}
+
+/**
+ * @brief Get the lexer's facts about every line (literal bodies, heredocs, `__END__` data).
+ * @param ps Pointer to the processed source
+ * @return LEUKO_LINE_* bits per line, or NULL on allocation failure
+ * @note Lexed on first use: rules only ask when a line has an offense, so
+ *       clean files never pay for it. Works without a parse.
+ */
+const uint8_t *leuko_processed_source_line_flags(leuko_processed_source_t *ps)
+{
+    if (!ps->line_flags && ps->line_count > 0)
+    {
+        ps->line_flags = malloc(ps->line_count);
+        if (ps->line_flags)
+        {
+            leuko_lex_line_flags(ps->source_start, (size_t)(ps->source_end - ps->source_start), ps->line_count, ps->line_flags);
+        }
+    }
+    return ps->line_flags;
+}
+
+/**
+ * @brief Free memory owned by a processed source.
+ * @param ps Pointer to the processed source
+ */
+void leuko_processed_source_free(leuko_processed_source_t *ps)
+{
+    if (!ps)
+    {
+        return;
+    }
+    free(ps->line_first_non_ws_offsets);
+    free(ps->line_start_offsets);
+    free(ps->offset2line_keys);
+    free(ps->offset2line_vals);
+    free(ps->line_flags);
+    memset(ps, 0, sizeof(*ps));
+}
@@ -0,0 +1,132 @@
+#define _GNU_SOURCE
+#include <string.h>
+#include "sources/signature.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Whether a byte can start a heredoc identifier after `<<`.
+ */
+static inline int leuko_signature_heredoc_start(uint8_t c)
+{
+    return c == '~' || c == '-' || c == '_' || c == '"' || c == '\'' || c == '`' || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+/**
+ * @brief Features of the byte pair at `i` and `i + 1`.
+ * @param s Source bytes
+ * @param len Number of bytes
+ * @param i Index of the first byte (`i + 1 < len`)
+ * @return LEUKO_FEATURE_* bits the pair shows
+ */
+static inline uint32_t leuko_signature_pair(const uint8_t *s, size_t len, size_t i)
+{
+    uint8_t a = s[i];
+    uint8_t b = s[i + 1];
+    uint32_t found = 0;
+    if (a == '\n' && (b == ' ' || b == '\t'))
+    {
+        found |= LEUKO_FEATURE_INDENTED_LINE;
+    }
+    if ((a == ' ' || a == '\t') && (b == '\n' || b == '\r'))
+    {
+        found |= LEUKO_FEATURE_TRAILING_SPACE;
+    }
+    if (a == '\t')
+    {
+        found |= LEUKO_FEATURE_TAB;
+    }
+    if (a == '\r')
+    {
+        found |= LEUKO_FEATURE_CR;
+    }
+    if (a == '<' && b == '<' && i + 2 < len && leuko_signature_heredoc_start(s[i + 2]))
+    {
+        found |= LEUKO_FEATURE_HEREDOC;
+    }
+    return found;
+}
+
+/**
+ * @brief Compute the features of a source that a set of rules asks about.
+ * @param source Source bytes
+ * @param len Number of bytes
+ * @param wanted LEUKO_FEATURE_* bits to look for
+ * @return The wanted features that are present
+ * @note One pass over the bytes for every character-pair feature, stopping
+ *       as soon as all wanted features are found; with SSE2, 16 pairs are
+ *       tested per step and only blocks with a hit are looked at byte by
+ *       byte. Words (`rescue`) are found with memmem.
+ */
+uint32_t leuko_signature_scan(const uint8_t *source, size_t len, uint32_t wanted)
+{
+    uint32_t found = 0;
+    if (wanted & LEUKO_FEATURE_RESCUE)
+    {
+        if (len >= 6 && memmem(source, len, "rescue", 6))
+        {
+            found |= LEUKO_FEATURE_RESCUE;
+        }
+        wanted &= ~LEUKO_FEATURE_RESCUE;
+    }
+    if (!wanted || len == 0)
+    {
+        return found;
+    }
+
+    /* the first line and the last byte have no neighbour on one side */
+    uint32_t edges = 0;
+    if (source[0] == ' ' || source[0] == '\t')
+    {
+        edges |= LEUKO_FEATURE_INDENTED_LINE;
+    }
+    uint8_t last = source[len - 1];
+    if (last == ' ' || last == '\t')
+    {
+        edges |= LEUKO_FEATURE_TRAILING_SPACE;
+    }
+    if (last == '\t')
+    {
+        edges |= LEUKO_FEATURE_TAB;
+    }
+    if (last == '\r')
+    {
+        edges |= LEUKO_FEATURE_CR;
+    }
+    uint32_t pairs = edges & wanted;
+
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i nl = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i sp = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i lt = _mm_set1_epi8('<');
+    for (; i + 17 <= len && pairs != wanted; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(source + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(source + i + 1));
+        __m128i a_tab = _mm_cmpeq_epi8(a, tab);
+        __m128i a_ws = _mm_or_si128(_mm_cmpeq_epi8(a, sp), a_tab);
+        __m128i b_ws = _mm_or_si128(_mm_cmpeq_epi8(b, sp), _mm_cmpeq_epi8(b, tab));
+        __m128i a_cr = _mm_cmpeq_epi8(a, cr);
+        __m128i b_eol = _mm_or_si128(_mm_cmpeq_epi8(b, nl), _mm_cmpeq_epi8(b, cr));
+        __m128i hit = _mm_or_si128(_mm_and_si128(_mm_cmpeq_epi8(a, nl), b_ws), _mm_and_si128(a_ws, b_eol));
+        hit = _mm_or_si128(hit, _mm_or_si128(a_tab, a_cr));
+        hit = _mm_or_si128(hit, _mm_and_si128(_mm_cmpeq_epi8(a, lt), _mm_cmpeq_epi8(b, lt)));
+        unsigned mask = (unsigned)_mm_movemask_epi8(hit);
+        while (mask)
+        {
+            pairs |= leuko_signature_pair(source, len, i + (size_t)__builtin_ctz(mask)) & wanted;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i + 1 < len && pairs != wanted; ++i)
+    {
+        pairs |= leuko_signature_pair(source, len, i) & wanted;
+    }
+    return found | pairs;
+}
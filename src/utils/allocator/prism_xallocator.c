@@ -14,6 +14,7 @@
  *   (<= LEUKO_ARENA_SMALL_LIMIT); larger allocations fall back to malloc.
  * - Arena chunks default to LEUKO_ARENA_CHUNK_DEFAULT and are created lazily.
  * - Arena lifecycle: leuko_x_allocator_begin() / leuko_x_allocator_end().
+ * - Per-thread counters (leuko_x_allocator_stats()) are reset by begin.
  * - Internal helpers and symbols are prefixed with `leuko_`.
  */
 
@@ -39,6 +40,11 @@
  */
 static __thread struct leuko_arena *leuko_arena_head = NULL;
 
+/**
+ * @brief Thread-local allocation counters (plain increments: never shared).
+ */
+static __thread leuko_x_allocator_stats_t leuko_x_stats;
+
 /**
  * @brief Header used to mark arena allocations.
  */
@@ -58,6 +64,7 @@ void leuko_x_allocator_begin(void)
         leuko_arena_free(leuko_arena_head);
         leuko_arena_head = NULL;
     }
+    memset(&leuko_x_stats, 0, sizeof(leuko_x_stats));
 }
 
 /**
@@ -72,6 +79,26 @@ void leuko_x_allocator_end(void)
     }
 }
 
+/**
+ * @brief Read the counters of the current thread.
+ * @param out Allocations since the last leuko_x_allocator_begin()
+ * @note Still valid after leuko_x_allocator_end().
+ */
+void leuko_x_allocator_stats(leuko_x_allocator_stats_t *out)
+{
+    *out = leuko_x_stats;
+}
+
+/**
+ * @brief Count an allocation served by the system allocator.
+ * @param size Size requested
+ */
+static void leuko_x_count_fallback(size_t size)
+{
+    leuko_x_stats.fallback_allocs++;
+    leuko_x_stats.fallback_bytes += size;
+}
+
 /**
  * @brief Helper to align sizes to pointer width.
  * @param v Size to align
@@ -104,11 +131,16 @@ static void *leuko_arena_alloc_wrapper(size_t size)
 
     size_t small_limit = LEUKO_ARENA_SMALL_LIMIT;
     if (size > small_limit)
+    {
+        leuko_x_count_fallback(size);
         return malloc(size);
+    }
 
     void *p = leuko_arena_alloc(leuko_arena_head, total);
     if (!p)
         return NULL;
+    leuko_x_stats.arena_allocs++;
+    leuko_x_stats.arena_bytes += total;
 
     leuko_arena_block_hdr_t *h = (leuko_arena_block_hdr_t *)p;
     h->magic = LEUKO_ARENA_BLOCK_MAGIC;
@@ -151,6 +183,7 @@ void *prism_alloc_impl(size_t size)
     void *p = leuko_arena_alloc_wrapper(size);
     if (p)
         return p;
+    leuko_x_count_fallback(size);
     return malloc(size);
 }
 
@@ -169,6 +202,7 @@ void *prism_calloc_impl(size_t nmemb, size_t size)
         memset(p, 0, total);
         return p;
     }
+    leuko_x_count_fallback(total);
     return calloc(nmemb, size);
 }
 
@@ -195,6 +229,7 @@ void *prism_realloc_impl(void *ptr, size_t size)
         memcpy(n, ptr, to_copy);
         return n;
     }
+    leuko_x_count_fallback(size);
     return realloc(ptr, size);
 }
 
@@ -0,0 +1,271 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "utils/file.h"
+#include "utils/string_array.h"
+
+#ifndef PATH_MAX
+#define PATH_MAX 4096
+#endif
+
+/**
+ * @brief Read a whole file into a malloc'd buffer.
+ * @param path File path
+ * @param out Output: buffer (NUL-terminated, caller frees)
+ * @param out_len Output: number of bytes read (excluding the terminator)
+ * @return true on success, false on failure
+ */
+bool leuko_file_read_all(const char *path, uint8_t **out, size_t *out_len)
+{
+    *out = NULL;
+    *out_len = 0;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        close(fd);
+        return false;
+    }
+    size_t cap = (size_t)st.st_size;
+    uint8_t *buf = malloc(cap + 1);
+    if (!buf)
+    {
+        close(fd);
+        return false;
+    }
+    size_t len = 0;
+    while (len < cap)
+    {
+        ssize_t n = read(fd, buf + len, cap - len);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            free(buf);
+            close(fd);
+            return false;
+        }
+        if (n == 0)
+        {
+            break;
+        }
+        len += (size_t)n;
+    }
+    close(fd);
+    buf[len] = '\0';
+    *out = buf;
+    *out_len = len;
+    return true;
+}
+
+/**
+ * @brief Write bytes to a new temporary file next to a path.
+ * @param path Final path (the temporary file is created in its directory)
+ * @param data Bytes to write
+ * @param len Number of bytes
+ * @param mode Permission bits of the temporary file
+ * @param tmp_path Output: path of the temporary file (caller frees)
+ * @return Descriptor of the temporary file (still open), or -1 on failure
+ * @note The file is created next to `path` so it can be renamed over it.
+ */
+int leuko_file_write_temp(const char *path, const uint8_t *data, size_t len, mode_t mode, char **tmp_path)
+{
+    *tmp_path = NULL;
+    size_t path_len = strlen(path);
+    char *tmp = malloc(path_len + sizeof(".leuko-XXXXXX"));
+    if (!tmp)
+    {
+        return -1;
+    }
+    memcpy(tmp, path, path_len);
+    memcpy(tmp + path_len, ".leuko-XXXXXX", sizeof(".leuko-XXXXXX"));
+    int fd = mkstemp(tmp);
+    if (fd < 0)
+    {
+        free(tmp);
+        return -1;
+    }
+    bool ok = fchmod(fd, mode) == 0;
+    while (ok && len > 0)
+    {
+        ssize_t n = write(fd, data, len);
+        if (n < 0)
+        {
+            ok = errno == EINTR;
+            continue;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    if (!ok)
+    {
+        close(fd);
+        unlink(tmp);
+        free(tmp);
+        return -1;
+    }
+    *tmp_path = tmp;
+    return fd;
+}
+
+/**
+ * @brief Flush the directory entry of a path to disk.
+ * @param path Path whose parent directory is synced
+ * @return true on success, false on failure
+ */
+bool leuko_file_sync_parent(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+    char dir[PATH_MAX];
+    if (!slash)
+    {
+        strcpy(dir, ".");
+    }
+    else
+    {
+        size_t n = slash == path ? 1 : (size_t)(slash - path);
+        if (n >= sizeof(dir))
+        {
+            return false;
+        }
+        memcpy(dir, path, n);
+        dir[n] = '\0';
+    }
+    int fd = open(dir, O_RDONLY | O_DIRECTORY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool ok = fsync(fd) == 0;
+    return close(fd) == 0 && ok;
+}
+
+/**
+ * @brief Replace a file atomically: write a temporary file, then rename it over the path.
+ * @param path File path
+ * @param data Bytes to write
+ * @param len Number of bytes
+ * @param mode Permission bits of the new file
+ * @return true on success, false on failure (the old file is left untouched)
+ * @note Readers see either the old or the new contents, never a partial
+ *       file. Nothing is synced to disk.
+ */
+bool leuko_file_write_atomic(const char *path, const uint8_t *data, size_t len, mode_t mode)
+{
+    char *tmp = NULL;
+    int fd = leuko_file_write_temp(path, data, len, mode, &tmp);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool ok = close(fd) == 0 && rename(tmp, path) == 0;
+    if (!ok)
+    {
+        unlink(tmp);
+    }
+    free(tmp);
+    return ok;
+}
+
+/**
+ * @brief Check whether a file name looks like a Ruby source file.
+ * @param name File name
+ * @return true if the name ends with `.rb`
+ */
+static bool leuko_file_is_ruby_name(const char *name)
+{
+    size_t len = strlen(name);
+    return len > 3 && strcmp(name + len - 3, ".rb") == 0;
+}
+
+/**
+ * @brief Recursively collect Ruby files under a directory.
+ * @param dir Directory path
+ * @param out Pointer to output array of paths
+ * @param out_count Pointer to count of output array
+ * @return true on success, false on allocation failure
+ * @note Hidden entries (starting with '.') are skipped.
+ */
+static bool leuko_file_collect_dir(const char *dir, char ***out, size_t *out_count)
+{
+    DIR *d = opendir(dir);
+    if (!d)
+    {
+        return true;
+    }
+    bool ok = true;
+    struct dirent *ent;
+    while (ok && (ent = readdir(d)) != NULL)
+    {
+        if (ent->d_name[0] == '.')
+        {
+            continue;
+        }
+        char path[PATH_MAX];
+        int n = snprintf(path, sizeof(path), "%s/%s", dir, ent->d_name);
+        if (n < 0 || (size_t)n >= sizeof(path))
+        {
+            continue;
+        }
+        struct stat st;
+        if (stat(path, &st) != 0)
+        {
+            continue;
+        }
+        if (S_ISDIR(st.st_mode))
+        {
+            ok = leuko_file_collect_dir(path, out, out_count);
+        }
+        else if (S_ISREG(st.st_mode) && leuko_file_is_ruby_name(ent->d_name))
+        {
+            ok = leuko_str_arr_push(out, out_count, path);
+        }
+    }
+    closedir(d);
+    return ok;
+}
+
+/**
+ * @brief Expand CLI paths into a list of Ruby files.
+ * @param paths Input paths (files or directories); NULL/0 means the current directory
+ * @param paths_count Number of input paths
+ * @param out Output: array of file paths (caller frees each entry and the array)
+ * @param out_count Output: number of file paths
+ * @return true on success, false on allocation failure
+ * @note Files given explicitly are kept regardless of their extension.
+ */
+bool leuko_file_collect_ruby(char *const *paths, size_t paths_count, char ***out, size_t *out_count)
+{
+    *out = NULL;
+    *out_count = 0;
+    if (paths_count == 0)
+    {
+        return leuko_file_collect_dir(".", out, out_count);
+    }
+    for (size_t i = 0; i < paths_count; ++i)
+    {
+        struct stat st;
+        if (stat(paths[i], &st) != 0)
+        {
+            fprintf(stderr, "%s: %s\n", paths[i], strerror(errno));
+            continue;
+        }
+        bool ok = S_ISDIR(st.st_mode) ? leuko_file_collect_dir(paths[i], out, out_count) : leuko_str_arr_push(out, out_count, paths[i]);
+        if (!ok)
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,387 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include "utils/git_diff.h"
+
+extern char **environ;
+
+/**
+ * @brief Check whether a line range shares a line with the set.
+ * @param set Line set
+ * @param first First line of the range
+ * @param last Last line of the range (inclusive)
+ * @return true if any line of the range is in the set
+ */
+bool leuko_line_set_intersects(const leuko_line_set_t *set, int32_t first, int32_t last)
+{
+    /* first range that does not end before `first` */
+    size_t lo = 0;
+    size_t hi = set->count;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (set->lasts[mid] < first)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo < set->count && set->firsts[lo] <= last;
+}
+
+/**
+ * @brief Append a line range, merging it with the previous one when they meet.
+ * @note Git lists hunks in line order, so ranges arrive sorted.
+ */
+static bool leuko_line_set_push(leuko_line_set_t *set, int32_t first, int32_t last)
+{
+    if (set->count > 0 && first <= set->lasts[set->count - 1] + 1)
+    {
+        if (last > set->lasts[set->count - 1])
+        {
+            set->lasts[set->count - 1] = last;
+        }
+        return true;
+    }
+    if (set->count == set->capacity)
+    {
+        size_t cap = set->capacity ? set->capacity * 2 : 8;
+        int32_t *firsts = realloc(set->firsts, cap * sizeof(int32_t));
+        if (!firsts)
+        {
+            return false;
+        }
+        set->firsts = firsts;
+        int32_t *lasts = realloc(set->lasts, cap * sizeof(int32_t));
+        if (!lasts)
+        {
+            return false;
+        }
+        set->lasts = lasts;
+        set->capacity = cap;
+    }
+    set->firsts[set->count] = first;
+    set->lasts[set->count] = last;
+    set->count++;
+    return true;
+}
+
+/**
+ * @brief Decode a path as git prints it: plain, or C-quoted when it has special characters.
+ * @param s Start of the path
+ * @param n Length up to the end of the line
+ * @return malloc'd path, or NULL on allocation failure
+ */
+static char *leuko_git_unquote(const char *s, size_t n)
+{
+    char *out = malloc(n + 1);
+    if (!out)
+    {
+        return NULL;
+    }
+    if (n < 2 || s[0] != '"')
+    {
+        memcpy(out, s, n);
+        out[n] = '\0';
+        return out;
+    }
+    size_t len = 0;
+    for (size_t i = 1; i < n && s[i] != '"'; ++i)
+    {
+        char c = s[i];
+        if (c == '\\' && i + 1 < n)
+        {
+            c = s[++i];
+            if (c >= '0' && c <= '7')
+            {
+                int value = 0;
+                for (int digits = 0; digits < 3 && i < n && s[i] >= '0' && s[i] <= '7'; ++digits, ++i)
+                {
+                    value = value * 8 + (s[i] - '0');
+                }
+                --i;
+                c = (char)value;
+            }
+            else
+            {
+                const char *escapes = "a\ab\bt\tn\nv\vf\fr\r";
+                const char *e = strchr(escapes, c);
+                c = e && (e - escapes) % 2 == 0 ? e[1] : c;
+            }
+        }
+        out[len++] = c;
+    }
+    out[len] = '\0';
+    return out;
+}
+
+/**
+ * @brief Parse the count of a hunk header range (`start[,count]`).
+ * @param p Position after the sign
+ * @param start Output: first line
+ * @param count Output: number of lines (1 when omitted)
+ * @return Position after the range
+ */
+static const char *leuko_git_parse_range(const char *p, long *start, long *count)
+{
+    char *end = NULL;
+    *start = strtol(p, &end, 10);
+    *count = 1;
+    if (*end == ',')
+    {
+        *count = strtol(end + 1, &end, 10);
+    }
+    return end;
+}
+
+/**
+ * @brief Read the output of `git diff --unified=0` into changed files and lines.
+ * @param diff Diff text
+ * @param len Length of the diff text
+ * @param out Output: files in diff order with their paths as printed (caller frees)
+ * @return true on success, false on allocation failure
+ * @note Only the `+++` file headers and the `@@` hunk headers are read; hunk
+ *       bodies are skipped by their line counts so a body line that looks
+ *       like a header is not mistaken for one. Deleted files are left out,
+ *       and so are pure deletions: they touch no line of the new version.
+ *       The TAB git appends to the header of a path with a space is dropped.
+ */
+bool leuko_git_changes_parse(const char *diff, size_t len, leuko_git_changes_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    leuko_git_changed_file_t *file = NULL;
+    long old_left = 0;
+    long new_left = 0;
+    const char *end = diff + len;
+    for (const char *line = diff; line < end;)
+    {
+        const char *nl = memchr(line, '\n', (size_t)(end - line));
+        const char *stop = nl ? nl : end;
+        size_t n = (size_t)(stop - line);
+        if (old_left > 0 || new_left > 0)
+        {
+            if (line[0] == '-')
+            {
+                old_left--;
+            }
+            else if (line[0] == '+')
+            {
+                new_left--;
+            }
+        }
+        else if (n > 4 && memcmp(line, "+++ ", 4) == 0)
+        {
+            file = NULL;
+            /* git ends the header with a TAB when the path has a space (and a CR may be left over) */
+            size_t path_len = n - 4;
+            while (path_len > 0 && (line[4 + path_len - 1] == '\t' || line[4 + path_len - 1] == '\r'))
+            {
+                path_len--;
+            }
+            char *path = leuko_git_unquote(line + 4, path_len);
+            if (!path)
+            {
+                leuko_git_changes_free(out);
+                return false;
+            }
+            if (strcmp(path, "/dev/null") == 0)
+            {
+                free(path);
+            }
+            else
+            {
+                if (strncmp(path, "b/", 2) == 0)
+                {
+                    memmove(path, path + 2, strlen(path + 2) + 1);
+                }
+                if (out->count == out->capacity)
+                {
+                    size_t cap = out->capacity ? out->capacity * 2 : 16;
+                    leuko_git_changed_file_t *files = realloc(out->files, cap * sizeof(leuko_git_changed_file_t));
+                    if (!files)
+                    {
+                        free(path);
+                        leuko_git_changes_free(out);
+                        return false;
+                    }
+                    out->files = files;
+                    out->capacity = cap;
+                }
+                file = &out->files[out->count++];
+                memset(file, 0, sizeof(*file));
+                file->path = path;
+            }
+        }
+        else if (n > 3 && memcmp(line, "@@ -", 4) == 0)
+        {
+            long old_start = 0;
+            long new_start = 0;
+            long new_count = 0;
+            const char *p = leuko_git_parse_range(line + 4, &old_start, &old_left);
+            if (p + 2 <= stop && p[0] == ' ' && p[1] == '+')
+            {
+                leuko_git_parse_range(p + 2, &new_start, &new_count);
+            }
+            new_left = new_count;
+            if (file && new_count > 0 && !leuko_line_set_push(&file->lines, (int32_t)new_start, (int32_t)(new_start + new_count - 1)))
+            {
+                leuko_git_changes_free(out);
+                return false;
+            }
+        }
+        line = nl ? nl + 1 : end;
+    }
+    return true;
+}
+
+/**
+ * @brief Compare two changed files by path.
+ */
+static int leuko_git_changed_file_cmp(const void *a, const void *b)
+{
+    return strcmp(((const leuko_git_changed_file_t *)a)->path, ((const leuko_git_changed_file_t *)b)->path);
+}
+
+/**
+ * @brief Run `git diff` against a revision and collect the changed files and lines.
+ * @param rev Revision to compare the working tree with
+ * @param out Output: changed files that still exist, by resolved path (caller frees)
+ * @return true on success, false if git failed or the revision is invalid (reported on stderr)
+ * @note git is spawned directly (no shell) with the revision as a single
+ *       argument, so it cannot inject options or commands. Paths are
+ *       relative to the current directory (`--relative`) and resolved with
+ *       realpath so they match however the files were named on the command
+ *       line.
+ */
+bool leuko_git_changes_load(const char *rev, leuko_git_changes_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (!rev || !*rev || rev[0] == '-')
+    {
+        fprintf(stderr, "Invalid revision: %s\n", rev ? rev : "");
+        return false;
+    }
+    char *argv[] = {"git", "-c", "core.quotePath=false", "diff", "--no-color", "--no-ext-diff", "--no-renames", "--unified=0", "--relative", (char *)rev, "--", NULL};
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        return false;
+    }
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, fds[0]);
+    posix_spawn_file_actions_addclose(&actions, fds[1]);
+    pid_t pid;
+    int spawned = posix_spawnp(&pid, "git", &actions, NULL, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+    if (spawned != 0)
+    {
+        close(fds[0]);
+        fprintf(stderr, "could not run git\n");
+        return false;
+    }
+
+    char *diff = NULL;
+    size_t len = 0;
+    size_t cap = 0;
+    bool ok = true;
+    for (;;)
+    {
+        if (len + 65536 > cap)
+        {
+            cap = cap ? cap * 2 : 65536;
+            char *grown = realloc(diff, cap);
+            if (!grown)
+            {
+                ok = false;
+                break;
+            }
+            diff = grown;
+        }
+        ssize_t n = read(fds[0], diff + len, cap - len);
+        if (n <= 0)
+        {
+            break;
+        }
+        len += (size_t)n;
+    }
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+        fprintf(stderr, "git diff %s failed\n", rev);
+        ok = false;
+    }
+    ok = ok && leuko_git_changes_parse(diff ? diff : "", len, out);
+    free(diff);
+    if (!ok)
+    {
+        return false;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < out->count; ++i)
+    {
+        char *resolved = realpath(out->files[i].path, NULL);
+        free(out->files[i].path);
+        out->files[i].path = resolved;
+        if (!resolved)
+        {
+            free(out->files[i].lines.firsts);
+            free(out->files[i].lines.lasts);
+            continue;
+        }
+        out->files[kept++] = out->files[i];
+    }
+    out->count = kept;
+    qsort(out->files, out->count, sizeof(leuko_git_changed_file_t), leuko_git_changed_file_cmp);
+    return true;
+}
+
+/**
+ * @brief Look up a file among the changed files.
+ * @param changes Changes from `leuko_git_changes_load`
+ * @param path File path as given (resolved before the lookup)
+ * @return Changed file, or NULL if the file did not change
+ */
+const leuko_git_changed_file_t *leuko_git_changes_find(const leuko_git_changes_t *changes, const char *path)
+{
+    char *resolved = realpath(path, NULL);
+    if (!resolved)
+    {
+        return NULL;
+    }
+    leuko_git_changed_file_t key = {.path = resolved};
+    const leuko_git_changed_file_t *found = bsearch(&key, changes->files, changes->count, sizeof(leuko_git_changed_file_t), leuko_git_changed_file_cmp);
+    free(resolved);
+    return found;
+}
+
+/**
+ * @brief Free memory owned by the changes.
+ * @param changes Changes
+ */
+void leuko_git_changes_free(leuko_git_changes_t *changes)
+{
+    if (!changes)
+    {
+        return;
+    }
+    for (size_t i = 0; i < changes->count; ++i)
+    {
+        free(changes->files[i].path);
+        free(changes->files[i].lines.firsts);
+        free(changes->files[i].lines.lasts);
+    }
+    free(changes->files);
+    memset(changes, 0, sizeof(*changes));
+}
@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "engine/engine.h"
+
+#define LONG_VALUE "\"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\""
+
+/**
+ * @brief What the result callback saw.
+ */
+typedef struct seen_s
+{
+    int rc;
+    bool called;
+} seen_t;
+
+static void on_result(const leuko_lint_result_t *result, void *data)
+{
+    seen_t *seen = data;
+    seen->called = true;
+    const leuko_diagnostic_buffer_t *d = result->diagnostics;
+    leuko_processed_source_t *ps = result->ps;
+
+    /* every line was corrected, only the offenses on lines 2 and 3 are reported */
+    const char *corrected = "a = 1\nb = 2\nlong = " LONG_VALUE "\nc = 3\n";
+    if ((size_t)(ps->source_end - ps->source_start) != strlen(corrected) || memcmp(ps->source_start, corrected, strlen(corrected)) != 0)
+    {
+        seen->rc = 2;
+        return;
+    }
+    if (d->count != 2)
+    {
+        seen->rc = 3;
+        return;
+    }
+    for (size_t i = 0; i < d->count; ++i)
+    {
+        int32_t line = leuko_processed_source_line_of_pos(ps, leuko_offset_to_pos(ps, d->begin_offsets[i]));
+        bool corrected_offense = (d->flags[i] & LEUKO_DIAGNOSTIC_FLAG_CORRECTED) != 0;
+        if (d->rule_ids[i] == LEUKO_RULE_ID_TRAILING_WHITESPACE ? line != 2 || !corrected_offense
+                                                                 : d->rule_ids[i] != LEUKO_RULE_ID_LINE_LENGTH || line != 3 || corrected_offense)
+        {
+            seen->rc = 4;
+            return;
+        }
+    }
+}
+
+int main(void)
+{
+    char path[] = "/tmp/leuko_changed_linesXXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+        return 1;
+    const char *source = "a = 1 \nb = 2 \nlong = " LONG_VALUE "\nc = 3 \n";
+    if (write(fd, source, strlen(source)) != (ssize_t)strlen(source))
+        return 1;
+    close(fd);
+
+    /* autocorrect with --changed-lines: lines 2-3 changed */
+    int32_t firsts[] = {2};
+    int32_t lasts[] = {3};
+    leuko_line_set_t lines = {.firsts = firsts, .lasts = lasts, .count = 1, .capacity = 1};
+    leuko_engine_options_t opts = {
+        .cancel = NULL,
+        .stop_on_diagnostic = false,
+        .fail_level = LEUKO_SEVERITY_REFACTOR,
+        .fix_mode = LEUKO_FIX_MODE_SAFE,
+        .enabled = NULL,
+    };
+    leuko_lint_job_t job = {.path = path, .file_index = 0, .worker_index = 0, .write_back = NULL, .lines = &lines};
+    leuko_diagnostic_buffer_t diagnostics;
+    leuko_diagnostic_buffer_init(&diagnostics);
+    seen_t seen = {.rc = 0, .called = false};
+    if (!leuko_engine_lint_file(&job, &opts, &diagnostics, on_result, &seen) || !seen.called)
+        seen.rc = 5;
+
+    leuko_diagnostic_buffer_free(&diagnostics);
+    unlink(path);
+    return seen.rc;
+}
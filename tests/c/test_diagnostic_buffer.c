@@ -0,0 +1,42 @@
+#include <stdlib.h>
+#include "diagnostics/diagnostic_buffer.h"
+
+int main(void)
+{
+    leuko_diagnostic_buffer_t buf;
+    leuko_diagnostic_buffer_init(&buf);
+
+    /* push past several growth steps, in descending offset order */
+    const size_t n = 100000;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (!leuko_diagnostic_buffer_push(&buf, LEUKO_RULE_ID_TRAILING_WHITESPACE, LEUKO_SEVERITY_CONVENTION, 0, (n - i) * 4, (n - i) * 4 + 2, (int32_t)i, 0))
+            return 2;
+    }
+    if (buf.count != n)
+        return 3;
+    if (buf.rule_ids[n - 1] != LEUKO_RULE_ID_TRAILING_WHITESPACE || buf.severities[0] != LEUKO_SEVERITY_CONVENTION)
+        return 4;
+    if (buf.begin_offsets[0] != n * 4 || buf.end_offsets[0] != n * 4 + 2)
+        return 5;
+    if (buf.args[(n - 1) * LEUKO_DIAGNOSTIC_ARG_MAX] != (int32_t)(n - 1))
+        return 9;
+
+    /* output order is by offset, ties keep insertion order */
+    leuko_diagnostic_buffer_push(&buf, LEUKO_RULE_ID_INDENTATION_CONSISTENCY, LEUKO_SEVERITY_CONVENTION, 0, 4, 8, 0, 0);
+    uint32_t *order = NULL;
+    if (!leuko_diagnostic_buffer_sorted_order(&buf, &order) || !order)
+        return 6;
+    if (order[0] != n - 1 || order[1] != n || order[2] != n - 2)
+        return 7;
+    free(order);
+
+    /* clear keeps the allocation */
+    size_t cap = buf.capacity;
+    leuko_diagnostic_buffer_clear(&buf);
+    if (buf.count != 0 || buf.capacity != cap)
+        return 8;
+
+    leuko_diagnostic_buffer_free(&buf);
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "cli/formatter.h"
+#include "engine/engine.h"
+#include "utils/file.h"
+
+static const char source[] = "a = 1 \nb = 2\nc = 3\nd = 4\ne = 5\nf = 6\ng = 7\nh = 8\ni = 9  \nj = 10 ";
+static const char corrected[] = "a = 1\nb = 2\nc = 3\nd = 4\ne = 5\nf = 6\ng = 7\nh = 8\ni = 9\nj = 10";
+
+/* two hunks, the second ending on a line without a newline */
+static const char expected_hunks[] = "@@ -1,4 +1,4 @@\n"
+                                     "-a = 1 \n"
+                                     "+a = 1\n"
+                                     " b = 2\n"
+                                     " c = 3\n"
+                                     " d = 4\n"
+                                     "@@ -6,5 +6,5 @@\n"
+                                     " f = 6\n"
+                                     " g = 7\n"
+                                     " h = 8\n"
+                                     "-i = 9  \n"
+                                     "-j = 10 \n"
+                                     "\\ No newline at end of file\n"
+                                     "+i = 9\n"
+                                     "+j = 10\n"
+                                     "\\ No newline at end of file\n";
+
+static bool write_file(const char *path, const char *data)
+{
+    FILE *f = fopen(path, "w");
+    if (!f)
+        return false;
+    fputs(data, f);
+    return fclose(f) == 0;
+}
+
+static bool has_contents(const char *path, const char *data)
+{
+    uint8_t *read = NULL;
+    size_t len = 0;
+    bool ok = leuko_file_read_all(path, &read, &len) && len == strlen(data) && memcmp(read, data, len) == 0;
+    free(read);
+    return ok;
+}
+
+int main(void)
+{
+    char dir[] = "/tmp/leuko_diff_formatterXXXXXX";
+    if (!mkdtemp(dir) || chdir(dir) != 0)
+        return 1;
+    char absolute[PATH_MAX];
+    snprintf(absolute, sizeof(absolute), "%s/b.rb", dir);
+    if (!write_file("a.rb", source) || !write_file("b.rb", source))
+        return 2;
+
+    /* the default collection names files `./a.rb`, arguments may be absolute */
+    char *files[] = {"./a.rb", absolute};
+    int fd = open("out.diff", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    leuko_cli_report_t report;
+    if (fd < 0 || !leuko_cli_report_begin(&report, LEUKO_CLI_FORMATTER_DIFF, files, 2, 1, fd))
+        return 3;
+    leuko_engine_options_t opts = {
+        .cancel = NULL,
+        .stop_on_diagnostic = false,
+        .fail_level = LEUKO_SEVERITY_REFACTOR,
+        .fix_mode = LEUKO_FIX_MODE_SAFE,
+        .enabled = NULL,
+    };
+    leuko_diagnostic_buffer_t diagnostics;
+    leuko_diagnostic_buffer_init(&diagnostics);
+    int rc = 0;
+    for (size_t i = 0; i < 2 && !rc; ++i)
+    {
+        leuko_lint_job_t job = {.path = files[i], .file_index = i, .worker_index = 0, .write_back = NULL, .lines = NULL};
+        if (!leuko_engine_lint_file(&job, &opts, &diagnostics, leuko_cli_report_on_result, &report))
+            rc = 4;
+        leuko_cli_report_on_file_done(i, 0, &report);
+    }
+    leuko_diagnostic_buffer_free(&diagnostics);
+    if (!leuko_cli_report_end(&report) && !rc)
+        rc = 5;
+    close(fd);
+
+    /* headers name both files relative to the current directory */
+    size_t len = strlen(expected_hunks);
+    char *expected = malloc(2 * (len + 64));
+    snprintf(expected, 2 * (len + 64), "--- a/a.rb\n+++ b/a.rb\n%s--- a/b.rb\n+++ b/b.rb\n%s", expected_hunks, expected_hunks);
+    if (!rc && !has_contents("out.diff", expected))
+        rc = 6;
+    free(expected);
+
+    /* git takes the patch as it is and ends with the corrected files */
+    if (!rc && system("git apply --check out.diff && git apply out.diff") != 0)
+        rc = 7;
+    if (!rc && (!has_contents("a.rb", corrected) || !has_contents("b.rb", corrected)))
+        rc = 8;
+
+    unlink("a.rb");
+    unlink("b.rb");
+    unlink("out.diff");
+    if (chdir("/") == 0)
+        rmdir(dir);
+    return rc;
+}
@@ -0,0 +1,82 @@
+#include <stdlib.h>
+#include <string.h>
+#include "quickfix/change_map.h"
+#include "quickfix/edit_list.h"
+
+int main(void)
+{
+    const char *src = "def foo  \n  x = 1\n   y = 2\nend\n";
+    size_t len = strlen(src);
+    leuko_edit_list_t list;
+    leuko_edit_list_init(&list);
+
+    /* group 2: dedent line 3 by one; group 0: drop trailing spaces; pushed out of order */
+    if (!leuko_edit_list_push(&list, 2, 18, 19, NULL, 0))
+        return 2;
+    if (!leuko_edit_list_push(&list, 0, 7, 9, NULL, 0))
+        return 3;
+    /* group 1 replaces a range overlapping group 0: dropped as a whole */
+    if (!leuko_edit_list_push(&list, 1, 4, 8, "bar", 3) || !leuko_edit_list_push(&list, 1, 30, 30, "#", 1))
+        return 4;
+    /* group 3 inserts at the same offset as group 2 starts: kept, applied in order */
+    if (!leuko_edit_list_push(&list, 3, 18, 18, "#", 1))
+        return 5;
+
+    if (leuko_edit_list_resolve(&list) != 3)
+        return 6;
+    uint8_t *out = NULL;
+    size_t out_len = 0;
+    if (!leuko_edit_list_apply(&list, (const uint8_t *)src, len, &out, &out_len))
+        return 7;
+    const char *expected = "def foo\n  x = 1\n#  y = 2\nend\n";
+    if (out_len != strlen(expected) || memcmp(out, expected, out_len) != 0)
+        return 8;
+
+    /* offsets before, inside and after the edits */
+    if (leuko_edit_list_map_offset(&list, 4) != 4)
+        return 9;
+    if (leuko_edit_list_map_offset(&list, 8) != 7)
+        return 10;
+    if (leuko_edit_list_map_offset(&list, 9) != 7)
+        return 11;
+    if (leuko_edit_list_map_offset(&list, 21) != 19)
+        return 12;
+    free(out);
+
+    /* clear keeps the allocation; an empty list resolves to nothing */
+    leuko_edit_list_clear(&list);
+    if (list.count != 0 || leuko_edit_list_resolve(&list) != 0)
+        return 13;
+
+    /* change map: two passes, the second touching the range the first replaced */
+    const char *orig = "ab  \ncd\n";
+    leuko_change_map_t map;
+    leuko_change_map_init(&map);
+    if (!leuko_edit_list_push(&list, 0, 2, 4, NULL, 0) || leuko_edit_list_resolve(&list) != 1 ||
+        !leuko_edit_list_apply(&list, (const uint8_t *)orig, strlen(orig), &out, &out_len) || !leuko_change_map_add(&map, &list))
+        return 14;
+    /* "ab\ncd\n": insert before "ab" and after "b" */
+    leuko_edit_list_clear(&list);
+    uint8_t *out2 = NULL;
+    size_t out2_len = 0;
+    if (!leuko_edit_list_push(&list, 0, 0, 0, "#", 1) || !leuko_edit_list_push(&list, 1, 2, 2, "!", 1) || leuko_edit_list_resolve(&list) != 2 ||
+        !leuko_edit_list_apply(&list, out, out_len, &out2, &out2_len) || !leuko_change_map_add(&map, &list))
+        return 15;
+    if (out2_len != 8 || memcmp(out2, "#ab!\ncd\n", 8) != 0)
+        return 16;
+    /* both edits are separate from the first change, the second one touches it */
+    if (map.count != 2 || map.changes[0].orig_begin != 0 || map.changes[0].orig_end != 0 || map.changes[0].begin != 0 || map.changes[0].end != 1)
+        return 17;
+    if (map.changes[1].orig_begin != 2 || map.changes[1].orig_end != 4 || map.changes[1].begin != 3 || map.changes[1].end != 4)
+        return 18;
+    /* corrected offsets map back: around, inside and after the changes */
+    if (leuko_change_map_original_offset(&map, 1) != 0 || leuko_change_map_original_offset(&map, 3) != 2 || leuko_change_map_original_offset(&map, 4) != 4 ||
+        leuko_change_map_original_offset(&map, 5) != 5)
+        return 19;
+    free(out);
+    free(out2);
+    leuko_change_map_free(&map);
+
+    leuko_edit_list_free(&list);
+    return 0;
+}
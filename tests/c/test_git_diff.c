@@ -0,0 +1,59 @@
+#include <string.h>
+#include "utils/git_diff.h"
+
+int main(void)
+{
+    /* a body line that looks like a file header must not start a new file */
+    const char *diff = "diff --git a/lib/a.rb b/lib/a.rb\n"
+                       "--- a/lib/a.rb\n"
+                       "+++ b/lib/a.rb\n"
+                       "@@ -3 +3,2 @@ def foo\n"
+                       "-  x\n"
+                       "+++ y\n"
+                       "+  z\n"
+                       "@@ -10,0 +12 @@\n"
+                       "+  w\n"
+                       "@@ -20,2 +22,0 @@\n"
+                       "-  gone\n"
+                       "-  gone\n"
+                       "diff --git a/old.rb b/old.rb\n"
+                       "--- a/old.rb\n"
+                       "+++ /dev/null\n"
+                       "@@ -1 +0,0 @@\n"
+                       "-x\n"
+                       "diff --git a/sp ace.rb b/sp ace.rb\n"
+                       "--- \"a/t\\303\\251st.rb\"\n"
+                       "+++ \"b/t\\303\\251st.rb\"\n"
+                       "@@ -0,0 +1,3 @@\n"
+                       "+a\n"
+                       "+b\n"
+                       "+c\n"
+                       "diff --git a/my file.rb b/my file.rb\n"
+                       "--- a/my file.rb\t\n"
+                       "+++ b/my file.rb\t\r\n"
+                       "@@ -2 +2 @@\n"
+                       "-x\n"
+                       "+x \n";
+    leuko_git_changes_t changes;
+    if (!leuko_git_changes_parse(diff, strlen(diff), &changes))
+        return 1;
+    if (changes.count != 3)
+        return 2;
+    if (strcmp(changes.files[0].path, "lib/a.rb") != 0 || strcmp(changes.files[1].path, "t\xc3\xa9st.rb") != 0)
+        return 3;
+    /* the TAB after a path with a space is not part of it */
+    if (strcmp(changes.files[2].path, "my file.rb") != 0 || changes.files[2].lines.count != 1 || changes.files[2].lines.firsts[0] != 2)
+        return 7;
+
+    /* lines 3-4 and 12 merge into two ranges; the pure deletion adds none */
+    const leuko_line_set_t *lines = &changes.files[0].lines;
+    if (lines->count != 2 || lines->firsts[0] != 3 || lines->lasts[0] != 4 || lines->firsts[1] != 12 || lines->lasts[1] != 12)
+        return 4;
+    if (leuko_line_set_intersects(lines, 1, 2) || !leuko_line_set_intersects(lines, 1, 3) || !leuko_line_set_intersects(lines, 4, 4))
+        return 5;
+    if (leuko_line_set_intersects(lines, 5, 11) || !leuko_line_set_intersects(lines, 5, 30) || leuko_line_set_intersects(lines, 13, 40))
+        return 6;
+
+    leuko_git_changes_free(&changes);
+    return 0;
+}
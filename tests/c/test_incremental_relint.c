@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "engine/engine.h"
+
+/**
+ * @brief Corrected source and final offenses of one run.
+ */
+typedef struct outcome_s
+{
+    char *source;
+    size_t source_len;
+    leuko_diagnostic_buffer_t diagnostics;
+} outcome_t;
+
+static void on_result(const leuko_lint_result_t *result, void *data)
+{
+    outcome_t *out = data;
+    out->source_len = (size_t)(result->ps->source_end - result->ps->source_start);
+    out->source = malloc(out->source_len + 1);
+    memcpy(out->source, result->ps->source_start, out->source_len);
+    for (size_t i = 0; i < result->diagnostics->count; ++i)
+        leuko_diagnostic_buffer_push_from(&out->diagnostics, result->diagnostics, i);
+}
+
+/* offense order differs between the passes: compare by position */
+static int compare_offense(const leuko_diagnostic_buffer_t *d, size_t a, size_t b)
+{
+    if (d->begin_offsets[a] != d->begin_offsets[b])
+        return d->begin_offsets[a] < d->begin_offsets[b] ? -1 : 1;
+    if (d->end_offsets[a] != d->end_offsets[b])
+        return d->end_offsets[a] < d->end_offsets[b] ? -1 : 1;
+    return (int)d->rule_ids[a] - (int)d->rule_ids[b];
+}
+
+static void sort_offenses(leuko_diagnostic_buffer_t *d, size_t *order)
+{
+    for (size_t i = 0; i < d->count; ++i)
+        order[i] = i;
+    for (size_t i = 1; i < d->count; ++i)
+        for (size_t j = i; j > 0 && compare_offense(d, order[j - 1], order[j]) > 0; --j)
+        {
+            size_t t = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = t;
+        }
+}
+
+static bool lint(const char *path, bool full_relint, outcome_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    leuko_diagnostic_buffer_init(&out->diagnostics);
+    leuko_engine_options_t opts = {
+        .cancel = NULL,
+        .stop_on_diagnostic = false,
+        .fail_level = LEUKO_SEVERITY_REFACTOR,
+        .fix_mode = LEUKO_FIX_MODE_SAFE,
+        .enabled = NULL,
+        .full_relint = full_relint,
+    };
+    leuko_lint_job_t job = {.path = path, .file_index = 0, .worker_index = 0, .write_back = NULL, .lines = NULL};
+    leuko_diagnostic_buffer_t diagnostics;
+    leuko_diagnostic_buffer_init(&diagnostics);
+    bool ok = leuko_engine_lint_file(&job, &opts, &diagnostics, on_result, out) && out->source;
+    leuko_diagnostic_buffer_free(&diagnostics);
+    return ok;
+}
+
+/* the incremental passes must end where re-linting from scratch does */
+static int check(const char *dir, const char *name, const char *source)
+{
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE *f = fopen(path, "w");
+    if (!f)
+        return 1;
+    fputs(source, f);
+    fclose(f);
+
+    outcome_t incremental;
+    outcome_t full;
+    int rc = 0;
+    if (!lint(path, false, &incremental) || !lint(path, true, &full))
+        rc = 2;
+    else if (incremental.source_len != full.source_len || memcmp(incremental.source, full.source, full.source_len) != 0)
+        rc = 3;
+    else if (incremental.diagnostics.count != full.diagnostics.count || full.diagnostics.count == 0)
+        rc = 4;
+    else
+    {
+        size_t *a = malloc(full.diagnostics.count * sizeof(size_t));
+        size_t *b = malloc(full.diagnostics.count * sizeof(size_t));
+        sort_offenses(&incremental.diagnostics, a);
+        sort_offenses(&full.diagnostics, b);
+        for (size_t i = 0; i < full.diagnostics.count && !rc; ++i)
+        {
+            const leuko_diagnostic_buffer_t *x = &incremental.diagnostics;
+            const leuko_diagnostic_buffer_t *y = &full.diagnostics;
+            if (x->rule_ids[a[i]] != y->rule_ids[b[i]] || x->begin_offsets[a[i]] != y->begin_offsets[b[i]] ||
+                x->end_offsets[a[i]] != y->end_offsets[b[i]] || x->flags[a[i]] != y->flags[b[i]])
+                rc = 5;
+        }
+        free(a);
+        free(b);
+    }
+    free(incremental.source);
+    free(full.source);
+    leuko_diagnostic_buffer_free(&incremental.diagnostics);
+    leuko_diagnostic_buffer_free(&full.diagnostics);
+    unlink(path);
+    return rc;
+}
+
+#define LONG_VALUE "\"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\""
+
+int main(void)
+{
+    char dir[] = "/tmp/leuko_incrementalXXXXXX";
+    if (!mkdtemp(dir))
+        return 1;
+
+    /* trailing whitespace and long lines on the same and neighbouring lines,
+       inside a heredoc (reported, not corrected) and after a continuation */
+    const char *local = "x = 1   \n"
+                        "long = " LONG_VALUE " + \"bb\"  \n"
+                        "short_after = 2\n"
+                        "neighbour = " LONG_VALUE " + \"cc\"\n"
+                        "y = 3 \n"
+                        "just = " LONG_VALUE "   \n"
+                        "text = <<~EOS\n"
+                        "  inside heredoc   \n"
+                        "EOS\n"
+                        "b = 1 + \\\n"
+                        "  2   \n"
+                        "z = 4\t\n";
+    int rc = check(dir, "local.rb", local);
+
+    /* whitespace right after a backslash: the correction makes a
+       continuation, so the next pass is parsed again */
+    const char *continuation = "a = 1 + \\ \n"
+                               "  2 \n"
+                               "long = " LONG_VALUE " + \"bb\"  \n"
+                               "text = <<~EOS\n"
+                               "  inside heredoc \n"
+                               "EOS\n";
+    if (!rc && (rc = check(dir, "continuation.rb", continuation)) != 0)
+        rc += 10;
+
+    /* CRLF line breaks: the blanks before the CR are the trailing ones */
+    const char *crlf = "x = 1   \r\n"
+                       "long = " LONG_VALUE " + \"bb\"  \r\n"
+                       "y = 2\t\r\n";
+    if (!rc && (rc = check(dir, "crlf.rb", crlf)) != 0)
+        rc += 20;
+
+    rmdir(dir);
+    return rc;
+}
@@ -0,0 +1,44 @@
+#include <stdlib.h>
+#include <string.h>
+#include "output/json_escape.h"
+
+int main(void)
+{
+    /* the scan finds the first special byte at every position of the vector and tail loops */
+    char s[64];
+    const char specials[] = {'"', '\\', '\n', 0x01, 0x1F};
+    for (size_t k = 0; k < sizeof(specials); ++k)
+    {
+        for (size_t pos = 0; pos < sizeof(s); ++pos)
+        {
+            memset(s, 'a', sizeof(s));
+            s[pos] = specials[k];
+            if (leuko_json_escape_scan(s, sizeof(s)) != pos)
+                return 2;
+        }
+    }
+
+    /* non-ASCII and boundary bytes are not escaped */
+    memset(s, 0x20, sizeof(s));
+    s[5] = (char)0x80;
+    s[17] = (char)0xFF;
+    s[40] = 0x7F;
+    if (leuko_json_escape_scan(s, sizeof(s)) != sizeof(s))
+        return 3;
+
+    leuko_output_buffer_t out;
+    leuko_output_buffer_init(&out);
+    const char in[] = "path/\"quoted\"\\\ttab\x01 caf\xC3\xA9 and a long clean tail of text";
+    const char expected[] = "\"path/\\\"quoted\\\"\\\\\\ttab\\u0001 caf\xC3\xA9 and a long clean tail of text\"";
+    if (!leuko_json_append_string(&out, in, sizeof(in) - 1))
+        return 4;
+    if (out.len != sizeof(expected) - 1 || memcmp(out.data, expected, out.len) != 0)
+        return 5;
+
+    out.len = 0;
+    if (!leuko_json_append_string(&out, "", 0) || out.len != 2 || memcmp(out.data, "\"\"", 2) != 0)
+        return 6;
+
+    leuko_output_buffer_free(&out);
+    return 0;
+}
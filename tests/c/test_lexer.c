@@ -0,0 +1,100 @@
+#include <string.h>
+#include "sources/lexer.h"
+
+/**
+ * @brief Lex a source and compare the flags of every line.
+ */
+static int check(const char *src, const uint8_t *expected, size_t line_count)
+{
+    uint8_t flags[32];
+    size_t lines = 1;
+    for (const char *p = src; *p; ++p)
+        lines += *p == '\n';
+    if (lines != line_count || !leuko_lex_line_flags((const uint8_t *)src, strlen(src), line_count, flags))
+        return 0;
+    return memcmp(flags, expected, line_count) == 0;
+}
+
+/**
+ * @brief Token collector: types and texts joined by spaces.
+ */
+typedef struct
+{
+    char out[256];
+    size_t len;
+} tokens_t;
+
+static void on_token(const leuko_token_t *token, void *data)
+{
+    tokens_t *t = data;
+    size_t n = (size_t)(token->end - token->start);
+    if (t->len + n + 4 >= sizeof(t->out))
+        return;
+    t->out[t->len++] = (char)('A' + token->type);
+    memcpy(t->out + t->len, token->start, n);
+    t->len += n;
+    t->out[t->len++] = ' ';
+    t->out[t->len] = '\0';
+}
+
+#define S LEUKO_LINE_IN_STRING
+#define H (LEUKO_LINE_HEREDOC | LEUKO_LINE_IN_STRING)
+#define D LEUKO_LINE_DATA
+
+int main(void)
+{
+    /* multi-line strings, with escapes and interpolation holding a string */
+    const char *strings = "a = 'x \n"
+                          "y'\n"
+                          "b = \"#{c(\"}\")} \n"
+                          "d\" # ' not a string\n"
+                          "e = %w[f [g]\n"
+                          "h]\n";
+    const uint8_t strings_flags[] = {S, 0, S, 0, S, 0, 0};
+    if (!check(strings, strings_flags, 7))
+        return 1;
+
+    /* heredocs: two on one line, indented terminator, quoted id; shift and
+       the singleton class opener (spaced or not) are not one */
+    const char *heredocs = "x = <<~A + <<-'B'\n"
+                           "  a \n"
+                           "  A\n"
+                           "b\n"
+                           "  B\n"
+                           "y << z\n"
+                           "class << self\n"
+                           "end\n"
+                           "class <<self\n"
+                           "  x = 1 \n"
+                           "end\n";
+    const uint8_t heredoc_flags[] = {0, H, 0, H, 0, 0, 0, 0, 0, 0, 0, 0};
+    if (!check(heredocs, heredoc_flags, 12))
+        return 2;
+
+    /* division is not a regexp, a regexp argument is; character literals and `$'` */
+    const char *operators = "a = b / c\n"
+                            "puts /x\n"
+                            "y/ if d ? e : f\n"
+                            "g = ?' + $' + :'h'\n"
+                            "def /(other) = 1\n"
+                            "=begin\n"
+                            "'\n"
+                            "=end\n"
+                            "__END__\n"
+                            "'\n";
+    const uint8_t operator_flags[] = {0, 0, 0, 0, 0, 0, 0, 0, 0, D, D};
+    if (!check(operators, operator_flags, 11))
+        return 3;
+
+    /* tokens: a literal is its delimiters around interpolated code, operators join */
+    const char *code = "x ||= @a / 2 # c\n"
+                       "foo(k: \"v#{1}\", **h) <=> :<=> if A::B\n";
+    tokens_t tokens = {.len = 0};
+    if (!leuko_lex((const uint8_t *)code, strlen(code), 3, NULL, on_token, &tokens))
+        return 4;
+    const char *expected = "Cx P||= C@a P/ F2 B# c A\n "
+                           "Cfoo O( Ek: I\" M#{ F1 N} J\" O, P** Ch O) P<=> H:<=> Dif CA P:: CB A\n ";
+    if (strcmp(tokens.out, expected) != 0)
+        return 5;
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#define LEUKO_LOG_LEVEL LEUKO_LOG_LEVEL_INFO
+#include "leuko_debug.h"
+
+static int evaluated;
+static int side_effect(void)
+{
+    return ++evaluated;
+}
+
+int main(void)
+{
+    /* defaults: warnings and errors of every category */
+    if (!leuko_log_enabled(LEUKO_LOG_LEVEL_WARN, LEUKO_LOG_RULES) || leuko_log_enabled(LEUKO_LOG_LEVEL_INFO, LEUKO_LOG_RULES))
+        return 1;
+
+    setenv("LEUKO_LOG", "trace:engine,io", 1);
+    leuko_log_init();
+    if (!leuko_log_enabled(LEUKO_LOG_LEVEL_TRACE, LEUKO_LOG_IO) || leuko_log_enabled(LEUKO_LOG_LEVEL_ERROR, LEUKO_LOG_PRISM))
+        return 2;
+
+    /* an unknown level keeps the current settings */
+    setenv("LEUKO_LOG", "verbose", 1);
+    leuko_log_init();
+    if (!leuko_log_enabled(LEUKO_LOG_LEVEL_TRACE, LEUKO_LOG_ENGINE))
+        return 3;
+
+    /* capture stderr */
+    char path[] = "/tmp/leuko_test_log_XXXXXX";
+    int fd = mkstemp(path);
+    int saved = dup(STDERR_FILENO);
+    if (fd < 0 || saved < 0 || dup2(fd, STDERR_FILENO) < 0)
+        return 4;
+
+    /* above the compiled level: arguments are not evaluated */
+    LEUKO_LOG_DEBUG(LEUKO_LOG_ENGINE, "%d\n", side_effect());
+    LEUKO_LOG_TRACE(LEUKO_LOG_ENGINE, "%d\n", side_effect());
+    /* filtered by category at run time */
+    LEUKO_LOG_INFO(LEUKO_LOG_RULES, "hidden %d\n", side_effect());
+    /* a message split over two calls gets one prefix */
+    LEUKO_LOG_INFO(LEUKO_LOG_ENGINE, "pass %d", 1);
+    LEUKO_LOG_INFO(LEUKO_LOG_ENGINE, " done\n");
+    LEUKO_LOG_WARN(LEUKO_LOG_IO, "slow %s\n", "disk");
+    leuko_log_flush();
+
+    dup2(saved, STDERR_FILENO);
+    char text[256] = {0};
+    ssize_t n = pread(fd, text, sizeof(text) - 1, 0);
+    close(fd);
+    unlink(path);
+    if (evaluated != 0)
+        return 5;
+    if (n < 0 || strcmp(text, "[info engine] pass 1 done\n[warn io] slow disk\n") != 0)
+        return 6;
+    return 0;
+}
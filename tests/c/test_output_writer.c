@@ -0,0 +1,95 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "output/output_writer.h"
+#include "utils/file.h"
+
+/* more chunks than fit in one writev batch */
+#define CHUNK_COUNT 3000
+#define THREADS 4
+#define EMPTY_SEQ 1234   /* submitted without bytes */
+#define MISSING_SEQ 2999 /* never submitted: skipped by the final drain */
+
+typedef struct submitter_s
+{
+    leuko_output_writer_t *writer;
+    size_t index;
+} submitter_t;
+
+/* each thread submits its share of the sequence numbers backwards */
+static void *submit(void *arg)
+{
+    submitter_t *s = arg;
+    for (size_t seq = CHUNK_COUNT - THREADS + s->index + 1; seq-- > 0;)
+    {
+        if (seq % THREADS != s->index || seq == MISSING_SEQ)
+            continue;
+        leuko_output_buffer_t buf;
+        leuko_output_buffer_t deferred;
+        leuko_output_buffer_init(&buf);
+        leuko_output_buffer_init(&deferred);
+        if (seq != EMPTY_SEQ)
+            leuko_output_buffer_printf(&buf, "chunk %zu\n", seq);
+        if (seq % 100 == 0)
+            leuko_output_buffer_printf(&deferred, "d%zu;", seq);
+        leuko_output_writer_submit(s->writer, seq, &buf, &deferred);
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    char path[] = "/tmp/leuko_output_writerXXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+        return 1;
+    leuko_output_writer_t *writer = leuko_output_writer_new(fd, CHUNK_COUNT);
+    if (!writer)
+        return 2;
+
+    pthread_t threads[THREADS];
+    submitter_t submitters[THREADS];
+    for (size_t i = 0; i < THREADS; ++i)
+    {
+        submitters[i] = (submitter_t){.writer = writer, .index = i};
+        if (pthread_create(&threads[i], NULL, submit, &submitters[i]) != 0)
+            return 3;
+    }
+    for (size_t i = 0; i < THREADS; ++i)
+        pthread_join(threads[i], NULL);
+    leuko_output_buffer_t deferred;
+    if (!leuko_output_writer_finish(writer, &deferred))
+        return 4;
+    close(fd);
+
+    /* chunks come out in sequence order, the empty and the missing one add nothing */
+    leuko_output_buffer_t expected;
+    leuko_output_buffer_t expected_deferred;
+    leuko_output_buffer_init(&expected);
+    leuko_output_buffer_init(&expected_deferred);
+    for (size_t seq = 0; seq < CHUNK_COUNT; ++seq)
+    {
+        if (seq != EMPTY_SEQ && seq != MISSING_SEQ)
+            leuko_output_buffer_printf(&expected, "chunk %zu\n", seq);
+        if (seq % 100 == 0)
+            leuko_output_buffer_printf(&expected_deferred, "d%zu;", seq);
+    }
+    uint8_t *data = NULL;
+    size_t len = 0;
+    int rc = 0;
+    if (!leuko_file_read_all(path, &data, &len))
+        rc = 5;
+    else if (len != expected.len || memcmp(data, expected.data, len) != 0)
+        rc = 6;
+    else if (deferred.len != expected_deferred.len || memcmp(deferred.data, expected_deferred.data, deferred.len) != 0)
+        rc = 7;
+
+    free(data);
+    unlink(path);
+    leuko_output_buffer_free(&expected);
+    leuko_output_buffer_free(&expected_deferred);
+    leuko_output_buffer_free(&deferred);
+    return rc;
+}
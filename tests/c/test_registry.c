@@ -0,0 +1,37 @@
+#include <string.h>
+#include "rules/rule.h"
+
+int main(void)
+{
+    /* every id has its entry, and AST input entries list node types */
+    for (leuko_rule_id_t id = 0; id < LEUKO_RULE_ID_COUNT; ++id)
+    {
+        const leuko_rule_info_t *info = leuko_rule_info(id);
+        if (info->id != id || !info->category || !info->name)
+            return 1;
+        if ((info->input == LEUKO_RULE_INPUT_AST) != (info->node_type_count > 0))
+            return 2;
+        if (info->safe_autocorrect && !info->autocorrectable)
+            return 3;
+    }
+
+    /* implemented rules agree with their entry */
+    size_t count = 0;
+    const leuko_rule_t *const *rules = leuko_rules_all(&count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const leuko_rule_t *rule = rules[i];
+        const leuko_rule_info_t *info = leuko_rule_info(rule->id);
+        if (leuko_rule_by_id(rule->id) != rule)
+            return 4;
+        if (strcmp(rule->category, info->category) != 0 || strcmp(rule->name, info->name) != 0)
+            return 5;
+        if (rule->autocorrectable != info->autocorrectable || rule->safe_autocorrect != info->safe_autocorrect)
+            return 6;
+        bool source = info->input == LEUKO_RULE_INPUT_BYTES || info->input == LEUKO_RULE_INPUT_LINES;
+        if (!rule->check_source != !source || !rule->check_token != (info->input != LEUKO_RULE_INPUT_TOKENS) ||
+            !rule->check_node != (info->input != LEUKO_RULE_INPUT_AST))
+            return 7;
+    }
+    return 0;
+}
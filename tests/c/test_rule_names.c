@@ -0,0 +1,66 @@
+#include <string.h>
+#include "rules/rule.h"
+
+/**
+ * @brief Look up a name and check that it selects exactly one rule.
+ */
+static int selects_only(const char *name, leuko_rule_id_t id)
+{
+    leuko_rule_set_t set = {{0}};
+    leuko_rule_set_t expected = {{0}};
+    leuko_rule_set_add(&expected, id);
+    return leuko_rule_set_add_name(&set, name, strlen(name)) && memcmp(&set, &expected, sizeof(set)) == 0;
+}
+
+int main(void)
+{
+    /* every spelling of every registered rule */
+    for (leuko_rule_id_t id = 0; id < LEUKO_RULE_ID_COUNT; ++id)
+    {
+        const leuko_rule_info_t *info = leuko_rule_info(id);
+        char qualified[128];
+        char snake[128];
+        size_t n = 0;
+        for (const char *p = info->name; *p && n + 2 < sizeof(snake); ++p)
+        {
+            if (*p >= 'A' && *p <= 'Z' && p != info->name)
+                snake[n++] = '_';
+            snake[n++] = (char)(*p >= 'A' && *p <= 'Z' ? *p - 'A' + 'a' : *p);
+        }
+        snake[n] = '\0';
+        strcpy(qualified, info->category);
+        strcat(qualified, "/");
+        strcat(qualified, info->name);
+        if (!selects_only(qualified, id) || !selects_only(info->name, id) || !selects_only(snake, id))
+            return 1;
+    }
+
+    /* unknown names and near misses leave the set alone */
+    static const char *const unknown[] = {"", "Layout/", "Layout/Nope", "layout/line_length", "LineLengthX", "Lint/LineLength"};
+    for (size_t i = 0; i < sizeof(unknown) / sizeof(unknown[0]); ++i)
+    {
+        leuko_rule_set_t set = {{0}};
+        leuko_rule_set_t empty = {{0}};
+        if (leuko_rule_set_add_name(&set, unknown[i], strlen(unknown[i])) || memcmp(&set, &empty, sizeof(set)) != 0)
+            return 2;
+    }
+
+    /* categories select their rules */
+    leuko_rule_set_t layout = {{0}};
+    if (!leuko_rule_set_add_name(&layout, "layout", 6))
+        return 3;
+    for (leuko_rule_id_t id = 0; id < LEUKO_RULE_ID_COUNT; ++id)
+    {
+        if (leuko_rule_set_has(&layout, id) != (strcmp(leuko_rule_info(id)->category, LEUKO_RULE_CATEGORY_NAME_LAYOUT) == 0))
+            return 4;
+    }
+
+    /* --only Layout --except line_length */
+    char *only[] = {"Layout"};
+    char *except[] = {"line_length"};
+    leuko_rule_set_t enabled;
+    if (!leuko_rules_select(only, 1, except, 1, &enabled) || leuko_rule_set_has(&enabled, LEUKO_RULE_ID_LINE_LENGTH) ||
+        !leuko_rule_set_has(&enabled, LEUKO_RULE_ID_TRAILING_WHITESPACE))
+        return 5;
+    return 0;
+}
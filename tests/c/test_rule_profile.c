@@ -0,0 +1,44 @@
+#include <string.h>
+#include "engine/profile.h"
+
+int main(void)
+{
+    leuko_rule_profile_t a;
+    leuko_rule_profile_t b;
+    memset(&a, 0, sizeof(a));
+    memset(&b, 0, sizeof(b));
+    a.rules[LEUKO_RULE_ID_LINE_LENGTH] = (leuko_rule_profile_entry_t){.ns = 100, .calls = 1, .offenses = 2};
+    a.rules[LEUKO_RULE_ID_TRAILING_WHITESPACE] = (leuko_rule_profile_entry_t){.ns = 50, .calls = 1, .offenses = 0};
+    b.rules[LEUKO_RULE_ID_TRAILING_WHITESPACE] = (leuko_rule_profile_entry_t){.ns = 250, .calls = 2, .offenses = 1};
+    b.rules[LEUKO_RULE_ID_INDENTATION_CONSISTENCY] = (leuko_rule_profile_entry_t){.ns = 100, .calls = 40, .offenses = 0};
+
+    /* merging adds every counter */
+    leuko_rule_profile_merge(&a, &b);
+    const leuko_rule_profile_entry_t *tw = &a.rules[LEUKO_RULE_ID_TRAILING_WHITESPACE];
+    if (tw->ns != 300 || tw->calls != 3 || tw->offenses != 1)
+        return 1;
+
+    /* slowest first, ties in id order, rules that never ran left out */
+    leuko_output_buffer_t out;
+    leuko_output_buffer_init(&out);
+    if (!leuko_rule_profile_render(&a, LEUKO_RULE_PROFILE_JSON, &out))
+        return 2;
+    const char *expected = "[{\"rule\":\"Layout/TrailingWhitespace\",\"ns\":300,\"calls\":3,\"offenses\":1},"
+                           "{\"rule\":\"Layout/IndentationConsistency\",\"ns\":100,\"calls\":40,\"offenses\":0},"
+                           "{\"rule\":\"Layout/LineLength\",\"ns\":100,\"calls\":1,\"offenses\":2}]\n";
+    if (out.len != strlen(expected) || memcmp(out.data, expected, out.len) != 0)
+        return 3;
+    leuko_output_buffer_free(&out);
+
+    /* the table has a header, one row per rule and a total */
+    leuko_output_buffer_init(&out);
+    if (!leuko_rule_profile_render(&a, LEUKO_RULE_PROFILE_TABLE, &out))
+        return 4;
+    size_t rows = 0;
+    for (size_t i = 0; i < out.len; ++i)
+        rows += out.data[i] == '\n';
+    if (rows != 5 || strncmp(out.data, "Rule", 4) != 0)
+        return 5;
+    leuko_output_buffer_free(&out);
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "engine/runner.h"
+
+#define FILE_COUNT 400
+#define JOBS 4
+
+static size_t run(char *const *files, leuko_severity_t fail_level, leuko_runner_stats_t *stats)
+{
+    leuko_runner_options_t opts = {
+        .jobs = JOBS,
+        .fsync = false,
+        .dry_run = true,
+        .lines = NULL,
+        .engine = {
+            .cancel = NULL,
+            .stop_on_diagnostic = true, /* exit-code-only mode */
+            .fail_level = fail_level,
+            .fix_mode = LEUKO_FIX_MODE_NONE,
+            .enabled = NULL,
+        },
+        .on_result = NULL,
+        .on_file_done = NULL,
+        .data = NULL,
+    };
+    if (!leuko_runner_run(files, FILE_COUNT, &opts, stats))
+        return 0;
+    return stats->files_linted;
+}
+
+int main(void)
+{
+    char dir[] = "/tmp/leuko_runner_cancelXXXXXX";
+    if (!mkdtemp(dir))
+        return 1;
+
+    /* every file has a trailing whitespace offense (convention) */
+    char *files[FILE_COUNT];
+    for (size_t i = 0; i < FILE_COUNT; ++i)
+    {
+        files[i] = malloc(sizeof(dir) + 32);
+        snprintf(files[i], sizeof(dir) + 32, "%s/f%zu.rb", dir, i);
+        FILE *f = fopen(files[i], "w");
+        if (!f)
+            return 2;
+        fputs("x = 1 \ny = 2\n", f);
+        fclose(f);
+    }
+
+    int rc = 0;
+    leuko_runner_stats_t stats;
+
+    /* an offense below the fail level does not stop the run */
+    if (run(files, LEUKO_SEVERITY_WARNING, &stats) != FILE_COUNT || stats.failed || stats.diagnostics != FILE_COUNT)
+        rc = 3;
+
+    /* at the fail level, the first failing file cancels every worker */
+    if (!rc && (run(files, LEUKO_SEVERITY_CONVENTION, &stats) >= FILE_COUNT || !stats.failed))
+        rc = 4;
+
+    for (size_t i = 0; i < FILE_COUNT; ++i)
+    {
+        unlink(files[i]);
+        free(files[i]);
+    }
+    rmdir(dir);
+    return rc;
+}
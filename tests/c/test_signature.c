@@ -0,0 +1,62 @@
+#include <stdlib.h>
+#include <string.h>
+#include "sources/signature.h"
+
+/**
+ * @brief Byte-at-a-time reference for the features of a source.
+ */
+static uint32_t reference_scan(const uint8_t *s, size_t len)
+{
+    uint32_t found = 0;
+    for (size_t i = 0; i < len; ++i)
+    {
+        uint8_t c = s[i];
+        uint8_t next = i + 1 < len ? s[i + 1] : '\n';
+        if ((c == ' ' || c == '\t') && (i == 0 || s[i - 1] == '\n'))
+            found |= LEUKO_FEATURE_INDENTED_LINE;
+        if ((c == ' ' || c == '\t') && (next == '\n' || next == '\r'))
+            found |= LEUKO_FEATURE_TRAILING_SPACE;
+        if (c == '\t')
+            found |= LEUKO_FEATURE_TAB;
+        if (c == '\r')
+            found |= LEUKO_FEATURE_CR;
+        if (c == '<' && i + 2 < len && s[i + 1] == '<' && strchr("~-_\"'`ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz", s[i + 2]) && s[i + 2])
+            found |= LEUKO_FEATURE_HEREDOC;
+        if (i + 6 <= len && memcmp(s + i, "rescue", 6) == 0)
+            found |= LEUKO_FEATURE_RESCUE;
+    }
+    return found;
+}
+
+int main(void)
+{
+    const char *src = "def foo\n  x = <<~EOS\n    body\n  EOS\nrescue\nend\n";
+    uint32_t found = leuko_signature_scan((const uint8_t *)src, strlen(src), LEUKO_FEATURE_ALL);
+    if (found != (LEUKO_FEATURE_INDENTED_LINE | LEUKO_FEATURE_HEREDOC | LEUKO_FEATURE_RESCUE))
+        return 1;
+
+    /* only the wanted features are reported */
+    if (leuko_signature_scan((const uint8_t *)src, strlen(src), LEUKO_FEATURE_TAB | LEUKO_FEATURE_RESCUE) != LEUKO_FEATURE_RESCUE)
+        return 2;
+
+    /* a shift is not a heredoc; trailing space at the end of the file counts */
+    const char *shift = "a << b\nc ";
+    if (leuko_signature_scan((const uint8_t *)shift, strlen(shift), LEUKO_FEATURE_ALL) != LEUKO_FEATURE_TRAILING_SPACE)
+        return 3;
+    if (leuko_signature_scan(NULL, 0, LEUKO_FEATURE_ALL) != 0)
+        return 4;
+
+    /* random sources over a small alphabet agree with the reference at every length */
+    static const char alphabet[] = " \t\r\n<<~Ax";
+    uint8_t buf[200];
+    srand(1);
+    for (int round = 0; round < 20000; ++round)
+    {
+        size_t len = (size_t)(rand() % (int)sizeof(buf));
+        for (size_t i = 0; i < len; ++i)
+            buf[i] = (uint8_t)alphabet[rand() % (int)(sizeof(alphabet) - 1)];
+        if (leuko_signature_scan(buf, len, LEUKO_FEATURE_ALL) != reference_scan(buf, len))
+            return 5;
+    }
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "engine/trace.h"
+#include "utils/file.h"
+
+int main(void)
+{
+    leuko_trace_t trace;
+    if (!leuko_trace_init(&trace, 2))
+        return 1;
+
+    /* worker 1 overflows its ring: only the latest events are kept */
+    uint64_t start = leuko_trace_begin(&trace.rings[0]);
+    leuko_trace_end(&trace.rings[0], "lint", "a \"quoted\".rb", start);
+    for (uint64_t i = 0; i < LEUKO_TRACE_RING_EVENTS + 3; ++i)
+    {
+        start = leuko_trace_begin(&trace.rings[1]);
+        leuko_trace_end(&trace.rings[1], i < 3 ? "old" : "new", NULL, start);
+    }
+
+    /* disabled tracing records nothing */
+    if (leuko_trace_begin(NULL) != 0)
+        return 2;
+    leuko_trace_end(NULL, "lint", NULL, 0);
+
+    char path[] = "/tmp/leuko_test_trace_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+        return 3;
+    close(fd);
+    if (!leuko_trace_write(&trace, path))
+        return 4;
+    leuko_trace_free(&trace);
+
+    uint8_t *json = NULL;
+    size_t len = 0;
+    if (!leuko_file_read_all(path, &json, &len))
+        return 5;
+    unlink(path);
+    char *text = malloc(len + 1);
+    memcpy(text, json, len);
+    text[len] = '\0';
+    free(json);
+
+    int rc = 0;
+    if (strncmp(text, "{\"traceEvents\":[", 16) != 0)
+        rc = 6;
+    else if (!strstr(text, "\"args\":{\"file\":\"a \\\"quoted\\\".rb\"}"))
+        rc = 7;
+    else if (strstr(text, "\"old\""))
+        rc = 8;
+    else if (!strstr(text, "\"otherData\":{\"dropped_events\":3}"))
+        rc = 9;
+    else if (!strstr(text, "\"tid\":1,\"args\":{\"name\":\"worker 1\"}"))
+        rc = 10;
+    free(text);
+    return rc;
+}
@@ -0,0 +1,78 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "engine/engine.h"
+
+/**
+ * @brief What the result callback saw.
+ */
+typedef struct seen_s
+{
+    int rc;
+    bool called;
+} seen_t;
+
+static void on_result(const leuko_lint_result_t *result, void *data)
+{
+    seen_t *seen = data;
+    seen->called = true;
+    const leuko_diagnostic_buffer_t *d = result->diagnostics;
+    leuko_processed_source_t *ps = result->ps;
+
+    /* the blanks before each CR go, the CRs and the data after __END__ stay */
+    const char *corrected = "x = 1\r\ny = 2\r\nz = 3\r\n__END__\r\ndata  \r\n";
+    if ((size_t)(ps->source_end - ps->source_start) != strlen(corrected) || memcmp(ps->source_start, corrected, strlen(corrected)) != 0)
+    {
+        seen->rc = 2;
+        return;
+    }
+    if (d->count != 2)
+    {
+        seen->rc = 3;
+        return;
+    }
+    /* corrected offenses sit right before the CR of lines 1 and 3 */
+    const int32_t lines[] = {1, 3};
+    for (size_t i = 0; i < d->count; ++i)
+    {
+        int32_t line = leuko_processed_source_line_of_pos(ps, leuko_offset_to_pos(ps, d->begin_offsets[i]));
+        if (d->rule_ids[i] != LEUKO_RULE_ID_TRAILING_WHITESPACE || line != lines[i] || ps->source_start[d->end_offsets[i]] != '\r' ||
+            !(d->flags[i] & LEUKO_DIAGNOSTIC_FLAG_CORRECTED))
+        {
+            seen->rc = 4;
+            return;
+        }
+    }
+}
+
+int main(void)
+{
+    char path[] = "/tmp/leuko_trailing_whitespaceXXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+        return 1;
+    /* CRLF line breaks */
+    const char *source = "x = 1   \r\ny = 2\r\nz = 3\t\r\n__END__\r\ndata  \r\n";
+    if (write(fd, source, strlen(source)) != (ssize_t)strlen(source))
+        return 1;
+    close(fd);
+
+    leuko_engine_options_t opts = {
+        .cancel = NULL,
+        .stop_on_diagnostic = false,
+        .fail_level = LEUKO_SEVERITY_REFACTOR,
+        .fix_mode = LEUKO_FIX_MODE_SAFE,
+        .enabled = NULL,
+    };
+    leuko_lint_job_t job = {.path = path, .file_index = 0, .worker_index = 0, .write_back = NULL, .lines = NULL};
+    leuko_diagnostic_buffer_t diagnostics;
+    leuko_diagnostic_buffer_init(&diagnostics);
+    seen_t seen = {.rc = 0, .called = false};
+    if (!leuko_engine_lint_file(&job, &opts, &diagnostics, on_result, &seen) || !seen.called)
+        seen.rc = 5;
+
+    leuko_diagnostic_buffer_free(&diagnostics);
+    unlink(path);
+    return seen.rc;
+}
@@ -0,0 +1,115 @@
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include "engine/write_back.h"
+#include "utils/file.h"
+
+#define SYNCED_COUNT (LEUKO_WRITE_BACK_BATCH * 2 + 5)
+
+static const uint8_t original[] = "x = 1 \n";
+static const uint8_t corrected[] = "x = 1\n";
+
+static bool has_contents(const char *path, const uint8_t *data, size_t len)
+{
+    uint8_t *read = NULL;
+    size_t read_len = 0;
+    bool ok = leuko_file_read_all(path, &read, &read_len) && read_len == len && memcmp(read, data, len) == 0;
+    free(read);
+    return ok;
+}
+
+static size_t count_entries(const char *dir)
+{
+    DIR *d = opendir(dir);
+    size_t n = 0;
+    for (struct dirent *e; d && (e = readdir(d));)
+        n += e->d_name[0] != '.';
+    if (d)
+        closedir(d);
+    return n;
+}
+
+int main(void)
+{
+    char dir[] = "/tmp/leuko_write_backXXXXXX";
+    if (!mkdtemp(dir))
+        return 1;
+    char path[256];
+    char link[256];
+    snprintf(path, sizeof(path), "%s/a.rb", dir);
+    snprintf(link, sizeof(link), "%s/link.rb", dir);
+    FILE *f = fopen(path, "w");
+    if (!f)
+        return 2;
+    fputs((const char *)original, f);
+    fclose(f);
+    chmod(path, 0640);
+    struct timeval old[2] = {{.tv_sec = 1000000000}, {.tv_sec = 1000000000}};
+    utimes(path, old);
+
+    int rc = 0;
+    leuko_write_back_t wb;
+    leuko_write_back_init(&wb, false);
+    struct stat st;
+
+    /* unchanged bytes leave the file alone, mtime included */
+    if (!leuko_write_back_file(&wb, path, original, sizeof(original) - 1, original, sizeof(original) - 1) || stat(path, &st) != 0 ||
+        st.st_mtime != old[1].tv_sec || wb.written != 0)
+        rc = 3;
+
+    /* changed bytes replace the file with its permission bits */
+    if (!rc && (!leuko_write_back_file(&wb, path, original, sizeof(original) - 1, corrected, sizeof(corrected) - 1) || stat(path, &st) != 0 ||
+                (st.st_mode & 07777) != 0640 || !has_contents(path, corrected, sizeof(corrected) - 1) || wb.written != 1))
+        rc = 4;
+
+    /* a symbolic link is followed: the target changes, the link stays */
+    if (!rc && (symlink("a.rb", link) != 0 ||
+                !leuko_write_back_file(&wb, link, corrected, sizeof(corrected) - 1, original, sizeof(original) - 1) || lstat(link, &st) != 0 ||
+                !S_ISLNK(st.st_mode) || !has_contents(path, original, sizeof(original) - 1)))
+        rc = 5;
+
+    /* a file that cannot be written is reported and counted */
+    char missing[256];
+    snprintf(missing, sizeof(missing), "%s/missing/b.rb", dir);
+    if (!rc && (leuko_write_back_file(&wb, missing, original, sizeof(original) - 1, corrected, sizeof(corrected) - 1) || wb.failed != 1))
+        rc = 6;
+    unlink(link);
+    unlink(path);
+
+    /* synced batches: every file is in place after the last flush, no temporary file is left */
+    char *paths[SYNCED_COUNT];
+    leuko_write_back_init(&wb, true);
+    for (size_t i = 0; i < SYNCED_COUNT; ++i)
+    {
+        paths[i] = malloc(256);
+        snprintf(paths[i], 256, "%s/s%zu.rb", dir, i);
+        if (!leuko_file_write_atomic(paths[i], original, sizeof(original) - 1, 0644))
+            rc = rc ? rc : 7;
+    }
+    for (size_t i = 0; i < SYNCED_COUNT && !rc; ++i)
+    {
+        if (!leuko_write_back_file(&wb, paths[i], original, sizeof(original) - 1, corrected, sizeof(corrected) - 1))
+            rc = 8;
+    }
+    if (!rc && (!leuko_write_back_flush(&wb) || wb.count != 0 || wb.written != SYNCED_COUNT || wb.failed != 0))
+        rc = 9;
+    for (size_t i = 0; i < SYNCED_COUNT && !rc; ++i)
+    {
+        if (!has_contents(paths[i], corrected, sizeof(corrected) - 1))
+            rc = 10;
+    }
+    if (!rc && count_entries(dir) != SYNCED_COUNT)
+        rc = 11;
+
+    for (size_t i = 0; i < SYNCED_COUNT; ++i)
+    {
+        unlink(paths[i]);
+        free(paths[i]);
+    }
+    rmdir(dir);
+    return rc;
+}
@@ -0,0 +1,46 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "utils/allocator/prism_xallocator.h"
+
+int main(void)
+{
+    leuko_x_allocator_begin();
+    void *small = xmalloc(100);
+    void *zeroed = xcalloc(4, 25);
+    void *large = xmalloc(100000);
+    if (!small || !zeroed || !large)
+        return 1;
+    /* a reallocation of an arena block stays in the arena, a large block does not */
+    small = xrealloc(small, 200);
+    large = xrealloc(large, 200000);
+    xfree(small);
+    xfree(zeroed);
+    xfree(large);
+
+    leuko_x_allocator_stats_t stats;
+    leuko_x_allocator_stats(&stats);
+    if (stats.arena_allocs != 3 || stats.arena_bytes < 400)
+    {
+        fprintf(stderr, "arena: %zu allocs, %zu bytes\n", stats.arena_allocs, stats.arena_bytes);
+        return 2;
+    }
+    if (stats.fallback_allocs != 2 || stats.fallback_bytes != 300000)
+    {
+        fprintf(stderr, "fallback: %zu allocs, %zu bytes\n", stats.fallback_allocs, stats.fallback_bytes);
+        return 3;
+    }
+    leuko_x_allocator_end();
+
+    /* counters survive end and are reset by begin */
+    leuko_x_allocator_stats(&stats);
+    if (stats.arena_allocs != 3)
+        return 4;
+    leuko_x_allocator_begin();
+    leuko_x_allocator_stats(&stats);
+    if (stats.arena_allocs != 0 || stats.fallback_allocs != 0)
+        return 5;
+    leuko_x_allocator_end();
+
+    printf("ok\n");
+    return 0;
+}
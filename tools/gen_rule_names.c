@@ -0,0 +1,252 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/registry.h"
+#include "common/rule_set.h"
+
+/*
+ * Generates the perfect hash behind leuko_rule_set_add_name: every spelling
+ * of a rule (`Layout/IndentationConsistency`, `IndentationConsistency`,
+ * `indentation_consistency`) and of a category (`Layout`, `layout`) maps to
+ * one slot, found with two hashes and one string compare.
+ *
+ * The table is built with hash-and-displace: keys are grouped into buckets
+ * by a first hash, and each bucket, largest first, gets the smallest seed
+ * that sends all its keys to free slots.
+ */
+
+#define BUCKETS 128
+#define SLOTS 512
+#define MAX_KEYS (LEUKO_RULE_ID_COUNT * 3 + 8)
+#define MAX_KEY_LEN 128
+
+static const char *const categories[] = {LEUKO_RULE_CATEGORY_NAME_LAYOUT, LEUKO_RULE_CATEGORY_NAME_LINT};
+#define CATEGORY_COUNT (sizeof(categories) / sizeof(categories[0]))
+
+typedef struct
+{
+    char name[MAX_KEY_LEN];
+    unsigned value; /* rule id, or LEUKO_RULE_ID_COUNT + category index */
+    unsigned bucket;
+} name_key_t;
+
+static name_key_t keys[MAX_KEYS];
+static size_t key_count;
+
+/* Must match leuko_rule_names_hash in the generated source */
+static uint32_t hash(const char *s, size_t len, uint32_t seed)
+{
+    uint32_t h = (2166136261u ^ seed) * 16777619u;
+    for (size_t i = 0; i < len; ++i)
+    {
+        h = (h ^ (uint8_t)s[i]) * 16777619u;
+    }
+    return h ^ (h >> 15);
+}
+
+static int add_key(const char *name, unsigned value)
+{
+    for (size_t i = 0; i < key_count; ++i)
+    {
+        if (strcmp(keys[i].name, name) == 0)
+        {
+            if (keys[i].value == value)
+                return 0;
+            fprintf(stderr, "gen_rule_names: `%s` names two different rules\n", name);
+            return 1;
+        }
+    }
+    if (key_count == MAX_KEYS || strlen(name) >= MAX_KEY_LEN)
+    {
+        fprintf(stderr, "gen_rule_names: too many or too long names\n");
+        return 1;
+    }
+    snprintf(keys[key_count].name, MAX_KEY_LEN, "%s", name);
+    keys[key_count].value = value;
+    keys[key_count].bucket = hash(name, strlen(name), 0) % BUCKETS;
+    key_count++;
+    return 0;
+}
+
+/* CamelCase to snake_case (`EndOfLine` -> `end_of_line`) */
+static void snake_case(const char *name, char *out, size_t out_size)
+{
+    size_t n = 0;
+    for (size_t i = 0; name[i] && n + 2 < out_size; ++i)
+    {
+        if (isupper((unsigned char)name[i]) && i > 0)
+            out[n++] = '_';
+        out[n++] = (char)tolower((unsigned char)name[i]);
+    }
+    out[n] = '\0';
+}
+
+static size_t bucket_sizes[BUCKETS];
+
+/* Larger buckets first, then by index (keeps the output stable) */
+static int compare_buckets(const void *a, const void *b)
+{
+    unsigned x = *(const unsigned *)a;
+    unsigned y = *(const unsigned *)b;
+    if (bucket_sizes[x] != bucket_sizes[y])
+        return bucket_sizes[x] < bucket_sizes[y] ? 1 : -1;
+    return x < y ? -1 : x > y;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <output.c>\n", argv[0]);
+        return 2;
+    }
+
+    char buf[MAX_KEY_LEN];
+    for (unsigned id = 0; id < LEUKO_RULE_ID_COUNT; ++id)
+    {
+        const leuko_rule_info_t *info = leuko_rule_info((leuko_rule_id_t)id);
+        snprintf(buf, sizeof(buf), "%s/%s", info->category, info->name);
+        int rc = add_key(buf, id);
+        rc |= add_key(info->name, id);
+        snake_case(info->name, buf, sizeof(buf));
+        rc |= add_key(buf, id);
+        if (rc)
+            return 1;
+    }
+    for (unsigned c = 0; c < CATEGORY_COUNT; ++c)
+    {
+        snake_case(categories[c], buf, sizeof(buf));
+        if (add_key(categories[c], LEUKO_RULE_ID_COUNT + c) || add_key(buf, LEUKO_RULE_ID_COUNT + c))
+            return 1;
+    }
+
+    /* place buckets, largest first */
+    unsigned order[BUCKETS];
+    for (size_t i = 0; i < key_count; ++i)
+        bucket_sizes[keys[i].bucket]++;
+    for (unsigned b = 0; b < BUCKETS; ++b)
+        order[b] = b;
+    qsort(order, BUCKETS, sizeof(order[0]), compare_buckets);
+
+    int slot_key[SLOTS];
+    unsigned seeds[BUCKETS] = {0};
+    for (size_t s = 0; s < SLOTS; ++s)
+        slot_key[s] = -1;
+    for (unsigned o = 0; o < BUCKETS && bucket_sizes[order[o]] > 0; ++o)
+    {
+        unsigned b = order[o];
+        unsigned seed = 1;
+        for (; seed < 65536; ++seed)
+        {
+            unsigned taken[MAX_KEYS];
+            size_t placed = 0;
+            int ok = 1;
+            for (size_t i = 0; i < key_count && ok; ++i)
+            {
+                if (keys[i].bucket != b)
+                    continue;
+                unsigned s = hash(keys[i].name, strlen(keys[i].name), seed) % SLOTS;
+                ok = slot_key[s] < 0;
+                for (size_t t = 0; t < placed && ok; ++t)
+                    ok = taken[t] != s;
+                taken[placed++] = s;
+            }
+            if (ok)
+                break;
+        }
+        if (seed == 65536)
+        {
+            fprintf(stderr, "gen_rule_names: no seed places bucket %u\n", b);
+            return 1;
+        }
+        seeds[b] = seed;
+        for (size_t i = 0; i < key_count; ++i)
+        {
+            if (keys[i].bucket == b)
+                slot_key[hash(keys[i].name, strlen(keys[i].name), seed) % SLOTS] = (int)i;
+        }
+    }
+
+    FILE *out = fopen(argv[1], "w");
+    if (!out)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    fprintf(out, "/* generated by gen_rule_names.c - do not edit */\n");
+    fprintf(out, "#include <string.h>\n#include \"common/rule_set.h\"\n\n");
+    fprintf(out, "#define LEUKO_RULE_NAMES_BUCKETS %d\n#define LEUKO_RULE_NAMES_SLOTS %d\n\n", BUCKETS, SLOTS);
+    fprintf(out, "static const uint16_t leuko_rule_names_seeds[LEUKO_RULE_NAMES_BUCKETS] = {");
+    for (unsigned b = 0; b < BUCKETS; ++b)
+        fprintf(out, "%s%u,", b % 16 ? " " : "\n    ", seeds[b]);
+    fprintf(out, "\n};\n\n");
+    fprintf(out, "static const struct\n{\n    const char *name;\n    uint16_t len;\n    uint16_t value;\n} leuko_rule_names_slots[LEUKO_RULE_NAMES_SLOTS] = {\n");
+    for (size_t s = 0; s < SLOTS; ++s)
+    {
+        if (slot_key[s] >= 0)
+        {
+            const name_key_t *k = &keys[slot_key[s]];
+            fprintf(out, "    [%zu] = {\"%s\", %zu, %u},\n", s, k->name, strlen(k->name), k->value);
+        }
+    }
+    fprintf(out, "};\n\n");
+    fprintf(out, "static const leuko_rule_set_t leuko_rule_names_categories[%zu] = {\n", CATEGORY_COUNT);
+    for (unsigned c = 0; c < CATEGORY_COUNT; ++c)
+    {
+        leuko_rule_set_t set = {{0}};
+        for (unsigned id = 0; id < LEUKO_RULE_ID_COUNT; ++id)
+        {
+            if (strcmp(leuko_rule_info((leuko_rule_id_t)id)->category, categories[c]) == 0)
+                leuko_rule_set_add(&set, (leuko_rule_id_t)id);
+        }
+        fprintf(out, "    {{");
+        for (size_t w = 0; w < LEUKO_RULE_SET_WORDS; ++w)
+            fprintf(out, "%s0x%016llxull", w ? ", " : "", (unsigned long long)set.words[w]);
+        fprintf(out, "}}, /* %s */\n", categories[c]);
+    }
+    fprintf(out, "};\n\n");
+    fprintf(out, "static uint32_t leuko_rule_names_hash(const char *s, size_t len, uint32_t seed)\n"
+                 "{\n"
+                 "    uint32_t h = (2166136261u ^ seed) * 16777619u;\n"
+                 "    for (size_t i = 0; i < len; ++i)\n"
+                 "    {\n"
+                 "        h = (h ^ (uint8_t)s[i]) * 16777619u;\n"
+                 "    }\n"
+                 "    return h ^ (h >> 15);\n"
+                 "}\n\n");
+    fprintf(out, "/**\n"
+                 " * @brief Add the rules named by a rule or category name to a set.\n"
+                 " * @param set Rule set\n"
+                 " * @param name `Category/Name`, `Name`, `snake_name`, `Category` or `category`\n"
+                 " * @param len Length of the name\n"
+                 " * @return false if the name is unknown (the set is unchanged)\n"
+                 " */\n"
+                 "bool leuko_rule_set_add_name(leuko_rule_set_t *set, const char *name, size_t len)\n"
+                 "{\n"
+                 "    uint32_t seed = leuko_rule_names_seeds[leuko_rule_names_hash(name, len, 0) %% LEUKO_RULE_NAMES_BUCKETS];\n"
+                 "    uint32_t slot = leuko_rule_names_hash(name, len, seed) %% LEUKO_RULE_NAMES_SLOTS;\n"
+                 "    const char *key = leuko_rule_names_slots[slot].name;\n"
+                 "    uint16_t value = leuko_rule_names_slots[slot].value;\n"
+                 "    if (!key || leuko_rule_names_slots[slot].len != len || memcmp(key, name, len) != 0)\n"
+                 "    {\n"
+                 "        return false;\n"
+                 "    }\n"
+                 "    if (value < LEUKO_RULE_ID_COUNT)\n"
+                 "    {\n"
+                 "        leuko_rule_set_add(set, value);\n"
+                 "    }\n"
+                 "    else\n"
+                 "    {\n"
+                 "        leuko_rule_set_union(set, &leuko_rule_names_categories[value - LEUKO_RULE_ID_COUNT]);\n"
+                 "    }\n"
+                 "    return true;\n"
+                 "}\n");
+    if (fclose(out) != 0)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    return 0;
+}